@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+
+//Convert a dbgen .tbl file into column files, replacing the
+//lineitemWT.sql + lineitem.pl + zeke_count_*.py pipeline:
+//
+//  load_tbl lineitem.tbl out_dir                 (the lineitem columns below)
+//  load_tbl part.tbl out_dir p_brand:3:string p_size:5:int ...
+//
+//A field is name:index:type[:scale], type in int, decimal, date and string.
+
+#include    <cstdlib>
+#include    <iostream>
+#include    <sstream>
+#include    <string>
+#include    <vector>
+#include    <sys/time.h>
+
+#include "src/tbl_loader.h"
+
+using namespace byteslice;
+
+static const std::vector<TblField> kLineitemFields = {
+    {"l_orderkey",      0,  FieldType::kInteger, 0},
+    {"l_partkey",       1,  FieldType::kInteger, 0},
+    {"l_suppkey",       2,  FieldType::kInteger, 0},
+    {"l_quantity",      4,  FieldType::kDecimal, 2},
+    {"l_extendedprice", 5,  FieldType::kDecimal, 2},
+    {"l_discount",      6,  FieldType::kDecimal, 2},
+    {"l_tax",           7,  FieldType::kDecimal, 2},
+    {"l_returnflag",    8,  FieldType::kString,  0},
+    {"l_linestatus",    9,  FieldType::kString,  0},
+    {"l_shipdate",      10, FieldType::kDate,    0},
+    {"l_commitdate",    11, FieldType::kDate,    0},
+    {"l_receiptdate",   12, FieldType::kDate,    0},
+    {"l_shipmode",      14, FieldType::kString,  0}
+};
+
+static TblField ParseField(const std::string &spec){
+    std::vector<std::string> parts;
+    std::stringstream ss(spec);
+    std::string part;
+    while(std::getline(ss, part, ':')){
+        parts.push_back(part);
+    }
+    if(parts.size() < 3){
+        std::cerr << "[FATAL] Incorrect field: " << spec << std::endl;
+        exit(1);
+    }
+    TblField field = {parts[0], std::stoul(parts[1]), FieldType::kInteger, 0};
+    if("decimal" == parts[2]){
+        field.type = FieldType::kDecimal;
+        field.scale = (parts.size() > 3) ? std::stoul(parts[3]) : 2;
+    }
+    else if("date" == parts[2]){
+        field.type = FieldType::kDate;
+    }
+    else if("string" == parts[2]){
+        field.type = FieldType::kString;
+    }
+    else if("int" != parts[2]){
+        std::cerr << "[FATAL] Incorrect field type: " << spec << std::endl;
+        exit(1);
+    }
+    return field;
+}
+
+static double Now(){
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        std::cerr << "Usage: " << argv[0] << " <file.tbl> <out_dir> [name:index:type[:scale]]..."
+            << std::endl;
+        return 1;
+    }
+    std::vector<TblField> fields = kLineitemFields;
+    if(argc > 3){
+        fields.clear();
+        for(int i = 3; i < argc; i++){
+            fields.push_back(ParseField(argv[i]));
+        }
+    }
+
+    TblLoader loader(fields);
+    double start = Now();
+    size_t num = loader.Load(argv[1]);
+    double loaded = Now();
+    loader.Write(argv[2]);
+    double written = Now();
+    std::cout << num << " tuples, " << fields.size() << " columns: load "
+        << (loaded - start) << " s, write " << (written - loaded) << " s" << std::endl;
+    return 0;
+}
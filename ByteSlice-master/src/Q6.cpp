@@ -27,6 +27,7 @@
 #include   "byteslice_column_block.h"
 #include   "bitvector_block.h"
 #include   "types.h"
+#include   "encoder.h"
 
 //#include "rand.h"
 //#include "rdtsc.h"
@@ -41,6 +42,19 @@
 
 
 namespace byteslice {
+
+//code compared with literal, for the verification of the translated predicates
+static inline bool Compare(Comparator comparator, WordUnit code, WordUnit literal){
+    switch(comparator){
+        case Comparator::kEqual:        return code == literal;
+        case Comparator::kInequal:      return code != literal;
+        case Comparator::kLess:         return code <  literal;
+        case Comparator::kLessEqual:    return code <= literal;
+        case Comparator::kGreater:      return code >  literal;
+        case Comparator::kGreaterEqual: return code >= literal;
+    }
+    return false;
+}
 	
 
 struct Monitor_Event inst_Monitor_Event = {
@@ -276,8 +290,12 @@ void *run(void *arg)
 	{
         uint32_t literal_1   = 1488; //1994-1-1  
 	    uint32_t literal_2   = 1860; //1995-1-1
-        uint32_t literal_3   = 5;    //discount:0.05
-        uint32_t literal_4   = 7;    //discount:0.07
+        //l_discount is a decimal(2) in [0.00, 1.00]
+        Encoder discount = Encoder::Decimal(2, 0.0, 1.0);
+        Comparator comparator_3, comparator_4;
+        WordUnit literal_3, literal_4;
+        discount.TranslateReal(Comparator::kGreaterEqual, 0.05, &comparator_3, &literal_3);
+        discount.TranslateReal(Comparator::kLessEqual,    0.07, &comparator_4, &literal_4);
         uint32_t literal_5   = 24;    //quatity:24
 
 
@@ -318,7 +336,7 @@ void *run(void *arg)
 			printf("l_discount ERROR::::::::tmp_f = %f\n", tmp_f); 
         	break;
 		 }
-		 tmp = (uint32_t) (tmp_f*100.0);
+		 tmp = discount.EncodeReal(tmp_f);
          original_1[i]       = tmp; //tmp_cons; //
          block2_1->SetTuple(i, tmp);		  
 	     i++;
@@ -366,8 +384,8 @@ void *run(void *arg)
            block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kSet);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
 		   
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);
          }
 		 else if (execution_model == 1)
@@ -377,13 +395,13 @@ void *run(void *arg)
 
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);			 
 		   
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		 }
 		 else if (execution_model == 2)
 		 {
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kSet);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kSet);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		   
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
@@ -392,8 +410,8 @@ void *run(void *arg)
 		 }	
 		 else if (execution_model == 3)
 		 {
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kSet);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kSet);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);			 
 		   
@@ -404,8 +422,8 @@ void *run(void *arg)
 		 {
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kSet);			 
 
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		   
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
@@ -418,16 +436,16 @@ void *run(void *arg)
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
 
-	       block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+	       block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		 }			 
 		 else if (execution_model == 6)
 		 {		
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kSet);
            block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);
          }
 		 else if (execution_model == 7)
@@ -437,13 +455,13 @@ void *run(void *arg)
 
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);			 
 		   
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
 		 }
 		 else if (execution_model == 8)
 		 {
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kSet);
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kSet);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
 		   
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
@@ -452,8 +470,8 @@ void *run(void *arg)
 		 }	
 		 else if (execution_model == 9)
 		 {
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kSet);
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kSet);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
 
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kAnd);			 
 		   
@@ -464,8 +482,8 @@ void *run(void *arg)
 		 {
 		   block2_2->Scan(Comparator::kLess,        literal_5, bvblock, Bitwise::kSet);			 
 
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
 		   
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
@@ -478,8 +496,30 @@ void *run(void *arg)
 		   block2->Scan(Comparator::kLess,          literal_2, bvblock, Bitwise::kAnd);
 	       block2->Scan(Comparator::kGreaterEqual,  literal_1, bvblock, Bitwise::kAnd);
 
-	       block2_1->Scan(Comparator::kGreaterEqual,literal_3, bvblock, Bitwise::kAnd);
- 		   block2_1->Scan(Comparator::kLessEqual,   literal_4, bvblock, Bitwise::kAnd);
+	       block2_1->Scan(comparator_3,             literal_3, bvblock, Bitwise::kAnd);
+ 		   block2_1->Scan(comparator_4,             literal_4, bvblock, Bitwise::kAnd);
+		 }
+		 else if (execution_model == 12) //all the five predicates in one pass.
+		 {
+		   BlockPredicate predicates[5] = {
+		       {block2,   Comparator::kGreaterEqual, literal_1},
+		       {block2,   Comparator::kLess,         literal_2},
+		       {block2_1, comparator_3,              literal_3},
+		       {block2_1, comparator_4,              literal_4},
+		       {block2_2, Comparator::kLess,         literal_5}
+		   };
+		   ColumnBlock::ScanConjunction(predicates, 5, bvblock, Bitwise::kSet);
+		 }
+		 else if (execution_model == 13) //the five predicates ordered by sampled selectivity.
+		 {
+		   BlockPredicate predicates[5] = {
+		       {block2,   Comparator::kGreaterEqual, literal_1},
+		       {block2,   Comparator::kLess,         literal_2},
+		       {block2_1, comparator_3,              literal_3},
+		       {block2_1, comparator_4,              literal_4},
+		       {block2_2, Comparator::kLess,         literal_5}
+		   };
+		   ColumnBlock::ScanOrdered(predicates, 5, bvblock, Bitwise::kSet);
 		 }					 
 		pthread_barrier_wait(barrier++);
 		t3 = thread_time() - t3;
@@ -509,7 +549,7 @@ void *run(void *arg)
 		{
 			//size_t ii = 11;
 			bool real  = ( (original[ii]   >= literal_1)&& (original[ii]   <  literal_2)&&
-			               (original_1[ii] >= literal_3)&& (original_1[ii] <= literal_4)&&
+			               Compare(comparator_3, original_1[ii], literal_3)&& Compare(comparator_4, original_1[ii], literal_4)&&
 						   (original_2[ii] <  literal_5) ); 
 	
 			bool eval  = bvblock->GetBit(ii);
@@ -139,6 +139,96 @@ inline bool avx_iszero(const __m128i &a){
     return _mm_testz_si128(a, a);
 }
 
+// Shift every byte of a by count (0..7) bits
+inline __m128i avx_slli_bytes(const __m128i &a, int count){
+    return _mm_and_si128(_mm_sll_epi16(a, _mm_cvtsi32_si128(count)),
+            _mm_set1_epi8(static_cast<char>(0xff << count)));
+}
+inline __m128i avx_srli_bytes(const __m128i &a, int count){
+    return _mm_and_si128(_mm_srl_epi16(a, _mm_cvtsi32_si128(count)),
+            _mm_set1_epi8(static_cast<char>(0xff >> count)));
+}
+
+// Test every byte of a against a 256-bit bitmap of byte values.
+// row_lo[n] holds bit h for value (h << 4 | n) with h < 8, row_hi[n] for h >= 8.
+inline __m128i avx_lookup_bitmap(const __m128i &a, const __m128i &row_lo, const __m128i &row_hi){
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i lo = _mm_and_si128(a, nibble);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(a, 4), nibble);
+    __m128i row = _mm_blendv_epi8(_mm_shuffle_epi8(row_lo, lo),
+                                  _mm_shuffle_epi8(row_hi, lo),
+                                  _mm_cmpgt_epi8(hi, _mm_set1_epi8(7)));
+    __m128i bit = _mm_shuffle_epi8(bits, hi);
+    return _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+}
+
+// Aligned store
+inline void avx_store(void *mem_info, const __m128i &a){
+    _mm_store_si128((__m128i*)mem_info, a);
+}
+
+// Transpose 16 codes (their low 32 bits, or high 32 bits if high is set,
+// after a left shift) into 4 byte slices: slices[0] holds the most significant
+// byte of every code, slices[3] the least significant one; bytes are flipped
+// as in the stored byte slices.
+inline void avx_transpose_codes(const uint64_t* codes, int shift, bool high, __m128i slices[4]){
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    //bytes 3,2,1,0 of the 4 dwords
+    const __m128i byte_order = _mm_setr_epi8(3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12);
+    __m128i c[4];
+    for(int m = 0; m < 4; m++){
+        //4 codes to 4 dwords
+        __m128i a = _mm_sll_epi64(_mm_loadu_si128((const __m128i*)(codes + 4*m)), count);
+        __m128i b = _mm_sll_epi64(_mm_loadu_si128((const __m128i*)(codes + 4*m + 2)), count);
+        a = _mm_shuffle_epi32(a, 0xd8);
+        b = _mm_shuffle_epi32(b, 0xd8);
+        __m128i dwords = high ? _mm_unpackhi_epi64(a, b) : _mm_unpacklo_epi64(a, b);
+        //dword j: byte (3-j) of the 4 codes
+        c[m] = _mm_shuffle_epi8(dwords, byte_order);
+    }
+    //4x4 transpose of dwords
+    __m128i t0 = _mm_unpacklo_epi32(c[0], c[1]);
+    __m128i t1 = _mm_unpackhi_epi32(c[0], c[1]);
+    __m128i t2 = _mm_unpacklo_epi32(c[2], c[3]);
+    __m128i t3 = _mm_unpackhi_epi32(c[2], c[3]);
+    const __m128i flip = _mm_set1_epi8(static_cast<char>(0x80));
+    slices[0] = _mm_xor_si128(_mm_unpacklo_epi64(t0, t2), flip);
+    slices[1] = _mm_xor_si128(_mm_unpackhi_epi64(t0, t2), flip);
+    slices[2] = _mm_xor_si128(_mm_unpacklo_epi64(t1, t3), flip);
+    slices[3] = _mm_xor_si128(_mm_unpackhi_epi64(t1, t3), flip);
+}
+
+// Gather the codes at 4 positions of num_slices byte slices, flipped back
+// and shifted right by shift. There is no gather below AVX2: one code at a time.
+inline void avx_gather_codes(const uint8_t* const* slices, size_t num_slices,
+                             const uint32_t* positions, int shift, uint64_t* codes){
+    const uint32_t flip = 0x80808080U >> (32 - 8*num_slices);
+    for(int i = 0; i < 4; i++){
+        uint32_t c = 0;
+        for(size_t byte_id = 0; byte_id < num_slices; byte_id++){
+            c = (c << 8) | slices[byte_id][positions[i]];
+        }
+        codes[i] = (c ^ flip) >> shift;
+    }
+}
 
+// Inverse of avx_transpose_codes: rebuild the 16 codes starting at pos of
+// num_slices byte slices, flipped back and shifted right by shift.
+inline void avx_untranspose_codes(const uint8_t* const* slices, size_t num_slices,
+                                  size_t pos, int shift, uint64_t* codes){
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    const __m128i flip = _mm_set1_epi32(0x80808080U >> (32 - 8*num_slices));
+    for(int m = 0; m < 4; m++){
+        __m128i c = _mm_setzero_si128();
+        for(size_t byte_id = 0; byte_id < num_slices; byte_id++){
+            __m128i b = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int*)(slices[byte_id] + pos + 4*m)));
+            c = _mm_or_si128(_mm_slli_epi32(c, 8), b);
+        }
+        c = _mm_srl_epi32(_mm_xor_si128(c, flip), count);
+        _mm_storeu_si128((__m128i*)(codes + 4*m), _mm_cvtepu32_epi64(c));
+        _mm_storeu_si128((__m128i*)(codes + 4*m + 2), _mm_cvtepu32_epi64(_mm_srli_si128(c, 8)));
+    }
+}
 
 #endif  //AVX_UTILITY_128_H
@@ -136,6 +136,111 @@ inline bool avx_iszero(const __m256i &a){
     return _mm256_testz_si256(a, a);
 }
 
+// Shift every byte of a by count (0..7) bits
+inline __m256i avx_slli_bytes(const __m256i &a, int count){
+    return _mm256_and_si256(_mm256_sll_epi16(a, _mm_cvtsi32_si128(count)),
+            _mm256_set1_epi8(static_cast<char>(0xff << count)));
+}
+inline __m256i avx_srli_bytes(const __m256i &a, int count){
+    return _mm256_and_si256(_mm256_srl_epi16(a, _mm_cvtsi32_si128(count)),
+            _mm256_set1_epi8(static_cast<char>(0xff >> count)));
+}
+
+// Test every byte of a against a 256-bit bitmap of byte values.
+// row_lo[n] holds bit h for value (h << 4 | n) with h < 8, row_hi[n] for h >= 8;
+// both 16-byte rows are repeated in the two 128-bit lanes.
+inline __m256i avx_lookup_bitmap(const __m256i &a, const __m256i &row_lo, const __m256i &row_hi){
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                          1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m256i lo = _mm256_and_si256(a, nibble);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(a, 4), nibble);
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(row_lo, lo),
+                                     _mm256_shuffle_epi8(row_hi, lo),
+                                     _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+    __m256i bit = _mm256_shuffle_epi8(bits, hi);
+    return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+// Aligned store
+inline void avx_store(void *mem_info, const __m256i &a){
+    _mm256_store_si256((__m256i*)mem_info, a);
+}
+
+// Transpose 32 codes (their low 32 bits, or high 32 bits if high is set,
+// after a left shift) into 4 byte slices: slices[0] holds the most significant
+// byte of every code, slices[3] the least significant one; bytes are flipped
+// as in the stored byte slices.
+inline void avx_transpose_codes(const uint64_t* codes, int shift, bool high, __m256i slices[4]){
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    //bytes 3,2,1,0 of the 4 dwords of each 128-bit lane
+    const __m256i byte_order = _mm256_setr_epi8(
+            3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12,
+            3, 7, 11, 15, 2, 6, 10, 14, 1, 5, 9, 13, 0, 4, 8, 12);
+    const __m256i even_odd = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i lane_order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i c[4];
+    for(int m = 0; m < 4; m++){
+        //8 codes to 8 dwords
+        __m256i a = _mm256_sll_epi64(_mm256_loadu_si256((const __m256i*)(codes + 8*m)), count);
+        __m256i b = _mm256_sll_epi64(_mm256_loadu_si256((const __m256i*)(codes + 8*m + 4)), count);
+        a = _mm256_permutevar8x32_epi32(a, even_odd);
+        b = _mm256_permutevar8x32_epi32(b, even_odd);
+        __m256i dwords = high ? _mm256_permute2x128_si256(a, b, 0x31)
+                              : _mm256_permute2x128_si256(a, b, 0x20);
+        //qword q: byte (3-q) of the 8 codes
+        c[m] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(dwords, byte_order), lane_order);
+    }
+    //4x4 transpose of qwords
+    __m256i t0 = _mm256_unpacklo_epi64(c[0], c[1]);
+    __m256i t1 = _mm256_unpackhi_epi64(c[0], c[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(c[2], c[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(c[2], c[3]);
+    const __m256i flip = _mm256_set1_epi8(static_cast<char>(0x80));
+    slices[0] = _mm256_xor_si256(_mm256_permute2x128_si256(t0, t2, 0x20), flip);
+    slices[1] = _mm256_xor_si256(_mm256_permute2x128_si256(t1, t3, 0x20), flip);
+    slices[2] = _mm256_xor_si256(_mm256_permute2x128_si256(t0, t2, 0x31), flip);
+    slices[3] = _mm256_xor_si256(_mm256_permute2x128_si256(t1, t3, 0x31), flip);
+}
+
+// Gather the codes at 8 positions (below 2^31) of num_slices byte slices,
+// flipped back and shifted right by shift. Every byte is read through the
+// aligned dword holding it, so nothing beyond the padded slices is touched.
+inline void avx_gather_codes(const uint8_t* const* slices, size_t num_slices,
+                             const uint32_t* positions, int shift, uint64_t* codes){
+    const __m256i pos = _mm256_loadu_si256((const __m256i*)positions);
+    const __m256i dword_id = _mm256_srli_epi32(pos, 2);
+    const __m256i bit_in_dword = _mm256_slli_epi32(_mm256_and_si256(pos, _mm256_set1_epi32(3)), 3);
+    const __m256i low_byte = _mm256_set1_epi32(0xff);
+    __m256i c = _mm256_setzero_si256();
+    for(size_t byte_id = 0; byte_id < num_slices; byte_id++){
+        __m256i b = _mm256_i32gather_epi32((const int*)slices[byte_id], dword_id, 4);
+        b = _mm256_and_si256(_mm256_srlv_epi32(b, bit_in_dword), low_byte);
+        c = _mm256_or_si256(_mm256_slli_epi32(c, 8), b);
+    }
+    c = _mm256_xor_si256(c, _mm256_set1_epi32(0x80808080U >> (32 - 8*num_slices)));
+    c = _mm256_srl_epi32(c, _mm_cvtsi32_si128(shift));
+    _mm256_storeu_si256((__m256i*)codes, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(c)));
+    _mm256_storeu_si256((__m256i*)(codes + 4), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(c, 1)));
+}
+
+// Inverse of avx_transpose_codes: rebuild the 32 codes starting at pos of
+// num_slices byte slices, flipped back and shifted right by shift.
+inline void avx_untranspose_codes(const uint8_t* const* slices, size_t num_slices,
+                                  size_t pos, int shift, uint64_t* codes){
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    const __m256i flip = _mm256_set1_epi32(0x80808080U >> (32 - 8*num_slices));
+    for(int m = 0; m < 4; m++){
+        __m256i c = _mm256_setzero_si256();
+        for(size_t byte_id = 0; byte_id < num_slices; byte_id++){
+            __m256i b = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(slices[byte_id] + pos + 8*m)));
+            c = _mm256_or_si256(_mm256_slli_epi32(c, 8), b);
+        }
+        c = _mm256_srl_epi32(_mm256_xor_si256(c, flip), count);
+        _mm256_storeu_si256((__m256i*)(codes + 8*m), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(c)));
+        _mm256_storeu_si256((__m256i*)(codes + 8*m + 4), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(c, 1)));
+    }
+}
 
 }   // namespace
 
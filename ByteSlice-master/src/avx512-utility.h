@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef AVX512_UTILITY_H
+#define AVX512_UTILITY_H
+
+#include    <cstdint>
+#include    <x86intrin.h>
+
+/* AVX-512BW: 64 bytes per vector, comparisons return one mask bit per byte.
+ * Built with a function target attribute, so the library keeps running on
+ * AVX2-only CPUs; callers are chosen at run time (see cpu_dispatch.h) */
+#define AVX512_TARGET __attribute__((target("avx512f,avx512bw")))
+
+namespace byteslice{
+
+typedef __m512i Avx512Unit;
+typedef __mmask64 Avx512Mask;
+
+AVX512_TARGET inline __m512i avx512_load(const void *mem_info){
+    return _mm512_loadu_si512(mem_info);
+}
+
+AVX512_TARGET inline __m512i avx512_set1_byte(uint8_t a){
+    return _mm512_set1_epi8(static_cast<int8_t>(a));
+}
+
+// Compare (signed) bytes, i.e., flipped byte slices
+AVX512_TARGET inline __mmask64 avx512_cmplt_byte(const __m512i &a, const __m512i &b){
+    return _mm512_cmplt_epi8_mask(a, b);
+}
+
+AVX512_TARGET inline __mmask64 avx512_cmpgt_byte(const __m512i &a, const __m512i &b){
+    return _mm512_cmpgt_epi8_mask(a, b);
+}
+
+AVX512_TARGET inline __mmask64 avx512_cmpeq_byte(const __m512i &a, const __m512i &b){
+    return _mm512_cmpeq_epi8_mask(a, b);
+}
+
+// Compare under a mask: bits not in k are zero
+AVX512_TARGET inline __mmask64 avx512_mask_cmplt_byte(__mmask64 k, const __m512i &a, const __m512i &b){
+    return _mm512_mask_cmplt_epi8_mask(k, a, b);
+}
+
+AVX512_TARGET inline __mmask64 avx512_mask_cmpgt_byte(__mmask64 k, const __m512i &a, const __m512i &b){
+    return _mm512_mask_cmpgt_epi8_mask(k, a, b);
+}
+
+AVX512_TARGET inline __mmask64 avx512_mask_cmpeq_byte(__mmask64 k, const __m512i &a, const __m512i &b){
+    return _mm512_mask_cmpeq_epi8_mask(k, a, b);
+}
+
+}   // namespace
+
+#endif  //AVX512_UTILITY_H
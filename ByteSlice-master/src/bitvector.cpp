@@ -39,18 +39,25 @@ BitVector::~BitVector(){
 void BitVector::And(const BitVector* bitvector){
     assert(num_ == bitvector->num_);
 
+    //morsels never cross a block
+    const size_t num_morsels = NumMorsels(num_);
 #   pragma omp parallel for schedule(dynamic)
-    for(size_t i=0; i < blocks_.size(); i++){
-        blocks_[i]->And(bitvector->GetBVBlock(i));
+    for(size_t morsel = 0; morsel < num_morsels; morsel++){
+        size_t block_id = morsel * kNumTuplesPerMorsel / kNumTuplesPerBlock;
+        size_t begin = morsel * kNumTuplesPerMorsel % kNumTuplesPerBlock;
+        blocks_[block_id]->And(bitvector->GetBVBlock(block_id), begin, begin + kNumTuplesPerMorsel);
     }
 }
 
 void BitVector::Or(const BitVector* bitvector){
     assert(num_ == bitvector->num_);
 
+    const size_t num_morsels = NumMorsels(num_);
 #   pragma omp parallel for schedule(dynamic)
-    for(size_t i=0; i < blocks_.size(); i++){
-        blocks_[i]->Or(bitvector->GetBVBlock(i));
+    for(size_t morsel = 0; morsel < num_morsels; morsel++){
+        size_t block_id = morsel * kNumTuplesPerMorsel / kNumTuplesPerBlock;
+        size_t begin = morsel * kNumTuplesPerMorsel % kNumTuplesPerBlock;
+        blocks_[block_id]->Or(bitvector->GetBVBlock(block_id), begin, begin + kNumTuplesPerMorsel);
     }
 }
 
@@ -71,9 +78,12 @@ void BitVector::SetZeros(){
 
 size_t BitVector::CountOnes() const{
     size_t count = 0;
+    const size_t num_morsels = NumMorsels(num_);
 #   pragma omp parallel for schedule(dynamic) reduction(+: count)
-    for(size_t i=0; i < blocks_.size(); i++){
-        count += blocks_[i]->CountOnes();
+    for(size_t morsel = 0; morsel < num_morsels; morsel++){
+        size_t begin = morsel * kNumTuplesPerMorsel % kNumTuplesPerBlock;
+        count += blocks_[morsel * kNumTuplesPerMorsel / kNumTuplesPerBlock]->CountOnes(
+                begin, begin + kNumTuplesPerMorsel);
     }
     return count;
 }
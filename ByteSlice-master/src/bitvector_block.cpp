@@ -59,34 +59,40 @@ void BitVectorBlock::SetZeros(){
     memset(data_, 0x0, sizeof(WordUnit)*num_word_units_);
 }
 
-size_t BitVectorBlock::CountOnes(){
+size_t BitVectorBlock::CountOnes(size_t begin, size_t end){
     size_t count = 0;
-    for(size_t i=0; i<num_word_units_; i++){
+    for(size_t i=begin/kNumWordBits, end_word=EndWord(end); i<end_word; i++){
         //count += _mm_popcnt_u64(data_[i]);
         count += POPCNT64(data_[i]);
     }
     return count;
 }
 
-void BitVectorBlock::And(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
+void BitVectorBlock::And(const BitVectorBlock* block, size_t begin, size_t end){
+    for(size_t i=begin/kNumWordBits, end_word=EndWord(end); i<end_word; i++){
         data_[i] &= block->GetWordUnit(i);
     }
-    ClearTail();
+    if(end >= num_){
+        ClearTail();
+    }
 }
 
-void BitVectorBlock::Or(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
+void BitVectorBlock::Or(const BitVectorBlock* block, size_t begin, size_t end){
+    for(size_t i=begin/kNumWordBits, end_word=EndWord(end); i<end_word; i++){
         data_[i] |= block->GetWordUnit(i);
     }
-    ClearTail();
+    if(end >= num_){
+        ClearTail();
+    }
 }
 
-void BitVectorBlock::Set(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
+void BitVectorBlock::Set(const BitVectorBlock* block, size_t begin, size_t end){
+    for(size_t i=begin/kNumWordBits, end_word=EndWord(end); i<end_word; i++){
         data_[i] = block->GetWordUnit(i);
     }
-    ClearTail();
+    if(end >= num_){
+        ClearTail();
+    }
 } 
 
 
@@ -36,11 +36,13 @@ public:
     ~BitVectorBlock();
     void SetOnes();
     void SetZeros();
-    size_t CountOnes();
     void ClearTail();
-    void And(const BitVectorBlock* block);
-    void Or(const BitVectorBlock* block);
-    void Set(const BitVectorBlock* block);
+    //on the words of the tuples [begin, end) only, the whole block by default
+    //(begin is a multiple of 64)
+    size_t CountOnes(size_t begin=0, size_t end=kNumTuplesPerBlock);
+    void And(const BitVectorBlock* block, size_t begin=0, size_t end=kNumTuplesPerBlock);
+    void Or(const BitVectorBlock* block, size_t begin=0, size_t end=kNumTuplesPerBlock);
+    void Set(const BitVectorBlock* block, size_t begin=0, size_t end=kNumTuplesPerBlock);
 
     //bit manipulation
     bool GetBit(size_t pos);
@@ -59,6 +61,10 @@ public:
 
 
 private:
+    //end of the words of a range ending at tuple end: the range that reaches
+    //the end of the block also takes the padding words
+    size_t EndWord(size_t end) const;
+
     WordUnit* data_ = NULL;
     size_t num_;
     size_t num_word_units_;
@@ -90,6 +96,10 @@ inline size_t BitVectorBlock::num_word_units() const{
     return num_word_units_;
 }
 
+inline size_t BitVectorBlock::EndWord(size_t end) const{
+    return (end >= num_) ? num_word_units_ : end / kNumWordBits;
+}
+
 
 }   // namespace
 
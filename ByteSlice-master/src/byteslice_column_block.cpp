@@ -8,13 +8,16 @@
  *******************************************************************************/
 #include "byteslice_column_block.h"
 
+#include    <algorithm>
 #include	<cassert>
 #include    <cstdlib>
 #include    <cstring>
+#include    <vector>
 
 //#define COUNTER_ENABLE
 
 #include "avx-utility.h"
+#include "cpu_dispatch.h"
 
 
 namespace byteslice{
@@ -24,6 +27,9 @@ namespace byteslice{
 #endif
 
 static constexpr size_t kPrefetchDistance = 512*2;
+//byte slices start on a page, so that the pages of a run of morsels
+//can be bound to a NUMA node (see Column::PlaceOnNumaNodes)
+static constexpr size_t kByteSliceAlignment = 4096;
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(size_t num):
@@ -38,7 +44,7 @@ ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(size_t num):
     //allocate memory space
     assert(num <= kNumTuplesPerBlock);
     for(size_t i=0; i < kNumBytesPerCode; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerByteSlice);                    
+        size_t ret = posix_memalign((void**)&data_[i], kByteSliceAlignment, kMemSizePerByteSlice);                    
         (void)ret;
       //  memset(data_[i], 0x0, kMemSizePerByteSlice);
     }
@@ -47,8 +53,10 @@ ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(size_t num):
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::~ByteSliceColumnBlock(){
-    for(size_t i=0; i < kNumBytesPerCode; i++){
-        free(data_[i]);
+    if(owns_data_){
+        for(size_t i=0; i < kNumBytesPerCode; i++){
+            free(data_[i]);
+        }
     }
 }
 
@@ -58,6 +66,36 @@ bool ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Resize(size_t num){
     return true;
 }
 
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetNumBuffers() const{
+    return kNumBytesPerCode;
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetBufferSize() const{
+    return kMemSizePerByteSlice;
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+const ByteUnit* ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetBuffer(size_t buffer_id) const{
+    assert(buffer_id < kNumBytesPerCode);
+    return data_[buffer_id];
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+                    AttachBuffers(ByteUnit* const* buffers, size_t num){
+    assert(num <= kNumTuplesPerBlock);
+    for(size_t i=0; i < kNumBytesPerCode; i++){
+        if(owns_data_){
+            free(data_[i]);
+        }
+        data_[i] = buffers[i];
+    }
+    owns_data_ = false;
+    num_tuples_ = num;
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     SerToFile(SequentialWriteBinaryFile &file) const{
@@ -80,42 +118,153 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
 //Scan against literal
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator,
-        WordUnit literal, BitVectorBlock* bvblock, Bitwise bit_opt) const{
+        WordUnit literal, BitVectorBlock* bvblock, Bitwise bit_opt,
+        size_t begin, size_t end) const{
     assert(bvblock->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
     switch(comparator){
         case Comparator::kLess:
-            return ScanHelper1<Comparator::kLess>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kLess>(literal, bvblock, bit_opt, begin, end);
         case Comparator::kGreater:
-            return ScanHelper1<Comparator::kGreater>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kGreater>(literal, bvblock, bit_opt, begin, end);
         case Comparator::kLessEqual:
-            return ScanHelper1<Comparator::kLessEqual>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kLessEqual>(literal, bvblock, bit_opt, begin, end);
         case Comparator::kGreaterEqual:
-            return ScanHelper1<Comparator::kGreaterEqual>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kGreaterEqual>(literal, bvblock, bit_opt, begin, end);
         case Comparator::kEqual:
-            return ScanHelper1<Comparator::kEqual>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kEqual>(literal, bvblock, bit_opt, begin, end);
         case Comparator::kInequal:
-            return ScanHelper1<Comparator::kInequal>(literal, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kInequal>(literal, bvblock, bit_opt, begin, end);
     }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper1(WordUnit literal,
-                                    BitVectorBlock* bvblock, Bitwise bit_opt) const{
+                                    BitVectorBlock* bvblock, Bitwise bit_opt,
+                                    size_t begin, size_t end) const{
+    if(SimdIsa::kAvx512 == GetSimdIsa()){
+        switch(bit_opt){
+            case Bitwise::kSet:
+                return ScanHelper512<CMP, Bitwise::kSet>(literal, bvblock, begin, end);
+            case Bitwise::kAnd:
+                return ScanHelper512<CMP, Bitwise::kAnd>(literal, bvblock, begin, end);
+            case Bitwise::kOr:
+                return ScanHelper512<CMP, Bitwise::kOr>(literal, bvblock, begin, end);
+        }
+    }
      switch(bit_opt){
         case Bitwise::kSet:
-            return ScanHelper2<CMP, Bitwise::kSet>(literal, bvblock);
+            return ScanHelper2<CMP, Bitwise::kSet>(literal, bvblock, begin, end);
         case Bitwise::kAnd:
-            return ScanHelper2<CMP, Bitwise::kAnd>(literal, bvblock);
+            return ScanHelper2<CMP, Bitwise::kAnd>(literal, bvblock, begin, end);
         case Bitwise::kOr:
-            return ScanHelper2<CMP, Bitwise::kOr>(literal, bvblock);
+            return ScanHelper2<CMP, Bitwise::kOr>(literal, bvblock, begin, end);
+    }
+}
+
+//One segment is 64 codes, i.e., one word of the bit vector.
+//m_equal starts from the codes that can still change the result word,
+//so it is also the early-stop test of kAnd/kOr.
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Comparator CMP, Bitwise OPT>
+AVX512_TARGET void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper512(WordUnit literal,
+                                            BitVectorBlock* bvblock,
+                                            size_t begin, size_t end) const {
+    //Prepare byte-slices of literal
+    Avx512Unit mask_literal[kNumBytesPerCode];
+    literal &= kCodeMask;
+    if(Direction::kRight == PDIRECTION){
+        literal <<= kNumPaddingBits;
+    }
+    for(size_t byte_id=0; byte_id < kNumBytesPerCode; byte_id++){
+         ByteUnit byte = FLIP(static_cast<ByteUnit>(literal >> 8*(kNumBytesPerCode - 1 - byte_id)));
+         mask_literal[byte_id] = avx512_set1_byte(byte);
+    }
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        Avx512Mask m_less = 0;
+        Avx512Mask m_greater = 0;
+        Avx512Mask m_equal = ~Avx512Mask(0);
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                m_equal = bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                m_equal = ~bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+
+        if(0 != m_equal){
+            ScanKernel512<CMP, 0>(avx512_load(data_[0]+offset), mask_literal[0],
+                    m_less, m_greater, m_equal);
+            if(kNumBytesPerCode > 1 && 0 != m_equal){
+                ScanKernel512<CMP, 1>(avx512_load(data_[1]+offset), mask_literal[1],
+                        m_less, m_greater, m_equal);
+                if(kNumBytesPerCode > 2 && 0 != m_equal){
+                    ScanKernel512<CMP, 2>(avx512_load(data_[2]+offset), mask_literal[2],
+                            m_less, m_greater, m_equal);
+                    if(kNumBytesPerCode > 3 && 0 != m_equal){
+                        ScanKernel512<CMP, 3>(avx512_load(data_[3]+offset), mask_literal[3],
+                                m_less, m_greater, m_equal);
+                        //codes wider than 32 bits: the remaining byte slices,
+                        //all as inner slices (mask_equal is kept)
+                        for(size_t byte_id = 4; byte_id < kNumBytesPerCode && 0 != m_equal; byte_id++){
+                            ScanKernel512<CMP, 0>(avx512_load(data_[byte_id]+offset), mask_literal[byte_id],
+                                    m_less, m_greater, m_equal);
+                        }
+                    }
+                }
+            }
+        }
+
+        WordUnit x;
+        switch(CMP){
+            case Comparator::kLessEqual:
+                x = m_less | m_equal;
+                break;
+            case Comparator::kLess:
+                x = m_less;
+                break;
+            case Comparator::kGreaterEqual:
+                x = m_greater | m_equal;
+                break;
+            case Comparator::kGreater:
+                x = m_greater;
+                break;
+            case Comparator::kEqual:
+                x = m_equal;
+                break;
+            case Comparator::kInequal:
+                x = ~m_equal;
+                break;
+        }
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblock->SetWordUnit(x, bv_word_id);
+    }
+    if(end == num_tuples_){
+        bvblock->ClearTail();
     }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP, Bitwise OPT>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
-                                            BitVectorBlock* bvblock) const {
+                                            BitVectorBlock* bvblock,
+                                            size_t begin, size_t end) const {
     //Prepare byte-slices of literal
     AvxUnit mask_literal[kNumBytesPerCode];
     literal &= kCodeMask;
@@ -133,8 +282,9 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
      WordUnit sum = 0;
 
 	 
-    //for every kNumWordBits (64) tuples
-    for(size_t offset = 0, bv_word_id = 0; offset < num_tuples_; offset += kNumWordBits, bv_word_id++){
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
         WordUnit bitvector_word = WordUnit(0);
         //need several iteration of AVX scan
         for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
@@ -228,6 +378,18 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
                                     m_less,
                                     m_greater,
                                     m_equal);
+                            //codes wider than 32 bits: the remaining byte slices
+                            for(size_t byte_id = 4; byte_id < kNumBytesPerCode
+                                    && ((OPT==Bitwise::kSet && !avx_iszero(m_equal))
+                                        || (OPT!=Bitwise::kSet && 0!=(input_mask & _mm256_movemask_epi8(m_equal))));
+                                    byte_id++){
+                                ScanKernel<CMP>(
+                                        avx_load( (void *)(data_[byte_id]+offset+i)),
+                                        mask_literal[byte_id],
+                                        m_less,
+                                        m_greater,
+                                        m_equal);
+                            }
                         }
                     }
                 }
@@ -282,18 +444,22 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
 #ifdef COUNTER_ENABLE
    printf("counter: %d, %d, %d, %d\n", counter[0], counter[1], counter[2], counter[3]); 
 #endif  	
-    bvblock->ClearTail();
+    if(end == num_tuples_){
+        bvblock->ClearTail();
+    }
 }
 
 //Scan against other block
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator,
-        const ColumnBlock* other_block, BitVectorBlock* bvblock, Bitwise bit_opt) const{
+        const ColumnBlock* other_block, BitVectorBlock* bvblock, Bitwise bit_opt,
+        size_t begin, size_t end) const{
 
     assert(bvblock->num() == num_tuples_);
     assert(other_block->num_tuples() == num_tuples_);
     assert(other_block->type() == type_);
     assert(other_block->bit_width() == bit_width_);
+    end = std::min(end, num_tuples_);
 
     const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* block2 =
         static_cast<const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>*>(other_block);
@@ -301,17 +467,17 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator,
     //multiplexing
     switch(comparator){
         case Comparator::kLess:
-            return ScanHelper1<Comparator::kLess>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kLess>(block2, bvblock, bit_opt, begin, end);
         case Comparator::kGreater:
-            return ScanHelper1<Comparator::kGreater>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kGreater>(block2, bvblock, bit_opt, begin, end);
         case Comparator::kLessEqual:
-            return ScanHelper1<Comparator::kLessEqual>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kLessEqual>(block2, bvblock, bit_opt, begin, end);
         case Comparator::kGreaterEqual:
-            return ScanHelper1<Comparator::kGreaterEqual>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kGreaterEqual>(block2, bvblock, bit_opt, begin, end);
         case Comparator::kEqual:
-            return ScanHelper1<Comparator::kEqual>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kEqual>(block2, bvblock, bit_opt, begin, end);
         case Comparator::kInequal:
-            return ScanHelper1<Comparator::kInequal>(block2, bvblock, bit_opt);
+            return ScanHelper1<Comparator::kInequal>(block2, bvblock, bit_opt, begin, end);
     }
 }
 
@@ -320,14 +486,15 @@ template <Comparator CMP>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper1(
                             const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* other_block,
                             BitVectorBlock* bvblock, 
-                            Bitwise bit_opt) const {
+                            Bitwise bit_opt,
+                            size_t begin, size_t end) const {
     switch(bit_opt){
         case Bitwise::kSet:
-            return ScanHelper2<CMP, Bitwise::kSet>(other_block, bvblock);
+            return ScanHelper2<CMP, Bitwise::kSet>(other_block, bvblock, begin, end);
         case Bitwise::kAnd:
-            return ScanHelper2<CMP, Bitwise::kAnd>(other_block, bvblock);
+            return ScanHelper2<CMP, Bitwise::kAnd>(other_block, bvblock, begin, end);
         case Bitwise::kOr:
-            return ScanHelper2<CMP, Bitwise::kOr>(other_block, bvblock);
+            return ScanHelper2<CMP, Bitwise::kOr>(other_block, bvblock, begin, end);
     }
 }
 
@@ -335,10 +502,12 @@ template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP, Bitwise OPT>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(
                             const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* other_block,
-                            BitVectorBlock* bvblock) const {
+                            BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const {
 
-    //for every kNumWordBits (64) tuples
-    for(size_t offset = 0, bv_word_id = 0; offset < num_tuples_; offset += kNumWordBits, bv_word_id++){
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
         WordUnit bitvector_word = WordUnit(0);
         //need several iteration of AVX scan
         for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
@@ -399,6 +568,18 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(
                                     m_less,
                                     m_greater,
                                     m_equal);
+                            //codes wider than 32 bits: the remaining byte slices
+                            for(size_t byte_id = 4; byte_id < kNumBytesPerCode
+                                    && ((OPT==Bitwise::kSet && !avx_iszero(m_equal))
+                                        || (OPT!=Bitwise::kSet && 0!=(input_mask & _mm256_movemask_epi8(m_equal))));
+                                    byte_id++){
+                                ScanKernel<CMP>(
+                                        avx_load( (void *)(data_[byte_id]+offset+i)),
+                                        avx_load( (void *)(other_block->data_[byte_id]+offset+i)),
+                                        m_less,
+                                        m_greater,
+                                        m_equal);
+                            }
                         }
                     }
                 }
@@ -445,11 +626,365 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(
         }
         bvblock->SetWordUnit(x, bv_word_id);
     }
-    bvblock->ClearTail();
+    if(end == num_tuples_){
+        bvblock->ClearTail();
+    }
     
 }
 
 
+//Scan against a list of literals (IN)
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanIn(const WordUnit* literals,
+        size_t num_literals, BitVectorBlock* bvblock, Bitwise bit_opt,
+        size_t begin, size_t end) const{
+    assert(bvblock->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
+
+    //sorted codes without duplicates; literals out of the domain never match
+    std::vector<WordUnit> list;
+    for(size_t l = 0; l < num_literals; l++){
+        if(literals[l] <= kCodeMask){
+            list.push_back(literals[l]);
+        }
+    }
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+
+    if(list.size() <= kMaxNumSimdInLiterals){
+        switch(bit_opt){
+            case Bitwise::kSet:
+                return ScanInHelper<Bitwise::kSet>(list, bvblock, begin, end);
+            case Bitwise::kAnd:
+                return ScanInHelper<Bitwise::kAnd>(list, bvblock, begin, end);
+            case Bitwise::kOr:
+                return ScanInHelper<Bitwise::kOr>(list, bvblock, begin, end);
+        }
+    }
+    else{
+        switch(bit_opt){
+            case Bitwise::kSet:
+                return ScanInBitmapHelper<Bitwise::kSet>(list, bvblock, begin, end);
+            case Bitwise::kAnd:
+                return ScanInBitmapHelper<Bitwise::kAnd>(list, bvblock, begin, end);
+            case Bitwise::kOr:
+                return ScanInBitmapHelper<Bitwise::kOr>(list, bvblock, begin, end);
+        }
+    }
+}
+
+//short list: every byte slice is loaded once and compared with all the literals
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Bitwise OPT>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanInHelper(
+                            const std::vector<WordUnit> &literals,
+                            BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const {
+    //Prepare byte-slices of literals
+    const size_t num_literals = literals.size();
+    AvxUnit mask_literal[kMaxNumSimdInLiterals][kNumBytesPerCode];
+    for(size_t l = 0; l < num_literals; l++){
+        WordUnit literal = literals[l];
+        if(Direction::kRight == PDIRECTION){
+            literal <<= kNumPaddingBits;
+        }
+        for(size_t byte_id=0; byte_id < kNumBytesPerCode; byte_id++){
+            ByteUnit byte = FLIP(static_cast<ByteUnit>(literal >> 8*(kNumBytesPerCode - 1 - byte_id)));
+            mask_literal[l][byte_id] = avx_set1<ByteUnit>(byte);
+        }
+    }
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit bitvector_word = WordUnit(0);
+        //need several iteration of AVX scan
+        for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
+            AvxUnit m_equal[kMaxNumSimdInLiterals];
+            AvxUnit m_any = avx_zero();     //equal to some literal so far
+            int input_mask = static_cast<int>(-1ULL);
+
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    input_mask = static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+                case Bitwise::kOr:
+                    input_mask = ~static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+            }
+
+            if((OPT==Bitwise::kSet) || 0 != input_mask){
+                AvxUnit byteslice = avx_load( (void *)(data_[0]+offset+i) );
+                for(size_t l = 0; l < num_literals; l++){
+                    m_equal[l] = avx_cmpeq<ByteUnit>(byteslice, mask_literal[l][0]);
+                    m_any = avx_or(m_any, m_equal[l]);
+                }
+                //early stop: no code matches any literal so far
+                for(size_t byte_id = 1; byte_id < kNumBytesPerCode
+                        && 0 != (input_mask & avx_movemask(m_any)); byte_id++){
+                    byteslice = avx_load( (void *)(data_[byte_id]+offset+i) );
+                    m_any = avx_zero();
+                    for(size_t l = 0; l < num_literals; l++){
+                        m_equal[l] = avx_and(m_equal[l],
+                                avx_cmpeq<ByteUnit>(byteslice, mask_literal[l][byte_id]));
+                        m_any = avx_or(m_any, m_equal[l]);
+                    }
+                }
+            }
+            //move mask
+            uint32_t mmask = avx_movemask(m_any);
+            //save in temporary bit vector
+            bitvector_word |= (static_cast<WordUnit>(mmask) << i);
+        }
+        //put result bitvector into bitvector block
+        WordUnit x = bitvector_word;
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblock->SetWordUnit(x, bv_word_id);
+    }
+    if(end == num_tuples_){
+        bvblock->ClearTail();
+    }
+}
+
+//long list: the first byte slice is filtered with a bitmap lookup (avx_lookup_bitmap),
+//then the remaining candidates are checked against the sorted list
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Bitwise OPT>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanInBitmapHelper(
+                            const std::vector<WordUnit> &literals,
+                            BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const {
+    //Prepare the bitmap of the first bytes of the literals
+    ByteUnit row_lo[16] = {0};
+    ByteUnit row_hi[16] = {0};
+    for(auto literal : literals){
+        if(Direction::kRight == PDIRECTION){
+            literal <<= kNumPaddingBits;
+        }
+        ByteUnit byte = static_cast<ByteUnit>(literal >> 8*(kNumBytesPerCode - 1));
+        if((byte >> 4) < 8){
+            row_lo[byte & 0x0f] |= static_cast<ByteUnit>(1 << (byte >> 4));
+        }
+        else{
+            row_hi[byte & 0x0f] |= static_cast<ByteUnit>(1 << ((byte >> 4) - 8));
+        }
+    }
+    alignas(32) ByteUnit rows_lo[kNumAvxBits/8];
+    alignas(32) ByteUnit rows_hi[kNumAvxBits/8];
+    for(size_t j = 0; j < kNumAvxBits/8; j++){
+        rows_lo[j] = row_lo[j % 16];
+        rows_hi[j] = row_hi[j % 16];
+    }
+    const AvxUnit mask_row_lo = avx_load( (void *)rows_lo );
+    const AvxUnit mask_row_hi = avx_load( (void *)rows_hi );
+    const AvxUnit mask_flip = avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(0)));
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit bitvector_word = WordUnit(0);
+        //need several iteration of AVX scan
+        for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
+            uint32_t mmask = 0;
+            uint32_t input_mask = static_cast<uint32_t>(-1ULL);
+
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    input_mask = static_cast<uint32_t>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+                case Bitwise::kOr:
+                    input_mask = ~static_cast<uint32_t>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+            }
+
+            if((OPT==Bitwise::kSet) || 0 != input_mask){
+                //stored bytes are flipped
+                AvxUnit byteslice = avx_xor(avx_load( (void *)(data_[0]+offset+i) ), mask_flip);
+                mmask = avx_movemask(avx_lookup_bitmap(byteslice, mask_row_lo, mask_row_hi))
+                            & input_mask;
+                if(kNumBytesPerCode > 1){
+                    uint32_t candidates = mmask;
+                    mmask = 0;
+                    while(0 != candidates){
+                        size_t bit = __builtin_ctz(candidates);
+                        if(std::binary_search(literals.begin(), literals.end(),
+                                    GetTuple(offset + i + bit))){
+                            mmask |= (1U << bit);
+                        }
+                        candidates &= candidates - 1;
+                    }
+                }
+            }
+            //save in temporary bit vector
+            bitvector_word |= (static_cast<WordUnit>(mmask) << i);
+        }
+        //put result bitvector into bitvector block
+        WordUnit x = bitvector_word;
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblock->SetWordUnit(x, bv_word_id);
+    }
+    if(end == num_tuples_){
+        bvblock->ClearTail();
+    }
+}
+
+
+//Scan against a range: both bounds are compared with one load per byte slice
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetween(Comparator comparator_lo,
+        WordUnit literal_lo, Comparator comparator_hi, WordUnit literal_hi,
+        BitVectorBlock* bvblock, Bitwise bit_opt, size_t begin, size_t end) const{
+    assert(bvblock->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
+    assert(Comparator::kGreater == comparator_lo || Comparator::kGreaterEqual == comparator_lo);
+    assert(Comparator::kLess == comparator_hi || Comparator::kLessEqual == comparator_hi);
+    if(Comparator::kGreaterEqual == comparator_lo){
+        if(Comparator::kLessEqual == comparator_hi){
+            return ScanBetweenHelper1<Comparator::kGreaterEqual, Comparator::kLessEqual>(
+                    literal_lo, literal_hi, bvblock, bit_opt, begin, end);
+        }
+        return ScanBetweenHelper1<Comparator::kGreaterEqual, Comparator::kLess>(
+                literal_lo, literal_hi, bvblock, bit_opt, begin, end);
+    }
+    else{
+        if(Comparator::kLessEqual == comparator_hi){
+            return ScanBetweenHelper1<Comparator::kGreater, Comparator::kLessEqual>(
+                    literal_lo, literal_hi, bvblock, bit_opt, begin, end);
+        }
+        return ScanBetweenHelper1<Comparator::kGreater, Comparator::kLess>(
+                literal_lo, literal_hi, bvblock, bit_opt, begin, end);
+    }
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Comparator CMP_LO, Comparator CMP_HI>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetweenHelper1(WordUnit literal_lo,
+        WordUnit literal_hi, BitVectorBlock* bvblock, Bitwise bit_opt,
+        size_t begin, size_t end) const{
+     switch(bit_opt){
+        case Bitwise::kSet:
+            return ScanBetweenHelper2<CMP_LO, CMP_HI, Bitwise::kSet>(literal_lo, literal_hi, bvblock, begin, end);
+        case Bitwise::kAnd:
+            return ScanBetweenHelper2<CMP_LO, CMP_HI, Bitwise::kAnd>(literal_lo, literal_hi, bvblock, begin, end);
+        case Bitwise::kOr:
+            return ScanBetweenHelper2<CMP_LO, CMP_HI, Bitwise::kOr>(literal_lo, literal_hi, bvblock, begin, end);
+    }
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Comparator CMP_LO, Comparator CMP_HI, Bitwise OPT>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetweenHelper2(WordUnit literal_lo,
+        WordUnit literal_hi, BitVectorBlock* bvblock,
+        size_t begin, size_t end) const {
+    //Prepare byte-slices of both literals
+    AvxUnit mask_literal_lo[kNumBytesPerCode];
+    AvxUnit mask_literal_hi[kNumBytesPerCode];
+    literal_lo &= kCodeMask;
+    literal_hi &= kCodeMask;
+    if(Direction::kRight == PDIRECTION){
+        literal_lo <<= kNumPaddingBits;
+        literal_hi <<= kNumPaddingBits;
+    }
+    for(size_t byte_id=0; byte_id < kNumBytesPerCode; byte_id++){
+        size_t shift = 8*(kNumBytesPerCode - 1 - byte_id);
+        mask_literal_lo[byte_id] = avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(literal_lo >> shift)));
+        mask_literal_hi[byte_id] = avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(literal_hi >> shift)));
+    }
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit bitvector_word = WordUnit(0);
+        //need several iteration of AVX scan
+        for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
+            AvxUnit m_greater_lo = avx_zero();
+            AvxUnit m_equal_lo = avx_ones();
+            AvxUnit m_less_hi = avx_zero();
+            AvxUnit m_equal_hi = avx_ones();
+            AvxUnit m_result = avx_zero();
+            int input_mask = static_cast<int>(-1ULL);
+
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    input_mask = static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+                case Bitwise::kOr:
+                    input_mask = ~static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+            }
+
+            if((OPT==Bitwise::kSet) || 0 != input_mask){
+                for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+                    AvxUnit byteslice = avx_load( (void *)(data_[byte_id]+offset+i) );
+                    m_greater_lo = avx_or(m_greater_lo, avx_and(m_equal_lo,
+                                avx_cmpgt<ByteUnit>(byteslice, mask_literal_lo[byte_id])));
+                    m_less_hi = avx_or(m_less_hi, avx_and(m_equal_hi,
+                                avx_cmplt<ByteUnit>(byteslice, mask_literal_hi[byte_id])));
+                    m_equal_lo = avx_and(m_equal_lo, avx_cmpeq<ByteUnit>(byteslice, mask_literal_lo[byte_id]));
+                    m_equal_hi = avx_and(m_equal_hi, avx_cmpeq<ByteUnit>(byteslice, mask_literal_hi[byte_id]));
+                    //early stop: a code is undecided while it ties one bound
+                    //and has not failed the other bound
+                    AvxUnit m_undecided = avx_or(
+                            avx_and(m_equal_lo, avx_or(m_less_hi, m_equal_hi)),
+                            avx_and(m_equal_hi, m_greater_lo));
+                    if(0 == (input_mask & avx_movemask(m_undecided))){
+                        break;
+                    }
+                }
+                AvxUnit m_lo = (CMP_LO == Comparator::kGreaterEqual) ?
+                                    avx_or(m_greater_lo, m_equal_lo) : m_greater_lo;
+                AvxUnit m_hi = (CMP_HI == Comparator::kLessEqual) ?
+                                    avx_or(m_less_hi, m_equal_hi) : m_less_hi;
+                m_result = avx_and(m_lo, m_hi);
+            }
+            //move mask
+            uint32_t mmask = avx_movemask(m_result);
+            //save in temporary bit vector
+            bitvector_word |= (static_cast<WordUnit>(mmask) << i);
+        }
+        //put result bitvector into bitvector block
+        WordUnit x = bitvector_word;
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblock->SetWordUnit(x, bv_word_id);
+    }
+    if(end == num_tuples_){
+        bvblock->ClearTail();
+    }
+}
+
 //Scan Kernel
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP>
@@ -482,6 +1017,37 @@ inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanKernel
     }
 }
 
+//Scan Kernel512 --- Scan Kernel2 on mask registers:
+//the comparisons are masked by mask_equal instead of and-ed with it
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Comparator CMP, size_t BYTE_ID>
+AVX512_TARGET inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanKernel512
+                                                        (const Avx512Unit &byteslice1,
+                                                         const Avx512Unit &byteslice2,
+                                                         Avx512Mask &mask_less,
+                                                         Avx512Mask &mask_greater,
+                                                         Avx512Mask &mask_equal) const {
+    //the last byte slice needs mask_equal only for kEqual, kInequal, kLessEqual and kGreaterEqual
+    const bool update_equal = (BYTE_ID < kNumBytesPerCode - 1)
+                                || (CMP != Comparator::kLess && CMP != Comparator::kGreater);
+    switch(CMP){
+        case Comparator::kEqual:
+        case Comparator::kInequal:
+            break;
+        case Comparator::kLess:
+        case Comparator::kLessEqual:
+            mask_less |= avx512_mask_cmplt_byte(mask_equal, byteslice1, byteslice2);
+            break;
+        case Comparator::kGreater:
+        case Comparator::kGreaterEqual:
+            mask_greater |= avx512_mask_cmpgt_byte(mask_equal, byteslice1, byteslice2);
+            break;
+    }
+    if(update_equal){
+        mask_equal = avx512_mask_cmpeq_byte(mask_equal, byteslice1, byteslice2);
+    }
+}
+
 //Scan Kernel2 --- Optimized on Scan Kernel
 //to remove unnecessary equal comparison for last byte slice
 template <size_t BIT_WIDTH, Direction PDIRECTION>
@@ -552,11 +1118,92 @@ inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanKernel2
 }
 
 
+//Materialize codes at a position list: SIMD gathers from every byte slice
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuples(const uint32_t* positions,
+                                                        size_t num, WordUnit* codes) const{
+    const size_t kNumCodesPerGather = kNumAvxBits/32;
+    const int shift = (Direction::kRight == PDIRECTION) ? kNumPaddingBits : 0;
+
+    size_t i = 0;
+    //the gather builds 32-bit codes: wider codes are read one at a time
+    for(; kNumBytesPerCode <= 4 && i + kNumCodesPerGather <= num; i += kNumCodesPerGather){
+        avx_gather_codes(data_, kNumBytesPerCode, positions + i, shift, codes + i);
+    }
+    for(; i < num; i++){
+        codes[i] = GetTuple(positions[i]);
+    }
+}
+
+//Materialize codes selected by a bit vector in [begin, end).
+//Dense words are rebuilt by sweeping the byte slices, sparse words are gathered.
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuples(const BitVectorBlock* bvblock,
+                                                          WordUnit* codes,
+                                                          size_t begin, size_t end) const{
+    assert(bvblock->num() == num_tuples_);
+    const size_t kNumCodesPerSweep = kNumAvxBits/8;
+    const WordUnit kSweepMask = (1ULL << kNumCodesPerSweep) - 1;
+    const int shift = (Direction::kRight == PDIRECTION) ? kNumPaddingBits : 0;
+    end = std::min(end, num_tuples_);
+
+    WordUnit* out = codes;
+    WordUnit buffer[kNumWordBits];
+    uint32_t positions[kNumWordBits];
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        WordUnit word = bvblock->GetWordUnit(offset / kNumWordBits);
+        size_t num_ones = POPCNT64(word);
+        if(kNumBytesPerCode <= 4 && num_ones >= kMinNumDenseBitsPerWord){
+            //a selected code lies within the slices, so does its whole sweep
+            for(size_t i = 0; i < kNumWordBits; i += kNumCodesPerSweep){
+                if(0 != ((word >> i) & kSweepMask)){
+                    avx_untranspose_codes(data_, kNumBytesPerCode, offset + i, shift, buffer + i);
+                }
+            }
+            for(size_t n = 0; 0 != word; n++){
+                out[n] = buffer[__builtin_ctzll(word)];
+                word &= word - 1;
+            }
+        }
+        else{
+            for(size_t n = 0; 0 != word; n++){
+                positions[n] = offset + __builtin_ctzll(word);
+                word &= word - 1;
+            }
+            GetTuples(positions, num_ones, out);
+        }
+        out += num_ones;
+    }
+    return out - codes;
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::BulkLoadArray(const WordUnit* codes,
                                                         size_t num, size_t start_pos){
     assert(start_pos + num <= num_tuples_);
-    for(size_t i = 0; i < num; i++){
+    const size_t kNumCodesPerBatch = kNumAvxBits/8;
+    const int shift = (Direction::kRight == PDIRECTION) ? kNumPaddingBits : 0;
+
+    //unaligned head and tail: one code at a time
+    size_t i = 0;
+    for(; i < num && 0 != (start_pos + i) % kNumCodesPerBatch; i++){
+        SetTuple(start_pos+i, codes[i]);
+    }
+    //a batch of codes at a time: transpose into one full vector per byte slice
+    //slices[0..3]: the low dword of the codes, slices[4..7]: the high dword
+    AvxUnit slices[8];
+    for(; i + kNumCodesPerBatch <= num; i += kNumCodesPerBatch){
+        avx_transpose_codes(codes + i, shift, false, slices);
+        if(kNumBytesPerCode > 4){
+            avx_transpose_codes(codes + i, shift, true, slices + 4);
+        }
+        for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+            size_t byte_in_code = kNumBytesPerCode - 1 - byte_id;
+            avx_store(data_[byte_id] + start_pos + i,
+                    (byte_in_code < 4) ? slices[3 - byte_in_code] : slices[11 - byte_in_code]);
+        }
+    }
+    for(; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
 }
@@ -597,5 +1244,37 @@ template class ByteSliceColumnBlock<29>;
 template class ByteSliceColumnBlock<30>;
 template class ByteSliceColumnBlock<31>;
 template class ByteSliceColumnBlock<32>;
+template class ByteSliceColumnBlock<33>;
+template class ByteSliceColumnBlock<34>;
+template class ByteSliceColumnBlock<35>;
+template class ByteSliceColumnBlock<36>;
+template class ByteSliceColumnBlock<37>;
+template class ByteSliceColumnBlock<38>;
+template class ByteSliceColumnBlock<39>;
+template class ByteSliceColumnBlock<40>;
+template class ByteSliceColumnBlock<41>;
+template class ByteSliceColumnBlock<42>;
+template class ByteSliceColumnBlock<43>;
+template class ByteSliceColumnBlock<44>;
+template class ByteSliceColumnBlock<45>;
+template class ByteSliceColumnBlock<46>;
+template class ByteSliceColumnBlock<47>;
+template class ByteSliceColumnBlock<48>;
+template class ByteSliceColumnBlock<49>;
+template class ByteSliceColumnBlock<50>;
+template class ByteSliceColumnBlock<51>;
+template class ByteSliceColumnBlock<52>;
+template class ByteSliceColumnBlock<53>;
+template class ByteSliceColumnBlock<54>;
+template class ByteSliceColumnBlock<55>;
+template class ByteSliceColumnBlock<56>;
+template class ByteSliceColumnBlock<57>;
+template class ByteSliceColumnBlock<58>;
+template class ByteSliceColumnBlock<59>;
+template class ByteSliceColumnBlock<60>;
+template class ByteSliceColumnBlock<61>;
+template class ByteSliceColumnBlock<62>;
+template class ByteSliceColumnBlock<63>;
+template class ByteSliceColumnBlock<64>;
 
 }   // namespace
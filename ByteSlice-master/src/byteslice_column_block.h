@@ -9,7 +9,11 @@
 #ifndef BYTESLICE_COLUMN_BLOCK_H
 #define BYTESLICE_COLUMN_BLOCK_H
 
+#include    <cassert>
+#include    <vector>
+
 #include "../src/avx-utility.h"
+#include "../src/avx512-utility.h"
 #include "../src/column_block.h"
 
 namespace byteslice{
@@ -31,35 +35,76 @@ public:
 
     WordUnit GetTuple(size_t pos) const override;
     void SetTuple(size_t pos, WordUnit value) override;
+    void GetTuples(const uint32_t* positions, size_t num, WordUnit* codes) const override;
+    size_t GetTuples(const BitVectorBlock* bvblock, WordUnit* codes,
+            size_t begin = 0, size_t end = kNumTuplesPerBlock) const override;
 
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bvblock,
-            Bitwise bit_opt = Bitwise::kSet) const override;
+            Bitwise bit_opt = Bitwise::kSet,
+            size_t begin = 0, size_t end = kNumTuplesPerBlock) const override;
     void Scan(Comparator comparator, const ColumnBlock* other_block,
-            BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet) const override;
+            BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet,
+            size_t begin = 0, size_t end = kNumTuplesPerBlock) const override;
+    void ScanIn(const WordUnit* literals, size_t num_literals, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet,
+            size_t begin = 0, size_t end = kNumTuplesPerBlock) const override;
+    void ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+            Comparator comparator_hi, WordUnit literal_hi,
+            BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet,
+            size_t begin = 0, size_t end = kNumTuplesPerBlock) const override;
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
     void SerToFile(SequentialWriteBinaryFile &file) const override;
     void DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
+    const ByteUnit* GetByteSlice(size_t byte_id) const override;
+    size_t GetNumBuffers() const override;
+    size_t GetBufferSize() const override;
+    const ByteUnit* GetBuffer(size_t buffer_id) const override;
+    void AttachBuffers(ByteUnit* const* buffers, size_t num) override;
 
     Direction GetPadDirection();
     
 private:
     //Scan Helper: literal
     template <Comparator CMP>
-    void ScanHelper1(WordUnit literal, BitVectorBlock* bvblock, Bitwise bit_opt) const;
+    void ScanHelper1(WordUnit literal, BitVectorBlock* bvblock, Bitwise bit_opt,
+                            size_t begin, size_t end) const;
+    template <Comparator CMP, Bitwise OPT>
+    void ScanHelper2(WordUnit literal, BitVectorBlock* bvblock, size_t begin, size_t end) const;
+
+    //Scan Helper: literal, 64 codes per segment in AVX-512 mask registers
     template <Comparator CMP, Bitwise OPT>
-    void ScanHelper2(WordUnit literal, BitVectorBlock* bvblock) const;
+    AVX512_TARGET void ScanHelper512(WordUnit literal, BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const;
 
     //Scan Helper: other block
     template <Comparator CMP>
     void ScanHelper1(const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* other_block,
-                            BitVectorBlock* bvblock, Bitwise bit_opt) const;
+                            BitVectorBlock* bvblock, Bitwise bit_opt,
+                            size_t begin, size_t end) const;
     template <Comparator CMP, Bitwise OPT>
     void ScanHelper2(const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* other_block,
-                            BitVectorBlock* bvblock) const;
-
+                            BitVectorBlock* bvblock, size_t begin, size_t end) const;
+
+
+    //Scan Helper: IN-list
+    template <Bitwise OPT>
+    void ScanInHelper(const std::vector<WordUnit> &literals, BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const;
+    template <Bitwise OPT>
+    void ScanInBitmapHelper(const std::vector<WordUnit> &literals, BitVectorBlock* bvblock,
+                            size_t begin, size_t end) const;
+
+    //Scan Helper: range
+    template <Comparator CMP_LO, Comparator CMP_HI>
+    void ScanBetweenHelper1(WordUnit literal_lo, WordUnit literal_hi,
+                            BitVectorBlock* bvblock, Bitwise bit_opt,
+                            size_t begin, size_t end) const;
+    template <Comparator CMP_LO, Comparator CMP_HI, Bitwise OPT>
+    void ScanBetweenHelper2(WordUnit literal_lo, WordUnit literal_hi,
+                            BitVectorBlock* bvblock, size_t begin, size_t end) const;
 
     //Scan Kernel
     template <Comparator CMP>
@@ -69,12 +114,17 @@ private:
     inline void ScanKernel2(const AvxUnit &byteslice1, const AvxUnit &byteslice2,
             AvxUnit &mask_less, AvxUnit &mask_greater, AvxUnit &mask_equal) const;
 
+    template <Comparator CMP, size_t BYTE_ID>
+    AVX512_TARGET inline void ScanKernel512(const Avx512Unit &byteslice1, const Avx512Unit &byteslice2,
+            Avx512Mask &mask_less, Avx512Mask &mask_greater, Avx512Mask &mask_equal) const;
+
     static constexpr size_t kNumBytesPerCode = CEIL(BIT_WIDTH, 8);
     static constexpr size_t kNumPaddingBits = kNumBytesPerCode * 8 - BIT_WIDTH;
     static constexpr Direction kPadDirection = PDIRECTION;
-    static constexpr WordUnit kCodeMask = (1ULL << BIT_WIDTH) - 1;
+    static constexpr WordUnit kCodeMask = CODE_MASK(BIT_WIDTH);
 
-    ByteUnit* data_[4];
+    ByteUnit* data_[kMaxNumBytesPerCode];
+    bool owns_data_ = true;     //false once buffers are attached
 
 
 };
@@ -82,25 +132,8 @@ private:
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline WordUnit ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(size_t pos) const{
     WordUnit ret = 0ULL;
-    switch(kNumBytesPerCode){
-        case 4:
-            ret = (static_cast<WordUnit>(FLIP(data_[0][pos])) << 24) |
-                    (static_cast<WordUnit>(FLIP(data_[1][pos])) << 16) |
-                    (static_cast<WordUnit>(FLIP(data_[2][pos])) << 8) |
-                    static_cast<WordUnit>(FLIP(data_[3][pos]));
-            break;
-        case 3:
-            ret = (static_cast<WordUnit>(FLIP(data_[0][pos])) << 16) |
-                    (static_cast<WordUnit>(FLIP(data_[1][pos])) << 8) |
-                    static_cast<WordUnit>(FLIP(data_[2][pos]));
-            break;
-        case 2:
-            ret = (static_cast<WordUnit>(FLIP(data_[0][pos])) << 8) |
-                    static_cast<WordUnit>(FLIP(data_[1][pos]));
-            break;
-        case 1:
-            ret = static_cast<WordUnit>(FLIP(data_[0][pos]));
-            break;
+    for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+        ret = (ret << 8) | static_cast<WordUnit>(FLIP(data_[byte_id][pos]));
     }
     switch(PDIRECTION){
         case Direction::kRight:
@@ -112,6 +145,12 @@ inline WordUnit ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(size_t pos
     return ret;
 }
 
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+inline const ByteUnit* ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetByteSlice(size_t byte_id) const{
+    assert(byte_id < kNumBytesPerCode);
+    return data_[byte_id];
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::SetTuple(size_t pos, WordUnit value){
     switch(PDIRECTION){
@@ -122,25 +161,8 @@ inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::SetTuple(size_t pos, Wo
             break;
     }
 
-    switch(kNumBytesPerCode){
-        case 4:
-            data_[0][pos] = FLIP(static_cast<ByteUnit>(value >> 24));
-            data_[1][pos] = FLIP(static_cast<ByteUnit>(value >> 16));
-            data_[2][pos] = FLIP(static_cast<ByteUnit>(value >> 8));
-            data_[3][pos] = FLIP(static_cast<ByteUnit>(value));
-            break;
-        case 3:
-            data_[0][pos] = FLIP(static_cast<ByteUnit>(value >> 16));
-            data_[1][pos] = FLIP(static_cast<ByteUnit>(value >> 8));
-            data_[2][pos] = FLIP(static_cast<ByteUnit>(value));
-            break;
-        case 2:
-            data_[0][pos] = FLIP(static_cast<ByteUnit>(value >> 8));
-            data_[1][pos] = FLIP(static_cast<ByteUnit>(value));
-            break;
-        case 1:
-            data_[0][pos] = FLIP(static_cast<ByteUnit>(value));
-            break;
+    for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+        data_[byte_id][pos] = FLIP(static_cast<ByteUnit>(value >> 8*(kNumBytesPerCode - 1 - byte_id)));
     }
 }
 
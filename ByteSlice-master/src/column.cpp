@@ -9,15 +9,33 @@
 #include 	"column.h"
 
 #include    <algorithm>
+#include    <cstring>
+#include    <fcntl.h>
 #include    <fstream>
+#include    <functional>
 #include    <iostream>
 #include    <omp.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
 
 #include 	"byteslice_column_block.h"
+#include 	"column_file.h"
 #include 	"naive_column_block.h"
+#include 	"numa_node.h"
 
 namespace byteslice {
 
+//block of a morsel, and its first tuple in the block
+//(morsels never cross a block)
+static inline size_t BlockOfMorsel(size_t morsel) {
+	return morsel * kNumTuplesPerMorsel / kNumTuplesPerBlock;
+}
+
+static inline size_t BeginOfMorsel(size_t morsel) {
+	return morsel * kNumTuplesPerMorsel % kNumTuplesPerBlock;
+}
+
 Column::Column(ColumnType type, size_t bit_width, size_t num) :
 		type_(type), bit_width_(bit_width), num_tuples_(num) {
 
@@ -37,6 +55,11 @@ void Column::Destroy() {
 		delete blocks_.back();
 		blocks_.pop_back();
 	}
+	if (nullptr != mapping_) {
+		munmap(mapping_, mapping_size_);
+		mapping_ = nullptr;
+	}
+	morsel_nodes_.clear();
 }
 
 WordUnit Column::GetTuple(size_t id) const {
@@ -52,6 +75,55 @@ void Column::SetTuple(size_t id, WordUnit value) {
 	blocks_[block_id]->SetTuple(pos_in_block, value);
 }
 
+void Column::GetTuples(const std::vector<size_t> &ids, WordUnit* codes) const {
+	if (ids.empty()) {
+		return;
+	}
+	const size_t num_chunks = CEIL(ids.size(), kNumTuplesPerMorsel);
+#pragma omp parallel for schedule(dynamic)
+	for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+		std::vector<uint32_t> positions(kNumTuplesPerMorsel);
+		size_t begin = chunk * kNumTuplesPerMorsel;
+		size_t end = std::min(ids.size(), begin + kNumTuplesPerMorsel);
+		//one run of ids falling into the same block at a time
+		while (begin < end) {
+			size_t block_id = ids[begin] / kNumTuplesPerBlock;
+			size_t num = 0;
+			for (size_t i = begin; i < end && ids[i] / kNumTuplesPerBlock == block_id; i++) {
+				assert(ids[i] < num_tuples_);
+				positions[num++] = ids[i] % kNumTuplesPerBlock;
+			}
+			blocks_[block_id]->GetTuples(positions.data(), num, codes + begin);
+			begin += num;
+		}
+	}
+}
+
+size_t Column::GetTuples(const BitVector* bitvector, WordUnit* codes) const {
+	assert(num_tuples_ == bitvector->num());
+	//output offset of every morsel
+	const size_t num_morsels = NumMorsels(num_tuples_);
+	std::vector<size_t> offsets(num_morsels + 1, 0);
+#pragma omp parallel for schedule(static)
+	for (size_t morsel = 0; morsel < num_morsels; morsel++) {
+		const size_t begin = BeginOfMorsel(morsel);
+		offsets[morsel + 1] = bitvector->GetBVBlock(BlockOfMorsel(morsel))->CountOnes(
+				begin, begin + kNumTuplesPerMorsel);
+	}
+	for (size_t morsel = 0; morsel < num_morsels; morsel++) {
+		offsets[morsel + 1] += offsets[morsel];
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (size_t morsel = 0; morsel < num_morsels; morsel++) {
+		const size_t block_id = BlockOfMorsel(morsel);
+		const size_t begin = BeginOfMorsel(morsel);
+		blocks_[block_id]->GetTuples(bitvector->GetBVBlock(block_id),
+				codes + offsets[morsel], begin, begin + kNumTuplesPerMorsel);
+	}
+	return offsets.back();
+}
+
 size_t Column::LoadTextFile(std::string filepath) {
 	std::ifstream infile;
 	infile.open(filepath, std::ifstream::in);
@@ -69,6 +141,9 @@ size_t Column::LoadTextFile(std::string filepath) {
 }
 
 void Column::Resize(size_t num) {
+	if (NumMorsels(num) != NumMorsels(num_tuples_)) {
+		morsel_nodes_.clear();
+	}
 	num_tuples_ = num;
 	const size_t new_num_blocks = CEIL(num, kNumTuplesPerBlock);
 	const size_t old_num_blocks = blocks_.size();
@@ -109,20 +184,289 @@ void Column::DeserFromFile(const SequentialReadBinaryFile &file) {
 	}
 }
 
+static inline uint64_t AlignToFile(uint64_t offset) {
+	return CEIL(offset, kColumnFileAlignment) * kColumnFileAlignment;
+}
+
+static void WriteAll(int fd, const void* data, size_t size, uint64_t offset,
+		const std::string &filepath) {
+	const char* p = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t count = pwrite(fd, p, size, offset);
+		if (count <= 0) {
+			std::cerr << "[FATAL] Can't write file: " << filepath << std::endl;
+			exit(1);
+		}
+		p += count;
+		size -= count;
+		offset += count;
+	}
+}
+
+void Column::WriteFile(const std::string &filepath) const {
+	ColumnFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kColumnFileMagic, sizeof(header.magic));
+	header.version = kColumnFileVersion;
+	header.type = static_cast<uint32_t>(type_);
+	header.bit_width = bit_width_;
+	header.num_tuples = num_tuples_;
+	header.num_blocks = blocks_.size();
+	header.num_tuples_per_block = kNumTuplesPerBlock;
+	header.buffer_size = blocks_.empty() ? 0 : blocks_[0]->GetBufferSize();
+
+	std::vector<ColumnFileBlock> entries(blocks_.size());
+	uint64_t offset = AlignToFile(sizeof(header) + sizeof(ColumnFileBlock) * blocks_.size());
+	uint64_t file_size = offset;
+	for (size_t block_id = 0; block_id < blocks_.size(); block_id++) {
+		ColumnFileBlock &entry = entries[block_id];
+		memset(&entry, 0, sizeof(entry));
+		entry.num_tuples = blocks_[block_id]->num_tuples();
+		entry.num_buffers = blocks_[block_id]->GetNumBuffers();
+		for (size_t i = 0; i < entry.num_buffers; i++) {
+			entry.offsets[i] = offset;
+			file_size = offset + header.buffer_size;
+			offset = AlignToFile(file_size);
+		}
+	}
+
+	int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		std::cerr << "[FATAL] Can't open file: " << filepath << std::endl;
+		exit(1);
+	}
+	WriteAll(fd, &header, sizeof(header), 0, filepath);
+	WriteAll(fd, entries.data(), sizeof(ColumnFileBlock) * entries.size(),
+			sizeof(header), filepath);
+	//only the codes of a block are written (whole 64-tuple words); the rest
+	//of its buffers, up to the capacity of a block, is left as a hole
+	const size_t bytes_per_tuple = header.buffer_size / kNumTuplesPerBlock;
+	for (size_t block_id = 0; block_id < blocks_.size(); block_id++) {
+		const size_t num = entries[block_id].num_tuples;
+		const size_t used_size = (0 == num) ? 0 :
+				std::min<size_t>(header.buffer_size, CEIL(num, 64) * 64 * bytes_per_tuple);
+		for (size_t i = 0; i < entries[block_id].num_buffers; i++) {
+			WriteAll(fd, blocks_[block_id]->GetBuffer(i), used_size,
+					entries[block_id].offsets[i], filepath);
+		}
+	}
+	//the gaps between buffers are holes
+	if (0 != ftruncate(fd, file_size) || 0 != close(fd)) {
+		std::cerr << "[FATAL] Can't write file: " << filepath << std::endl;
+		exit(1);
+	}
+}
+
+Column* Column::MapFile(const std::string &filepath, bool populate, bool huge_pages) {
+	int fd = open(filepath.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || 0 != fstat(fd, &st)) {
+		std::cerr << "[FATAL] Can't open file: " << filepath << std::endl;
+		exit(1);
+	}
+	const size_t size = st.st_size;
+	ColumnFileHeader header;
+	if (size < sizeof(header)
+			|| static_cast<ssize_t>(sizeof(header)) != pread(fd, &header, sizeof(header), 0)
+			|| 0 != memcmp(header.magic, kColumnFileMagic, sizeof(header.magic))) {
+		std::cerr << "[FATAL] Not a column file: " << filepath << std::endl;
+		exit(1);
+	}
+	if (kColumnFileVersion != header.version
+			|| kNumTuplesPerBlock != header.num_tuples_per_block) {
+		std::cerr << "[FATAL] Incompatible column file (version " << header.version
+				<< ", " << header.num_tuples_per_block << " tuples per block): "
+				<< filepath << std::endl;
+		exit(1);
+	}
+
+	//private and writable: writes go to copies of the pages
+	const int flags = MAP_PRIVATE | (populate ? MAP_POPULATE : 0);
+	void* mapping = MAP_FAILED;
+	if (huge_pages) {
+		mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, fd, 0);
+	}
+	if (MAP_FAILED == mapping) {
+		mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+		if (MAP_FAILED != mapping && huge_pages) {
+			madvise(mapping, size, MADV_HUGEPAGE);
+		}
+	}
+	close(fd);
+	if (MAP_FAILED == mapping) {
+		std::cerr << "[FATAL] Can't map file: " << filepath << std::endl;
+		exit(1);
+	}
+
+	ByteUnit* base = static_cast<ByteUnit*>(mapping);
+	const ColumnFileBlock* entries = reinterpret_cast<const ColumnFileBlock*>(
+			base + sizeof(header));
+	if (sizeof(header) + sizeof(ColumnFileBlock) * header.num_blocks > size) {
+		std::cerr << "[FATAL] Truncated column file: " << filepath << std::endl;
+		exit(1);
+	}
+	Column* column = new Column(static_cast<ColumnType>(header.type), header.bit_width);
+	column->mapping_ = mapping;
+	column->mapping_size_ = size;
+	for (size_t block_id = 0; block_id < header.num_blocks; block_id++) {
+		const ColumnFileBlock &entry = entries[block_id];
+		ColumnBlock* block = column->CreateNewBlock();
+		bool valid = entry.num_buffers == block->GetNumBuffers()
+				&& header.buffer_size == block->GetBufferSize()
+				&& entry.num_tuples <= kNumTuplesPerBlock;
+		ByteUnit* buffers[kMaxNumBytesPerCode];
+		for (size_t i = 0; valid && i < entry.num_buffers; i++) {
+			valid = entry.offsets[i] + header.buffer_size <= size;
+			buffers[i] = base + entry.offsets[i];
+		}
+		if (!valid) {
+			std::cerr << "[FATAL] Corrupt column file: " << filepath << std::endl;
+			exit(1);
+		}
+		block->AttachBuffers(buffers, entry.num_tuples);
+		column->blocks_.push_back(block);
+	}
+	column->num_tuples_ = header.num_tuples;
+	return column;
+}
+
 void Column::BulkLoadArray(const WordUnit* codes, size_t num, size_t pos) {
 	assert(pos + num <= num_tuples_);
-	size_t block_id = pos / kNumTuplesPerBlock;
-	size_t pos_in_block = pos % kNumTuplesPerBlock;
-	size_t num_remain_tuples = num;
-	const WordUnit* data_ptr = codes;
-	while (num_remain_tuples > 0) {
-		size_t size = std::min(blocks_[block_id]->num_tuples() - pos_in_block,
-				num_remain_tuples);
-		blocks_[block_id]->BulkLoadArray(data_ptr, size, pos_in_block);
-		data_ptr += size;
-		num_remain_tuples -= size;
-		pos_in_block = 0;
-		block_id++;
+	if (0 == num) {
+		return;
+	}
+	//morsels are aligned in the column and never cross a block,
+	//so no two threads write the same vector of a byte slice
+	const size_t first_morsel = pos / kNumTuplesPerMorsel;
+	const size_t end_morsel = CEIL(pos + num, kNumTuplesPerMorsel);
+#pragma omp parallel for schedule(dynamic)
+	for (size_t morsel = first_morsel; morsel < end_morsel; morsel++) {
+		size_t begin = std::max(pos, morsel * kNumTuplesPerMorsel);
+		size_t end = std::min(pos + num, (morsel + 1) * kNumTuplesPerMorsel);
+		blocks_[begin / kNumTuplesPerBlock]->BulkLoadArray(codes + (begin - pos),
+				end - begin, begin % kNumTuplesPerBlock);
+	}
+}
+
+void Column::PlaceOnNumaNodes() {
+	const size_t num_nodes = GetNumNumaNodes();
+	const size_t num_morsels = NumMorsels(num_tuples_);
+	morsel_nodes_.assign(num_morsels, 0);
+	//one run of morsels of the same block and node at a time
+	for (size_t first = 0, last; first < num_morsels; first = last) {
+		const size_t block_id = BlockOfMorsel(first);
+		const size_t node = GetPlannedNumaNode(first, num_morsels, num_nodes);
+		for (last = first + 1; last < num_morsels && BlockOfMorsel(last) == block_id
+				&& GetPlannedNumaNode(last, num_morsels, num_nodes) == node; last++) {
+		}
+		//only whole pages are bound; the morsels of a ByteSlice block are whole
+		//pages of its byte slices, so neighbouring runs do not share a page
+		const ColumnBlock* block = blocks_[block_id];
+		const size_t bytes_per_tuple = block->GetBufferSize() / kNumTuplesPerBlock;
+		const size_t begin = BeginOfMorsel(first) * bytes_per_tuple;
+		const size_t size = (last - first) * kNumTuplesPerMorsel * bytes_per_tuple;
+		for (size_t i = 0; i < block->GetNumBuffers(); i++) {
+			BindToNumaNode(const_cast<ByteUnit*>(block->GetBuffer(i)) + begin, size, node);
+		}
+		//where the memory really is, in case the kernel refused to bind it
+		const int actual = GetNumaNodeOfAddress(block->GetBuffer(0) + begin + size / 2);
+		for (size_t morsel = first; morsel < last; morsel++) {
+			morsel_nodes_[morsel] = (actual >= 0 && static_cast<size_t>(actual) < num_nodes) ?
+					actual : node;
+		}
+	}
+}
+
+worker_pool_t* Column::worker_pool_ = nullptr;
+
+//runs the std::function<void()> pointed to by arg
+static void* RunDrain(void* arg) {
+	(*static_cast<const std::function<void()>*>(arg))();
+	return nullptr;
+}
+
+template <typename Function>
+void Column::ScanMorsels(const std::vector<const Column*> &columns, Function scan,
+		size_t num_morsels_per_task) {
+	assert(0 == (kNumTuplesPerBlock / kNumTuplesPerMorsel) % num_morsels_per_task);
+	const Column* first = columns[0];
+	const size_t num_morsels = NumMorsels(first->num_tuples_);
+	const size_t num_tasks = (num_morsels + num_morsels_per_task - 1) / num_morsels_per_task;
+	const size_t task_size = num_morsels_per_task * kNumTuplesPerMorsel;
+	const bool placed = first->IsPlacedOnNumaNodes();
+	worker_pool_t* pool = worker_pool_;
+	const bool use_pool = (nullptr != pool) && (worker_pool_current_worker() < 0);
+	if (!placed && !use_pool) {
+#pragma omp parallel for schedule(dynamic)
+		for (size_t task = 0; task < num_tasks; task++) {
+			const size_t morsel = task * num_morsels_per_task;
+			const size_t begin = BeginOfMorsel(morsel);
+			scan(BlockOfMorsel(morsel), begin, begin + task_size);
+		}
+		return;
+	}
+
+	//tasks of every node (that of their first morsel), taken in order by the
+	//threads of that node, and by the threads of other nodes once their own
+	//node is done (a single queue if the column is not placed)
+	const size_t num_nodes = placed ? GetNumNumaNodes() : 1;
+	std::vector<std::vector<size_t>> queues(num_nodes);
+	for (size_t task = 0; task < num_tasks; task++) {
+		queues[placed ? first->morsel_nodes_[task * num_morsels_per_task] : 0].push_back(task);
+	}
+	std::vector<size_t> heads(num_nodes, 0);
+
+	const std::function<void()> drain = [&]() {
+		const size_t home = placed ? GetCurrentNumaNode() : 0;
+		std::vector<uint64_t> local_bytes(columns.size(), 0);
+		std::vector<uint64_t> remote_bytes(columns.size(), 0);
+		for (size_t k = 0; k < num_nodes; k++) {
+			const size_t node = (home + k) % num_nodes;
+			while (true) {
+				size_t i;
+#pragma omp atomic capture
+				i = heads[node]++;
+				if (i >= queues[node].size()) {
+					break;
+				}
+				const size_t first_morsel = queues[node][i] * num_morsels_per_task;
+				const size_t block_id = BlockOfMorsel(first_morsel);
+				const size_t task_begin = BeginOfMorsel(first_morsel);
+				scan(block_id, task_begin, task_begin + task_size);
+				const size_t last_morsel = std::min(num_morsels, first_morsel + num_morsels_per_task);
+				for (size_t morsel = first_morsel; morsel < last_morsel; morsel++) {
+					const size_t begin = BeginOfMorsel(morsel);
+					for (size_t c = 0; c < columns.size(); c++) {
+						const Column* column = columns[c];
+						if (column->IsPlacedOnNumaNodes()) {
+							const uint64_t bytes = (std::min(column->blocks_[block_id]->num_tuples(),
+									begin + kNumTuplesPerMorsel) - begin) * CEIL(column->bit_width_, 8);
+							if (home == column->morsel_nodes_[morsel]) {
+								local_bytes[c] += bytes;
+							} else {
+								remote_bytes[c] += bytes;
+							}
+						}
+					}
+				}
+			}
+		}
+		for (size_t c = 0; c < columns.size(); c++) {
+#pragma omp atomic
+			columns[c]->numa_local_bytes_ += local_bytes[c];
+#pragma omp atomic
+			columns[c]->numa_remote_bytes_ += remote_bytes[c];
+		}
+	};
+
+	if (use_pool) {
+		//every worker gets the same argument
+		worker_pool_run(pool, RunDrain, const_cast<std::function<void()>*>(&drain), 0);
+		return;
+	}
+#pragma omp parallel
+	{
+		drain();
 	}
 }
 
@@ -131,12 +475,10 @@ void Column::Scan(Comparator comparator, WordUnit literal, BitVector* bitvector,
 
 	assert(num_tuples_ == bitvector->num());
 
-#pragma omp parallel for schedule(dynamic)
-	for (size_t block_id = 0; block_id < blocks_.size(); block_id++) {
-
+	ScanMorsels({this}, [&](size_t block_id, size_t begin, size_t end) {
 		blocks_[block_id]->Scan(comparator, literal,
-				bitvector->GetBVBlock(block_id), bit_opt);
-	}
+				bitvector->GetBVBlock(block_id), bit_opt, begin, end);
+	});
 }
 
 void Column::Scan(Comparator comparator, const Column* other_column,
@@ -146,17 +488,123 @@ void Column::Scan(Comparator comparator, const Column* other_column,
 	assert(bit_width_ == other_column->GetBitWidth());
 	assert(num_tuples_ == other_column->GetNumTuples());
 
-#pragma omp parallel for schedule(dynamic)
-	for (size_t block_id = 0; block_id < blocks_.size(); block_id++) {
+	ScanMorsels({this, other_column}, [&](size_t block_id, size_t begin, size_t end) {
 		blocks_[block_id]->Scan(comparator, other_column->blocks_[block_id],
-				bitvector->GetBVBlock(block_id), bit_opt);
+				bitvector->GetBVBlock(block_id), bit_opt, begin, end);
+	});
+
+}
+
+void Column::ScanIn(const std::vector<WordUnit> &literals, BitVector* bitvector,
+		Bitwise bit_opt) const {
+	assert(num_tuples_ == bitvector->num());
+
+	ScanMorsels({this}, [&](size_t block_id, size_t begin, size_t end) {
+		blocks_[block_id]->ScanIn(literals.data(), literals.size(),
+				bitvector->GetBVBlock(block_id), bit_opt, begin, end);
+	});
+}
+
+void Column::ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+		Comparator comparator_hi, WordUnit literal_hi,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	assert(num_tuples_ == bitvector->num());
+	if (!(Comparator::kGreater == comparator_lo || Comparator::kGreaterEqual == comparator_lo)
+			|| !(Comparator::kLess == comparator_hi || Comparator::kLessEqual == comparator_hi)) {
+		std::cerr << "[FATAL] Incorrect comparators for a range scan." << std::endl;
+		exit(1);
 	}
 
+	ScanMorsels({this}, [&](size_t block_id, size_t begin, size_t end) {
+		blocks_[block_id]->ScanBetween(comparator_lo, literal_lo, comparator_hi, literal_hi,
+				bitvector->GetBVBlock(block_id), bit_opt, begin, end);
+	});
+}
+
+void Column::ScanShared(const std::vector<ColumnScanQuery> &queries) const {
+	if (queries.empty()) {
+		return;
+	}
+	std::vector<std::vector<BlockScanQuery>> block_queries(blocks_.size());
+	for (size_t block_id = 0; block_id < blocks_.size(); block_id++) {
+		for (const auto &query : queries) {
+			assert(num_tuples_ == query.bitvector->num());
+			block_queries[block_id].push_back({query.comparator, query.literal,
+					query.bitvector->GetBVBlock(block_id), query.bit_opt});
+		}
+	}
+	ScanMorsels({this}, [&](size_t block_id, size_t begin, size_t end) {
+		ColumnBlock::ScanShared(blocks_[block_id], block_queries[block_id].data(),
+				block_queries[block_id].size(), begin, end);
+	});
+}
+
+//the terms of predicates on every block
+static std::vector<std::vector<BlockPredicate>> GetBlockPredicates(
+		const std::vector<ColumnPredicate> &predicates) {
+	std::vector<std::vector<BlockPredicate>> block_predicates(
+			predicates[0].column->GetNumBlocks());
+	for (size_t block_id = 0; block_id < block_predicates.size(); block_id++) {
+		for (auto predicate : predicates) {
+			const ColumnBlock* other_block = (nullptr == predicate.other_column) ?
+					nullptr : predicate.other_column->GetBlock(block_id);
+			block_predicates[block_id].push_back({predicate.column->GetBlock(block_id),
+					predicate.comparator, predicate.literal, other_block});
+		}
+	}
+	return block_predicates;
+}
+
+void Column::ScanConjunction(const std::vector<ColumnPredicate> &predicates,
+		BitVector* bitvector, Bitwise bit_opt) {
+	assert(!predicates.empty());
+	std::vector<const Column*> columns;
+	for (auto predicate : predicates) {
+		assert(bitvector->num() == predicate.column->GetNumTuples());
+		assert(nullptr == predicate.other_column
+				|| bitvector->num() == predicate.other_column->GetNumTuples());
+		columns.push_back(predicate.column);
+		if (nullptr != predicate.other_column) {
+			columns.push_back(predicate.other_column);
+		}
+	}
+
+	const std::vector<std::vector<BlockPredicate>> block_predicates =
+			GetBlockPredicates(predicates);
+	ScanMorsels(columns, [&](size_t block_id, size_t begin, size_t end) {
+		ColumnBlock::ScanConjunction(block_predicates[block_id].data(),
+				block_predicates[block_id].size(), bitvector->GetBVBlock(block_id),
+				bit_opt, begin, end);
+	});
+}
+
+void Column::ScanOrdered(const std::vector<ColumnPredicate> &predicates,
+		BitVector* bitvector, Bitwise bit_opt) {
+	assert(!predicates.empty());
+	std::vector<const Column*> columns;
+	for (auto predicate : predicates) {
+		assert(bitvector->num() == predicate.column->GetNumTuples());
+		assert(nullptr == predicate.other_column
+				|| bitvector->num() == predicate.other_column->GetNumTuples());
+		columns.push_back(predicate.column);
+		if (nullptr != predicate.other_column) {
+			columns.push_back(predicate.other_column);
+		}
+	}
+
+	const std::vector<std::vector<BlockPredicate>> block_predicates =
+			GetBlockPredicates(predicates);
+	//a task is one estimate of the order (see ColumnBlock::ScanOrdered)
+	ScanMorsels(columns, [&](size_t block_id, size_t begin, size_t end) {
+		ColumnBlock::ScanOrdered(block_predicates[block_id].data(),
+				block_predicates[block_id].size(), bitvector->GetBVBlock(block_id),
+				bit_opt, nullptr, begin, end);
+	}, kNumMorselsPerEstimate);
 }
 
 ColumnBlock* Column::CreateNewBlock() const {
-	assert(0 < bit_width_ && 32 >= bit_width_);
-	if (!(0 < bit_width_ && 32 >= bit_width_)) {
+	assert(0 < bit_width_ && 64 >= bit_width_);
+	if (!(0 < bit_width_ && 64 >= bit_width_)) {
 		std::cerr << "[FATAL] Incorrect bit width: " << bit_width_ << std::endl;
 		exit(1);
 	}
@@ -171,6 +619,11 @@ ColumnBlock* Column::CreateNewBlock() const {
 		case 3:
 		case 4:
 			return new NaiveColumnBlock<uint32_t>();
+		case 5:
+		case 6:
+		case 7:
+		case 8:
+			return new NaiveColumnBlock<uint64_t>();
 		}
 		break;
 	case ColumnType::kByteSlicePadRight:
@@ -239,6 +692,70 @@ ColumnBlock* Column::CreateNewBlock() const {
 			return new ByteSliceColumnBlock<31>();
 		case 32:
 			return new ByteSliceColumnBlock<32>();
+		case 33:
+			return new ByteSliceColumnBlock<33>();
+		case 34:
+			return new ByteSliceColumnBlock<34>();
+		case 35:
+			return new ByteSliceColumnBlock<35>();
+		case 36:
+			return new ByteSliceColumnBlock<36>();
+		case 37:
+			return new ByteSliceColumnBlock<37>();
+		case 38:
+			return new ByteSliceColumnBlock<38>();
+		case 39:
+			return new ByteSliceColumnBlock<39>();
+		case 40:
+			return new ByteSliceColumnBlock<40>();
+		case 41:
+			return new ByteSliceColumnBlock<41>();
+		case 42:
+			return new ByteSliceColumnBlock<42>();
+		case 43:
+			return new ByteSliceColumnBlock<43>();
+		case 44:
+			return new ByteSliceColumnBlock<44>();
+		case 45:
+			return new ByteSliceColumnBlock<45>();
+		case 46:
+			return new ByteSliceColumnBlock<46>();
+		case 47:
+			return new ByteSliceColumnBlock<47>();
+		case 48:
+			return new ByteSliceColumnBlock<48>();
+		case 49:
+			return new ByteSliceColumnBlock<49>();
+		case 50:
+			return new ByteSliceColumnBlock<50>();
+		case 51:
+			return new ByteSliceColumnBlock<51>();
+		case 52:
+			return new ByteSliceColumnBlock<52>();
+		case 53:
+			return new ByteSliceColumnBlock<53>();
+		case 54:
+			return new ByteSliceColumnBlock<54>();
+		case 55:
+			return new ByteSliceColumnBlock<55>();
+		case 56:
+			return new ByteSliceColumnBlock<56>();
+		case 57:
+			return new ByteSliceColumnBlock<57>();
+		case 58:
+			return new ByteSliceColumnBlock<58>();
+		case 59:
+			return new ByteSliceColumnBlock<59>();
+		case 60:
+			return new ByteSliceColumnBlock<60>();
+		case 61:
+			return new ByteSliceColumnBlock<61>();
+		case 62:
+			return new ByteSliceColumnBlock<62>();
+		case 63:
+			return new ByteSliceColumnBlock<63>();
+		case 64:
+			return new ByteSliceColumnBlock<64>();
 		}
 		break;
 	default:
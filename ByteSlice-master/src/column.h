@@ -18,10 +18,38 @@
 #include 	"param.h"
 #include 	"sequential_binary_file.h"
 #include 	"types.h"
+#include 	"worker_pool.h"
 
 namespace byteslice{
 
 class BitVector;
+class Column;
+
+//one term of a conjunction, see Column::ScanConjunction
+//column compared with literal, or with other_column if it is not nullptr
+struct ColumnPredicate{
+    const Column* column;
+    Comparator comparator;
+    WordUnit literal;
+    const Column* other_column;
+};
+
+//one query of a shared scan, see Column::ScanShared
+//column compared with literal, the result put into bitvector with bit_opt
+//(kSet if omitted)
+struct ColumnScanQuery{
+    Comparator comparator;
+    WordUnit literal;
+    BitVector* bitvector;
+    Bitwise bit_opt;
+};
+
+//bytes of codes scanned from morsels on the NUMA node of the scanning thread,
+//and from morsels on other nodes; see Column::PlaceOnNumaNodes
+struct NumaScanStats{
+    uint64_t local_bytes;
+    uint64_t remote_bytes;
+};
 
 class Column{
 public:
@@ -31,11 +59,38 @@ public:
 
     WordUnit GetTuple(size_t id) const;
     void SetTuple(size_t id, WordUnit value);
+
+    /**
+     * @brief Materialize the codes of the given tuple ids into codes.
+     */
+    void GetTuples(const std::vector<size_t> &ids, WordUnit* codes) const;
+
+    /**
+     * @brief Materialize the codes of the tuples selected by bitvector into
+     * codes, in tuple order. Returns the number of codes.
+     */
+    size_t GetTuples(const BitVector* bitvector, WordUnit* codes) const;
     void Resize(size_t num);
 
     void SerToFile(SequentialWriteBinaryFile &file) const;
     void DeserFromFile(const SequentialReadBinaryFile &file);
 
+    /**
+     * @brief Write the column in the format of column_file.h.
+     */
+    void WriteFile(const std::string &filepath) const;
+
+    /**
+     * @brief Attach a column to the file written by WriteFile, without copying:
+     * the blocks use the buffers mapped from the file. Writes to the column
+     * are private (copy-on-write) and never reach the file.
+     * populate: fault the whole file in now (MAP_POPULATE).
+     * huge_pages: map with MAP_HUGETLB if the file system supports it
+     * (e.g., hugetlbfs), or ask for transparent huge pages otherwise.
+     */
+    static Column* MapFile(const std::string &filepath,
+            bool populate=false, bool huge_pages=false);
+
     /**
      * @brief Load the column from a projection file in text format.
      * One integer per line.
@@ -51,6 +106,65 @@ public:
             BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
     void Scan(Comparator comparator, const Column* other_column, 
             BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    void ScanIn(const std::vector<WordUnit> &literals,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    void ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+            Comparator comparator_hi, WordUnit literal_hi,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+
+    /**
+     * @brief Evaluate the predicates of a batch of queries on this column in
+     * one pass over its byte slices, writing one bit vector per query.
+     * Callers collect the queries pending on the column and submit them
+     * together, so that N memory-bound scans read the column once.
+     */
+    void ScanShared(const std::vector<ColumnScanQuery> &queries) const;
+
+    /**
+     * @brief Evaluate the conjunction of predicates on several ByteSlice
+     * columns (of the same length) in a single pass.
+     */
+    static void ScanConjunction(const std::vector<ColumnPredicate> &predicates,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet);
+
+    /**
+     * @brief Evaluate the conjunction predicate by predicate, ordered by
+     * selectivity and cost sampled afresh every kNumMorselsPerEstimate morsels.
+     */
+    static void ScanOrdered(const std::vector<ColumnPredicate> &predicates,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet);
+
+    /**
+     * @brief Partition the morsels of the column (kNumTuplesPerMorsel tuples
+     * each, see GetPlannedNumaNode) across the NUMA nodes in contiguous ranges,
+     * so that even a single block is spread over all the nodes, and bind the
+     * pages of every range of every block to its node (moving what is already
+     * loaded). From then on, the scans hand every morsel to a thread on the
+     * node that holds it before letting threads of other nodes help, and
+     * count the bytes scanned locally and remotely.
+     * A Resize that changes the number of morsels drops the placement.
+     */
+    void PlaceOnNumaNodes();
+    bool IsPlacedOnNumaNodes() const { return !morsel_nodes_.empty();}
+    //node of morsel (tuples [morsel, morsel + 1) * kNumTuplesPerMorsel)
+    size_t GetMorselNumaNode(size_t morsel) const { return morsel_nodes_[morsel];}
+    //node PlaceOnNumaNodes binds morsel to, out of num_morsels, on num_nodes
+    //nodes (where the memory ends up if the kernel obeys)
+    static size_t GetPlannedNumaNode(size_t morsel, size_t num_morsels, size_t num_nodes) {
+        return morsel * num_nodes / num_morsels;
+    }
+    //not synchronized with running scans
+    NumaScanStats GetNumaScanStats() const { return {numa_local_bytes_, numa_remote_bytes_};}
+    void ResetNumaScanStats() { numa_local_bytes_ = numa_remote_bytes_ = 0;}
+
+    /**
+     * @brief Run the scans of all columns on the workers of pool instead of
+     * the OpenMP team (nullptr, the default, goes back to OpenMP).
+     * The workers take the morsels of the blocks (per NUMA node if the column
+     * is placed); scans issued from a worker keep using OpenMP.
+     */
+    static void SetWorkerPool(worker_pool_t* pool) { worker_pool_ = pool;}
+    static worker_pool_t* GetWorkerPool() { return worker_pool_;}
 
     ColumnBlock* CreateNewBlock() const;
 
@@ -61,10 +175,27 @@ public:
     ColumnBlock* GetBlock(size_t block_id) const {return blocks_[block_id];}
 
 private:
+    //run scan(block_id, begin, end) on every morsel [begin, end) of the blocks
+    //with all threads (of the worker pool if there is one), by NUMA node if
+    //the first column is placed; a thread takes num_morsels_per_task morsels
+    //(a divisor of the morsels of a block) at a time
+    template <typename Function>
+    static void ScanMorsels(const std::vector<const Column*> &columns, Function scan,
+            size_t num_morsels_per_task = 1);
+
     ColumnType type_;
     size_t bit_width_;
     size_t num_tuples_;
     std::vector<ColumnBlock*> blocks_;
+    //the file mapped by MapFile
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    //set by PlaceOnNumaNodes
+    std::vector<size_t> morsel_nodes_;
+    mutable uint64_t numa_local_bytes_ = 0;
+    mutable uint64_t numa_remote_bytes_ = 0;
+    //set by SetWorkerPool
+    static worker_pool_t* worker_pool_;
 };
 
 
@@ -0,0 +1,601 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include "column_block.h"
+
+#include    <algorithm>
+#include	<cassert>
+#include    <cstdlib>
+#include    <iostream>
+#include    <vector>
+
+#include "avx-utility.h"
+
+namespace byteslice{
+
+static constexpr size_t kConjunctionPrefetchDistance = 512*2;
+
+//one byte slice of a block seen in the common code of a column-column term:
+//byte = (hi << shift) | (lo >> (8 - shift)) of the unflipped slices; missing slices are zero
+struct AlignedSlice{
+    const ByteUnit* hi;
+    const ByteUnit* lo;
+    int shift;
+};
+
+struct ConjunctionMasks{
+    AvxUnit less;
+    AvxUnit greater;
+    AvxUnit equal;
+};
+
+struct ConjunctionTerm;
+
+//kernels of a comparator, resolved once per term (GetConjunctionKernels):
+//kernel compares a byte slice, step loads byte slice byte_id of a term and compares it,
+//result gives the codes that satisfy the term once its byte slices are compared
+struct ConjunctionKernels{
+    void (*kernel)(const AvxUnit &byteslice, const AvxUnit &literal, ConjunctionMasks &m);
+    void (*step)(const ConjunctionTerm &term, size_t byte_id, size_t pos, ConjunctionMasks &m);
+    AvxUnit (*result)(const ConjunctionMasks &m);
+};
+
+//prepared form of one BlockPredicate
+struct ConjunctionTerm{
+    AvxUnit mask_literal[kMaxNumBytesPerCode];
+    const ByteUnit* data[kMaxNumBytesPerCode];
+    AlignedSlice lhs[kMaxNumBytesPerCode];
+    AlignedSlice rhs[kMaxNumBytesPerCode];
+    size_t num_bytes_per_code;
+    ConjunctionKernels kernels;
+};
+
+//same as ByteSliceColumnBlock::ScanKernel
+template <Comparator CMP>
+static inline void ConjunctionKernel(const AvxUnit &byteslice, const AvxUnit &literal,
+                                     ConjunctionMasks &m){
+    switch(CMP){
+        case Comparator::kEqual:
+        case Comparator::kInequal:
+            m.equal = avx_and(m.equal, avx_cmpeq<ByteUnit>(byteslice, literal));
+            break;
+        case Comparator::kLess:
+        case Comparator::kLessEqual:
+            m.less = avx_or(m.less, avx_and(m.equal, avx_cmplt<ByteUnit>(byteslice, literal)));
+            m.equal = avx_and(m.equal, avx_cmpeq<ByteUnit>(byteslice, literal));
+            break;
+        case Comparator::kGreater:
+        case Comparator::kGreaterEqual:
+            m.greater = avx_or(m.greater, avx_and(m.equal, avx_cmpgt<ByteUnit>(byteslice, literal)));
+            m.equal = avx_and(m.equal, avx_cmpeq<ByteUnit>(byteslice, literal));
+            break;
+    }
+}
+
+template <Comparator CMP>
+static inline AvxUnit ConjunctionResult(const ConjunctionMasks &m){
+    switch(CMP){
+        case Comparator::kLessEqual:
+            return avx_or(m.less, m.equal);
+        case Comparator::kLess:
+            return m.less;
+        case Comparator::kGreaterEqual:
+            return avx_or(m.greater, m.equal);
+        case Comparator::kGreater:
+            return m.greater;
+        case Comparator::kEqual:
+            return m.equal;
+        case Comparator::kInequal:
+            return avx_not(m.equal);
+    }
+    return avx_zero();
+}
+
+static inline AvxUnit LoadAlignedSlice(const AlignedSlice &slice, size_t pos){
+    const AvxUnit mask_flip = avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(0)));
+    if(0 == slice.shift){
+        return (nullptr == slice.hi) ? mask_flip : avx_load( (void *)(slice.hi+pos) );
+    }
+    AvxUnit byteslice = avx_zero();
+    if(nullptr != slice.hi){
+        byteslice = avx_slli_bytes(avx_xor(avx_load( (void *)(slice.hi+pos) ), mask_flip), slice.shift);
+    }
+    if(nullptr != slice.lo){
+        byteslice = avx_or(byteslice,
+                avx_srli_bytes(avx_xor(avx_load( (void *)(slice.lo+pos) ), mask_flip), 8 - slice.shift));
+    }
+    return avx_xor(byteslice, mask_flip);
+}
+
+//byte slice byte_id of the term, compared with the literal or, for COLUMN_TERM,
+//with the byte slice of the other block
+template <Comparator CMP, bool COLUMN_TERM>
+static void ConjunctionStep(const ConjunctionTerm &term, size_t byte_id, size_t pos,
+                            ConjunctionMasks &m){
+    if(COLUMN_TERM){
+        ConjunctionKernel<CMP>(LoadAlignedSlice(term.lhs[byte_id], pos),
+                LoadAlignedSlice(term.rhs[byte_id], pos), m);
+    }
+    else{
+        ConjunctionKernel<CMP>(avx_load( (void *)(term.data[byte_id]+pos) ),
+                term.mask_literal[byte_id], m);
+    }
+}
+
+template <Comparator CMP>
+static void GetConjunctionKernels(bool column_term, ConjunctionKernels &kernels){
+    kernels.kernel = ConjunctionKernel<CMP>;
+    kernels.step = column_term ? ConjunctionStep<CMP, true> : ConjunctionStep<CMP, false>;
+    kernels.result = ConjunctionResult<CMP>;
+}
+
+static ConjunctionKernels GetConjunctionKernels(Comparator comparator, bool column_term){
+    ConjunctionKernels kernels;
+    switch(comparator){
+        case Comparator::kLess:
+            GetConjunctionKernels<Comparator::kLess>(column_term, kernels);
+            break;
+        case Comparator::kGreater:
+            GetConjunctionKernels<Comparator::kGreater>(column_term, kernels);
+            break;
+        case Comparator::kLessEqual:
+            GetConjunctionKernels<Comparator::kLessEqual>(column_term, kernels);
+            break;
+        case Comparator::kGreaterEqual:
+            GetConjunctionKernels<Comparator::kGreaterEqual>(column_term, kernels);
+            break;
+        case Comparator::kEqual:
+            GetConjunctionKernels<Comparator::kEqual>(column_term, kernels);
+            break;
+        case Comparator::kInequal:
+            GetConjunctionKernels<Comparator::kInequal>(column_term, kernels);
+            break;
+    }
+    return kernels;
+}
+
+//byte slices of a block (num_bytes, num_padding_bits of right padding) seen as a code
+//of common_bytes with common_padding_bits: code << common_padding_bits == stored << shift
+static void PrepareAlignedSlices(const ColumnBlock* block, size_t num_bytes, size_t num_padding_bits,
+                                 size_t common_bytes, size_t common_padding_bits,
+                                 AlignedSlice* slices){
+    int shift = static_cast<int>(common_padding_bits) - static_cast<int>(num_padding_bits);
+    int shift_bytes = (shift >= 0) ? shift/8 : -((-shift + 7)/8);
+    int shift_bits = shift - 8*shift_bytes;
+    for(int byte_id = 0; byte_id < static_cast<int>(common_bytes); byte_id++){
+        int hi_id = static_cast<int>(num_bytes) - static_cast<int>(common_bytes) + byte_id + shift_bytes;
+        int lo_id = hi_id + 1;
+        slices[byte_id].hi = (0 <= hi_id && hi_id < static_cast<int>(num_bytes)) ?
+                                block->GetByteSlice(hi_id) : nullptr;
+        slices[byte_id].lo = (0 != shift_bits && 0 <= lo_id && lo_id < static_cast<int>(num_bytes)) ?
+                                block->GetByteSlice(lo_id) : nullptr;
+        slices[byte_id].shift = shift_bits;
+    }
+}
+
+template <Bitwise OPT>
+static void ScanConjunctionHelper(const ConjunctionTerm* terms, size_t num_terms,
+                                  size_t num_tuples, BitVectorBlock* bvblock,
+                                  size_t begin, size_t end){
+    size_t max_bytes_per_code = 0;
+    for(size_t t = 0; t < num_terms; t++){
+        max_bytes_per_code = std::max(max_bytes_per_code, terms[t].num_bytes_per_code);
+    }
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit bitvector_word = WordUnit(0);
+        //need several iteration of AVX scan
+        for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
+            ConjunctionMasks m[kMaxNumConjunctionPredicates];
+            AvxUnit m_result = avx_zero();
+            int input_mask = static_cast<int>(-1ULL);
+
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    input_mask = static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+                case Bitwise::kOr:
+                    input_mask = ~static_cast<int>(bvblock->GetWordUnit(bv_word_id) >> i);
+                    break;
+            }
+
+            if((OPT==Bitwise::kSet) || 0 != input_mask){
+                //first byte slice of every column
+                for(size_t t = 0; t < num_terms; t++){
+                    __builtin_prefetch(terms[t].data[0] + offset + i + kConjunctionPrefetchDistance);
+                    m[t].less = avx_zero();
+                    m[t].greater = avx_zero();
+                    m[t].equal = avx_ones();
+                    terms[t].kernels.step(terms[t], 0, offset + i, m[t]);
+                }
+
+                //later byte slices: only while some code is undecided in the whole conjunction
+                for(size_t byte_id = 1; byte_id < max_bytes_per_code; byte_id++){
+                    //codes that no column has rejected yet
+                    AvxUnit m_alive = avx_ones();
+                    AvxUnit m_undecided = avx_zero();
+                    for(size_t t = 0; t < num_terms; t++){
+                        m_alive = avx_and(m_alive,
+                                avx_or(terms[t].kernels.result(m[t]), m[t].equal));
+                        if(byte_id < terms[t].num_bytes_per_code){
+                            m_undecided = avx_or(m_undecided, m[t].equal);
+                        }
+                    }
+                    if(0 == (input_mask & avx_movemask(avx_and(m_undecided, m_alive)))){
+                        break;
+                    }
+                    for(size_t t = 0; t < num_terms; t++){
+                        if(byte_id < terms[t].num_bytes_per_code){
+                            m[t].equal = avx_and(m[t].equal, m_alive);
+                            terms[t].kernels.step(terms[t], byte_id, offset + i, m[t]);
+                        }
+                    }
+                }
+
+                m_result = terms[0].kernels.result(m[0]);
+                for(size_t t = 1; t < num_terms; t++){
+                    m_result = avx_and(m_result, terms[t].kernels.result(m[t]));
+                }
+            }
+            //move mask
+            uint32_t mmask = avx_movemask(m_result);
+            //save in temporary bit vector
+            bitvector_word |= (static_cast<WordUnit>(mmask) << i);
+        }
+        //put result bitvector into bitvector block
+        WordUnit x = bitvector_word;
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bvblock->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bvblock->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblock->SetWordUnit(x, bv_word_id);
+    }
+    if(end == num_tuples){
+        bvblock->ClearTail();
+    }
+}
+
+static inline bool IsByteSliceBlock(const ColumnBlock* block){
+    return ColumnType::kByteSlicePadRight == block->type()
+            || ColumnType::kByteSlicePadLeft == block->type();
+}
+
+static inline size_t RightPaddingBits(const ColumnBlock* block){
+    if(ColumnType::kByteSlicePadLeft == block->type()){
+        return 0;
+    }
+    return CEIL(block->bit_width(), 8) * 8 - block->bit_width();
+}
+
+//byte slices of literal, stored like the codes of a ByteSlice block
+static void PrepareLiteral(const ColumnBlock* block, WordUnit literal, AvxUnit* mask_literal){
+    const size_t num_bytes_per_code = CEIL(block->bit_width(), 8);
+    const size_t num_padding_bits = num_bytes_per_code * 8 - block->bit_width();
+    literal &= CODE_MASK(block->bit_width());
+    if(ColumnType::kByteSlicePadRight == block->type()){
+        literal <<= num_padding_bits;
+    }
+    for(size_t byte_id = 0; byte_id < num_bytes_per_code; byte_id++){
+        ByteUnit byte = FLIP(static_cast<ByteUnit>(literal >> 8*(num_bytes_per_code - 1 - byte_id)));
+        mask_literal[byte_id] = avx_set1<ByteUnit>(byte);
+    }
+}
+
+void ColumnBlock::ScanConjunction(const BlockPredicate* predicates, size_t num_predicates,
+        BitVectorBlock* bvblock, Bitwise bit_opt, size_t begin, size_t end){
+    assert(0 < num_predicates && num_predicates <= kMaxNumConjunctionPredicates);
+    if(!(0 < num_predicates && num_predicates <= kMaxNumConjunctionPredicates)){
+        std::cerr << "[FATAL] Incorrect number of predicates: " << num_predicates << std::endl;
+        exit(1);
+    }
+
+    //Prepare byte-slices of literals
+    ConjunctionTerm terms[kMaxNumConjunctionPredicates];
+    const size_t num_tuples = predicates[0].block->num_tuples();
+    assert(bvblock->num() == num_tuples);
+    end = std::min(end, num_tuples);
+    for(size_t t = 0; t < num_predicates; t++){
+        const ColumnBlock* block = predicates[t].block;
+        const ColumnBlock* other_block = predicates[t].other_block;
+        assert(block->num_tuples() == num_tuples);
+        if(!IsByteSliceBlock(block) || (nullptr != other_block && !IsByteSliceBlock(other_block))){
+            std::cerr << "[FATAL] Conjunction scan needs ByteSlice blocks." << std::endl;
+            exit(1);
+        }
+        terms[t].kernels = GetConjunctionKernels(predicates[t].comparator, nullptr != other_block);
+        if(nullptr != other_block){
+            assert(other_block->num_tuples() == num_tuples);
+            //compare both blocks in the code of the wider one
+            const size_t bit_width = std::max(block->bit_width(), other_block->bit_width());
+            const size_t num_bytes_per_code = CEIL(bit_width, 8);
+            const size_t num_padding_bits = num_bytes_per_code * 8 - bit_width;
+            PrepareAlignedSlices(block, CEIL(block->bit_width(), 8), RightPaddingBits(block),
+                    num_bytes_per_code, num_padding_bits, terms[t].lhs);
+            PrepareAlignedSlices(other_block, CEIL(other_block->bit_width(), 8), RightPaddingBits(other_block),
+                    num_bytes_per_code, num_padding_bits, terms[t].rhs);
+            terms[t].data[0] = block->GetByteSlice(0);
+            terms[t].num_bytes_per_code = num_bytes_per_code;
+            continue;
+        }
+
+        const size_t num_bytes_per_code = CEIL(block->bit_width(), 8);
+        PrepareLiteral(block, predicates[t].literal, terms[t].mask_literal);
+        for(size_t byte_id = 0; byte_id < num_bytes_per_code; byte_id++){
+            terms[t].data[byte_id] = block->GetByteSlice(byte_id);
+        }
+        terms[t].num_bytes_per_code = num_bytes_per_code;
+    }
+
+    switch(bit_opt){
+        case Bitwise::kSet:
+            return ScanConjunctionHelper<Bitwise::kSet>(terms, num_predicates, num_tuples, bvblock,
+                    begin, end);
+        case Bitwise::kAnd:
+            return ScanConjunctionHelper<Bitwise::kAnd>(terms, num_predicates, num_tuples, bvblock,
+                    begin, end);
+        case Bitwise::kOr:
+            return ScanConjunctionHelper<Bitwise::kOr>(terms, num_predicates, num_tuples, bvblock,
+                    begin, end);
+    }
+}
+
+//prepared form of one BlockScanQuery
+struct SharedScanTerm{
+    AvxUnit mask_literal[kMaxNumBytesPerCode];
+    ConjunctionKernels kernels;
+};
+
+//up to kMaxNumSharedScanQueries queries on a ByteSlice block
+static void ScanSharedHelper(const ColumnBlock* block, const SharedScanTerm* terms,
+                             const BlockScanQuery* queries, size_t num_queries,
+                             size_t begin, size_t end){
+    const size_t num_tuples = block->num_tuples();
+    const size_t num_bytes_per_code = CEIL(block->bit_width(), 8);
+    const ByteUnit* data[kMaxNumBytesPerCode];
+    for(size_t byte_id = 0; byte_id < num_bytes_per_code; byte_id++){
+        data[byte_id] = block->GetByteSlice(byte_id);
+    }
+
+    //for every kNumWordBits (64) tuples of the range
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit bitvector_words[kMaxNumSharedScanQueries] = {0};
+        //need several iteration of AVX scan
+        for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
+            ConjunctionMasks m[kMaxNumSharedScanQueries];
+            for(size_t q = 0; q < num_queries; q++){
+                m[q].less = avx_zero();
+                m[q].greater = avx_zero();
+                m[q].equal = avx_ones();
+            }
+
+            //every byte slice is loaded once for all queries,
+            //later ones only while some query has undecided codes
+            __builtin_prefetch(data[0] + offset + i + kConjunctionPrefetchDistance);
+            for(size_t byte_id = 0; byte_id < num_bytes_per_code; byte_id++){
+                if(0 < byte_id){
+                    AvxUnit m_undecided = avx_zero();
+                    for(size_t q = 0; q < num_queries; q++){
+                        m_undecided = avx_or(m_undecided, m[q].equal);
+                    }
+                    if(avx_iszero(m_undecided)){
+                        break;
+                    }
+                }
+                AvxUnit byteslice = avx_load( (void *)(data[byte_id]+offset+i) );
+                for(size_t q = 0; q < num_queries; q++){
+                    if(!avx_iszero(m[q].equal)){
+                        terms[q].kernels.kernel(byteslice, terms[q].mask_literal[byte_id], m[q]);
+                    }
+                }
+            }
+
+            for(size_t q = 0; q < num_queries; q++){
+                //move mask
+                uint32_t mmask = avx_movemask(terms[q].kernels.result(m[q]));
+                //save in temporary bit vector
+                bitvector_words[q] |= (static_cast<WordUnit>(mmask) << i);
+            }
+        }
+        //put result bitvector into the bitvector block of every query
+        for(size_t q = 0; q < num_queries; q++){
+            BitVectorBlock* bvblock = queries[q].bv_block;
+            WordUnit x = bitvector_words[q];
+            switch(queries[q].bit_opt){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    x &= bvblock->GetWordUnit(bv_word_id);
+                    break;
+                case Bitwise::kOr:
+                    x |= bvblock->GetWordUnit(bv_word_id);
+                    break;
+            }
+            bvblock->SetWordUnit(x, bv_word_id);
+        }
+    }
+    for(size_t q = 0; q < num_queries && end == num_tuples; q++){
+        queries[q].bv_block->ClearTail();
+    }
+}
+
+void ColumnBlock::ScanShared(const ColumnBlock* block, const BlockScanQuery* queries,
+        size_t num_queries, size_t begin, size_t end){
+    for(size_t q = 0; q < num_queries; q++){
+        assert(queries[q].bv_block->num() == block->num_tuples());
+    }
+    end = std::min(end, block->num_tuples());
+    if(!IsByteSliceBlock(block)){
+        //no byte slices to share
+        for(size_t q = 0; q < num_queries; q++){
+            block->Scan(queries[q].comparator, queries[q].literal,
+                    queries[q].bv_block, queries[q].bit_opt, begin, end);
+        }
+        return;
+    }
+
+    //Prepare byte-slices of literals, kMaxNumSharedScanQueries queries per pass
+    SharedScanTerm terms[kMaxNumSharedScanQueries];
+    for(size_t first = 0; first < num_queries; first += kMaxNumSharedScanQueries){
+        const size_t num_pass_queries = std::min(kMaxNumSharedScanQueries, num_queries - first);
+        for(size_t q = 0; q < num_pass_queries; q++){
+            PrepareLiteral(block, queries[first + q].literal, terms[q].mask_literal);
+            terms[q].kernels = GetConjunctionKernels(queries[first + q].comparator, false);
+        }
+        ScanSharedHelper(block, terms, queries + first, num_pass_queries, begin, end);
+    }
+}
+
+//selectivity and cost of one predicate on the sample of its block
+struct PredicateEstimate{
+    double selectivity;
+    double num_bytes;       //byte slices touched per segment
+};
+
+static inline bool Compare(Comparator comparator, WordUnit code, WordUnit other){
+    switch(comparator){
+        case Comparator::kEqual:
+            return code == other;
+        case Comparator::kInequal:
+            return code != other;
+        case Comparator::kLess:
+            return code < other;
+        case Comparator::kGreater:
+            return code > other;
+        case Comparator::kLessEqual:
+            return code <= other;
+        case Comparator::kGreaterEqual:
+            return code >= other;
+    }
+    return false;
+}
+
+static PredicateEstimate EstimatePredicate(const BlockPredicate &predicate,
+                                           size_t range_begin, size_t range_end){
+    const ColumnBlock* block = predicate.block;
+    const size_t num_tuples = range_end - range_begin;
+    const size_t bit_width = block->bit_width();
+    const size_t num_bytes_per_code = IsByteSliceBlock(block) ? CEIL(bit_width, 8) : 1;
+    const size_t segment_size = kNumAvxBits/8;
+    const WordUnit literal = predicate.literal & CODE_MASK(bit_width);
+
+    size_t num_sampled = 0;
+    size_t num_passed = 0;
+    size_t num_bytes = 0;
+    const size_t num_segments = std::min(kNumSampleSegments, CEIL(num_tuples, segment_size));
+    for(size_t s = 0; s < num_segments; s++){
+        size_t begin = range_begin + (s * num_tuples / num_segments) / segment_size * segment_size;
+        size_t end = std::min(begin + segment_size, range_end);
+        //the segment loads byte slices until its last undecided code is decided
+        size_t segment_bytes = 1;
+        for(size_t pos = begin; pos < end; pos++){
+            WordUnit code = block->GetTuple(pos);
+            WordUnit other = (nullptr == predicate.other_block) ?
+                                literal : predicate.other_block->GetTuple(pos);
+            num_passed += Compare(predicate.comparator, code, other);
+            num_sampled++;
+            WordUnit diff = code ^ other;
+            size_t code_bytes = num_bytes_per_code;
+            for(size_t byte_id = 0; byte_id < num_bytes_per_code; byte_id++){
+                if(0 != (diff >> (bit_width - std::min(bit_width, 8*(byte_id + 1))))){
+                    code_bytes = byte_id + 1;
+                    break;
+                }
+            }
+            segment_bytes = std::max(segment_bytes, code_bytes);
+        }
+        num_bytes += segment_bytes;
+    }
+
+    PredicateEstimate estimate;
+    estimate.selectivity = (0 == num_sampled) ? 1.0 : static_cast<double>(num_passed) / num_sampled;
+    estimate.num_bytes = (0 == num_segments) ? 1.0 : static_cast<double>(num_bytes) / num_segments;
+    return estimate;
+}
+
+void ColumnBlock::ScanOrdered(const BlockPredicate* predicates, size_t num_predicates,
+        BitVectorBlock* bvblock, Bitwise bit_opt, size_t* order, size_t begin, size_t end){
+    assert(0 < num_predicates && num_predicates <= kMaxNumConjunctionPredicates);
+    if(!(0 < num_predicates && num_predicates <= kMaxNumConjunctionPredicates)){
+        std::cerr << "[FATAL] Incorrect number of predicates: " << num_predicates << std::endl;
+        exit(1);
+    }
+    end = std::min(end, predicates[0].block->num_tuples());
+    if(begin >= end){
+        return;
+    }
+    if(Bitwise::kOr == bit_opt){
+        //the conjunction is put in place, then or-ed with the words it replaced
+        const size_t first_word = begin / kNumWordBits;
+        std::vector<WordUnit> words(CEIL(end, kNumWordBits) - first_word);
+        for(size_t i = 0; i < words.size(); i++){
+            words[i] = bvblock->GetWordUnit(first_word + i);
+        }
+        ScanOrdered(predicates, num_predicates, bvblock, Bitwise::kSet, order, begin, end);
+        for(size_t i = 0; i < words.size(); i++){
+            bvblock->SetWordUnit(bvblock->GetWordUnit(first_word + i) | words[i], first_word + i);
+        }
+        return;
+    }
+
+    for(size_t p = 0; p < num_predicates; p++){
+        const ColumnBlock* block = predicates[p].block;
+        const ColumnBlock* other_block = predicates[p].other_block;
+        if(nullptr != other_block && (block->type() != other_block->type()
+                    || block->bit_width() != other_block->bit_width())){
+            std::cerr << "[FATAL] Column-column term of predicate " << p
+                << " needs blocks of the same type and bit width" << std::endl;
+            exit(1);
+        }
+    }
+
+    //the data may drift along the block: every piece has its own order
+    for(size_t piece_begin = begin, piece_end; piece_begin < end; piece_begin = piece_end){
+        piece_end = std::min(end, (piece_begin / kNumTuplesPerEstimate + 1) * kNumTuplesPerEstimate);
+
+        //rank: cost per filtered code, a predicate that filters nothing goes last
+        double rank[kMaxNumConjunctionPredicates];
+        size_t order_local[kMaxNumConjunctionPredicates];
+        for(size_t p = 0; p < num_predicates; p++){
+            PredicateEstimate estimate = EstimatePredicate(predicates[p], piece_begin, piece_end);
+            rank[p] = (estimate.selectivity < 1.0) ?
+                        estimate.num_bytes / (1.0 - estimate.selectivity) : 1e300;
+            order_local[p] = p;
+        }
+        std::stable_sort(order_local, order_local + num_predicates,
+                [&rank](size_t a, size_t b){ return rank[a] < rank[b]; });
+
+        for(size_t k = 0; k < num_predicates; k++){
+            const BlockPredicate &predicate = predicates[order_local[k]];
+            Bitwise opt = (0 == k) ? bit_opt : Bitwise::kAnd;
+            if(nullptr == predicate.other_block){
+                predicate.block->Scan(predicate.comparator, predicate.literal, bvblock, opt,
+                        piece_begin, piece_end);
+            }
+            else{
+                predicate.block->Scan(predicate.comparator, predicate.other_block, bvblock, opt,
+                        piece_begin, piece_end);
+            }
+            if(nullptr != order && piece_begin == begin){
+                order[k] = order_local[k];
+            }
+        }
+    }
+}
+
+}   // namespace
@@ -17,6 +17,33 @@
 
 namespace byteslice{
 
+class ColumnBlock;
+
+//one term of a conjunction, see ColumnBlock::ScanConjunction
+//block compared with literal, or with other_block if it is not nullptr
+struct BlockPredicate{
+    const ColumnBlock* block;
+    Comparator comparator;
+    WordUnit literal;
+    const ColumnBlock* other_block;
+};
+
+//one query of a shared scan, see ColumnBlock::ScanShared
+//block compared with literal, the result put into bv_block with bit_opt
+//(kSet if omitted)
+struct BlockScanQuery{
+    Comparator comparator;
+    WordUnit literal;
+    BitVectorBlock* bv_block;
+    Bitwise bit_opt;
+};
+
+/**
+ * The scans (and GetTuples of a bit vector) of a block evaluate its tuples
+ * [begin, end) only, the whole block by default: begin is a multiple of 64
+ * (one word of the bit vector) and end is cut to the block. They run on the
+ * calling thread; Column spreads the morsels of its blocks over the threads.
+ */
 class ColumnBlock{
 public:
     virtual ~ColumnBlock(){
@@ -24,13 +51,73 @@ public:
 
     virtual WordUnit GetTuple(size_t pos_in_block) const = 0;
     virtual void SetTuple(size_t pos_in_block, WordUnit value) = 0;
-    virtual void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet) const = 0;
-    virtual void Scan(Comparator comparator, const ColumnBlock* column_block, BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet) const = 0;
+    //materialize the codes at the given positions into codes
+    virtual void GetTuples(const uint32_t* positions, size_t num, WordUnit* codes) const = 0;
+    //materialize the codes of [begin, end) whose bit is set in bv_block into codes
+    //(in position order); return the number of codes
+    virtual size_t GetTuples(const BitVectorBlock* bv_block, WordUnit* codes,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const = 0;
+    virtual void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const = 0;
+    virtual void Scan(Comparator comparator, const ColumnBlock* column_block, BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const = 0;
+    //IN-list: code equals any of the literals
+    virtual void ScanIn(const WordUnit* literals, size_t num_literals, BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const = 0;
+    //range: comparator_lo is kGreater/kGreaterEqual, comparator_hi is kLess/kLessEqual
+    virtual void ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+            Comparator comparator_hi, WordUnit literal_hi,
+            BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const = 0;
     virtual void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) = 0;
     virtual void SerToFile(SequentialWriteBinaryFile &file) const = 0;
     virtual void DeserFromFile(const SequentialReadBinaryFile &file) = 0;
     virtual bool Resize(size_t size) = 0;
 
+    //raw (flipped) byte slice of ByteSlice blocks; nullptr for other layouts
+    virtual const ByteUnit* GetByteSlice(size_t byte_id) const = 0;
+
+    //raw memory of the block: the byte slices of ByteSlice blocks,
+    //the array of naive blocks
+    virtual size_t GetNumBuffers() const = 0;
+    virtual size_t GetBufferSize() const = 0;
+    virtual const ByteUnit* GetBuffer(size_t buffer_id) const = 0;
+    //use buffers owned by someone else (e.g., mapped from a column file)
+    //instead of the memory of the block, which is freed
+    virtual void AttachBuffers(ByteUnit* const* buffers, size_t num) = 0;
+
+    /**
+     * @brief Evaluate the conjunction of all predicates in one pass.
+     * All blocks must be ByteSlice blocks of the same number of tuples.
+     * Two blocks of one column-column term may differ in bit width.
+     * Later byte slices are only loaded while some code is undecided in
+     * the whole conjunction.
+     */
+    static void ScanConjunction(const BlockPredicate* predicates, size_t num_predicates,
+            BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock);
+
+    /**
+     * @brief Evaluate the conjunction predicate by predicate (Scan with kAnd).
+     * The range is cut at every kNumTuplesPerEstimate tuples of the block; on
+     * each piece, selectivity and number of byte slices touched per segment are
+     * estimated for every predicate on kNumSampleSegments segments spread over
+     * the piece, and the predicates are run in increasing cost per filtered code.
+     * If order is not nullptr, it receives the order chosen for the first piece.
+     */
+    static void ScanOrdered(const BlockPredicate* predicates, size_t num_predicates,
+            BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet, size_t* order=nullptr,
+            size_t begin=0, size_t end=kNumTuplesPerBlock);
+
+    /**
+     * @brief Evaluate the predicates of many queries on block in one pass,
+     * one bit vector block per query. Every byte slice is loaded once for all
+     * the queries, and later byte slices only while some query still has
+     * undecided codes. Blocks of other layouts are scanned query by query.
+     */
+    static void ScanShared(const ColumnBlock* block, const BlockScanQuery* queries,
+            size_t num_queries, size_t begin=0, size_t end=kNumTuplesPerBlock);
+
     //accessors
     ColumnType type() const;
     size_t bit_width() const;
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef COLUMN_FILE_H
+#define COLUMN_FILE_H
+
+#include    <cstdint>
+
+#include "../src/param.h"
+
+namespace byteslice{
+
+/**
+  On-disk format of a column, written by Column::WriteFile and memory-mapped
+  by Column::MapFile:
+
+    ColumnFileHeader
+    ColumnFileBlock[num_blocks]
+    buffers (byte slices, or the array of a naive block), each at an offset
+    aligned to kColumnFileAlignment, so it can be mapped with huge pages;
+    only the codes of a block are written, the rest of a buffer (up to
+    buffer_size) is a hole in the file and reads as zeros
+
+  Integers are in the byte order of the machine. A reader accepts a file only
+  if version and num_tuples_per_block match its own.
+*/
+constexpr char kColumnFileMagic[8] = {'B', 'S', 'L', 'I', 'C', 'E', 'C', 'F'};
+constexpr uint32_t kColumnFileVersion = 1;
+constexpr uint64_t kColumnFileAlignment = 2*1024*1024;
+
+struct ColumnFileHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t type;                  //ColumnType
+    uint64_t bit_width;
+    uint64_t num_tuples;
+    uint64_t num_blocks;
+    uint64_t num_tuples_per_block;  //kNumTuplesPerBlock of the writer
+    uint64_t buffer_size;           //bytes per buffer
+};
+
+struct ColumnFileBlock{
+    uint64_t num_tuples;
+    uint64_t num_buffers;
+    uint64_t offsets[kMaxNumBytesPerCode];  //from the start of the file
+};
+
+}   // namespace
+
+#endif  //COLUMN_FILE_H
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include "cpu_dispatch.h"
+
+#include    <cstdlib>
+#include    <cstring>
+
+namespace byteslice{
+
+bool CpuSupports(SimdIsa isa){
+    __builtin_cpu_init();
+    switch(isa){
+        case SimdIsa::kAvx2:
+            return __builtin_cpu_supports("avx2");
+        case SimdIsa::kAvx512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+    return false;
+}
+
+static SimdIsa DetectSimdIsa(){
+    const char* name = std::getenv("BYTESLICE_SIMD");
+    if(nullptr == name){
+        return CpuSupports(SimdIsa::kAvx512) ? SimdIsa::kAvx512 : SimdIsa::kAvx2;
+    }
+
+    SimdIsa isa;
+    if(0 == std::strcmp(name, "avx2")){
+        isa = SimdIsa::kAvx2;
+    }
+    else if(0 == std::strcmp(name, "avx512")){
+        isa = SimdIsa::kAvx512;
+    }
+    else{
+        std::cerr << "[FATAL] Unknown BYTESLICE_SIMD: " << name << std::endl;
+        exit(1);
+    }
+    if(!CpuSupports(isa)){
+        std::cerr << "[FATAL] BYTESLICE_SIMD=" << name
+            << " is not supported by this CPU" << std::endl;
+        exit(1);
+    }
+    return isa;
+}
+
+static SimdIsa& CurrentSimdIsa(){
+    static SimdIsa isa = DetectSimdIsa();
+    return isa;
+}
+
+SimdIsa GetSimdIsa(){
+    return CurrentSimdIsa();
+}
+
+void SetSimdIsa(SimdIsa isa){
+    if(!CpuSupports(isa)){
+        std::cerr << "[FATAL] " << isa << " is not supported by this CPU" << std::endl;
+        exit(1);
+    }
+    CurrentSimdIsa() = isa;
+}
+
+std::ostream& operator<< (std::ostream &out, SimdIsa isa){
+    switch(isa){
+        case SimdIsa::kAvx2:
+            out << "AVX2";
+            break;
+        case SimdIsa::kAvx512:
+            out << "AVX-512";
+            break;
+    }
+    return out;
+}
+
+}   // namespace
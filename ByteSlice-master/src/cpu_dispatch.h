@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include    <iostream>
+
+namespace byteslice{
+
+/**
+ * Run-time choice of the literal scan kernels.
+ *
+ * Only ByteSliceColumnBlock::Scan against a literal switches between
+ * AVX2 and AVX-512 at run time. ScanIn, ScanBetween, column-column Scan,
+ * GetTuples, BulkLoadArray and the conjunction/shared scans of Column
+ * always run their AVX2 kernels. The library is built with -mavx2, so
+ * AVX2 is the minimum CPU; there is no SSE level, and the 128-bit
+ * AvxUnit of types.h stays a compile-time choice.
+ */
+enum class SimdIsa{
+    kAvx2,
+    kAvx512
+};
+
+/**
+ * @brief The instruction set used by the literal scan kernels.
+ * At first use, the best one the CPU supports (cpuid), unless the
+ * environment variable BYTESLICE_SIMD is set to "avx2" or "avx512".
+ */
+SimdIsa GetSimdIsa();
+
+/**
+ * @brief Override the instruction set, e.g., for benchmarking.
+ * Not thread-safe: call it between scans.
+ */
+void SetSimdIsa(SimdIsa isa);
+
+bool CpuSupports(SimdIsa isa);
+
+std::ostream& operator<< (std::ostream &out, SimdIsa isa);
+
+}   // namespace
+
+#endif  //CPU_DISPATCH_H
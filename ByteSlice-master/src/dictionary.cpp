@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include "dictionary.h"
+
+#include    <algorithm>
+#include    <cassert>
+#include    <cstdlib>
+#include    <iostream>
+#include    <iterator>
+#include    <omp.h>
+
+#include "../src/param.h"
+
+namespace byteslice{
+
+typedef std::vector<std::string> Strings;
+
+static void SortUnique(Strings* strings){
+    std::sort(strings->begin(), strings->end());
+    strings->erase(std::unique(strings->begin(), strings->end()), strings->end());
+}
+
+Dictionary::Dictionary(const std::vector<std::string> &values){
+    if(values.empty()){
+        std::cerr << "[FATAL] Empty dictionary." << std::endl;
+        exit(1);
+    }
+    const size_t num = values.size();
+    const size_t num_runs = std::max<size_t>(1, std::min<size_t>(
+                omp_get_max_threads(), num / kMinNumStringsPerSortRun));
+
+    //1. sort the runs
+    std::vector<Strings> runs(num_runs);
+#   pragma omp parallel for schedule(static, 1)
+    for(size_t r = 0; r < num_runs; r++){
+        runs[r].assign(values.begin() + num * r / num_runs,
+                values.begin() + num * (r + 1) / num_runs);
+        SortUnique(&runs[r]);
+    }
+
+    //2. sample num_runs strings of every run for num_runs-1 splitters
+    Strings samples;
+    for(const Strings &run : runs){
+        for(size_t k = 0; k < num_runs; k++){
+            samples.push_back(run[run.size() * (2 * k + 1) / (2 * num_runs)]);
+        }
+    }
+    std::sort(samples.begin(), samples.end());
+    Strings splitters;
+    for(size_t p = 1; p < num_runs; p++){
+        splitters.push_back(samples[samples.size() * p / num_runs]);
+    }
+
+    //bounds[r][p]: where partition p starts in run r
+    std::vector<std::vector<size_t>> bounds(num_runs);
+    for(size_t r = 0; r < num_runs; r++){
+        bounds[r].push_back(0);
+        for(const std::string &splitter : splitters){
+            bounds[r].push_back(std::lower_bound(runs[r].begin(), runs[r].end(), splitter)
+                    - runs[r].begin());
+        }
+        bounds[r].push_back(runs[r].size());
+    }
+
+    //3. merge the pieces of every partition; equal strings are in the same partition
+    std::vector<Strings> partitions(num_runs);
+#   pragma omp parallel for schedule(dynamic, 1)
+    for(size_t p = 0; p < num_runs; p++){
+        Strings &partition = partitions[p];
+        std::vector<size_t> offsets(1, 0);
+        for(size_t r = 0; r < num_runs; r++){
+            partition.insert(partition.end(),
+                    std::make_move_iterator(runs[r].begin() + bounds[r][p]),
+                    std::make_move_iterator(runs[r].begin() + bounds[r][p + 1]));
+            offsets.push_back(partition.size());
+        }
+        for(size_t width = 1; width < num_runs; width *= 2){
+            for(size_t i = 0; i + width < num_runs; i += 2 * width){
+                std::inplace_merge(partition.begin() + offsets[i],
+                        partition.begin() + offsets[i + width],
+                        partition.begin() + offsets[std::min(i + 2 * width, num_runs)]);
+            }
+        }
+        partition.erase(std::unique(partition.begin(), partition.end()), partition.end());
+    }
+
+    //4. concatenate the partitions
+    std::vector<size_t> starts(num_runs + 1, 0);
+    for(size_t p = 0; p < num_runs; p++){
+        starts[p + 1] = starts[p] + partitions[p].size();
+    }
+    words_.resize(starts[num_runs]);
+#   pragma omp parallel for schedule(static, 1)
+    for(size_t p = 0; p < num_runs; p++){
+        std::move(partitions[p].begin(), partitions[p].end(), words_.begin() + starts[p]);
+    }
+
+    const uint64_t max_code = words_.size() - 1;
+    bit_width_ = (0 == max_code) ? 1 : 64 - __builtin_clzll(max_code);
+}
+
+WordUnit Dictionary::Encode(const std::string &value) const{
+    auto it = std::lower_bound(words_.begin(), words_.end(), value);
+    if(words_.end() == it || *it != value){
+        std::cerr << "[FATAL] Not in the dictionary: " << value << std::endl;
+        exit(1);
+    }
+    return it - words_.begin();
+}
+
+void Dictionary::EncodeArray(const std::vector<std::string> &values, WordUnit* codes) const{
+#   pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < values.size(); i++){
+        codes[i] = Encode(values[i]);
+    }
+}
+
+const std::string& Dictionary::Decode(WordUnit code) const{
+    assert(code < words_.size());
+    return words_[code];
+}
+
+//Codes compared with 0 or the largest code stand for "none" and "all":
+//(kLess, 0) and (kGreater, max) are never true,
+//(kGreaterEqual, 0) and (kLessEqual, max) are always true.
+void Dictionary::TranslatePosition(Comparator comparator, size_t position, bool exact,
+        Comparator* code_comparator, WordUnit* code_literal) const{
+    const WordUnit max_code = words_.size() - 1;
+    //exact: code comparator position; otherwise the literal falls just below position
+    if(!exact && Comparator::kLessEqual == comparator){
+        comparator = Comparator::kLess;
+    }
+    if(!exact && Comparator::kGreater == comparator){
+        comparator = Comparator::kGreaterEqual;
+    }
+
+    switch(comparator){
+        case Comparator::kLess:
+            *code_comparator = (position > max_code) ? Comparator::kLessEqual : Comparator::kLess;
+            *code_literal = std::min(position, max_code);
+            break;
+        case Comparator::kGreaterEqual:
+            *code_comparator = (position > max_code) ? Comparator::kGreater : Comparator::kGreaterEqual;
+            *code_literal = std::min(position, max_code);
+            break;
+        case Comparator::kLessEqual:
+        case Comparator::kGreater:
+            *code_comparator = comparator;
+            *code_literal = position;
+            break;
+        case Comparator::kEqual:
+            *code_comparator = exact ? Comparator::kEqual : Comparator::kLess;
+            *code_literal = exact ? position : 0;
+            break;
+        case Comparator::kInequal:
+            *code_comparator = exact ? Comparator::kInequal : Comparator::kGreaterEqual;
+            *code_literal = exact ? position : 0;
+            break;
+    }
+}
+
+void Dictionary::Translate(Comparator comparator, const std::string &literal,
+        Comparator* code_comparator, WordUnit* code_literal) const{
+    const size_t position = std::lower_bound(words_.begin(), words_.end(), literal)
+        - words_.begin();
+    const bool exact = position < words_.size() && words_[position] == literal;
+    TranslatePosition(comparator, position, exact, code_comparator, code_literal);
+}
+
+void Dictionary::TranslatePrefix(const std::string &prefix,
+        Comparator* comparator_lo, WordUnit* literal_lo,
+        Comparator* comparator_hi, WordUnit* literal_hi) const{
+    //the strings with the prefix are the codes in [lo, hi)
+    auto lo = std::lower_bound(words_.begin(), words_.end(), prefix);
+    auto hi = std::partition_point(lo, words_.end(),
+            [&prefix](const std::string &word){
+                return 0 == word.compare(0, prefix.size(), prefix);
+            });
+    TranslatePosition(Comparator::kGreaterEqual, lo - words_.begin(), false,
+            comparator_lo, literal_lo);
+    TranslatePosition(Comparator::kLess, hi - words_.begin(), false,
+            comparator_hi, literal_hi);
+}
+
+}   // namespace
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include    <string>
+#include    <vector>
+
+#include "../src/types.h"
+
+namespace byteslice{
+
+/**
+  Order-preserving dictionary of a string column: the distinct strings are
+  sorted and numbered 0, 1, ..., so a < b iff Encode(a) < Encode(b) and
+  the codes fit in bit_width() bits.
+  Literals, ranges and prefixes are translated into predicates on the codes.
+*/
+class Dictionary{
+public:
+    /**
+     * @brief Build the dictionary of values in parallel: every thread sorts
+     * a run, the runs are split at sampled splitters, and each partition is
+     * merged by one thread.
+     */
+    explicit Dictionary(const std::vector<std::string> &values);
+
+    //strings not in the dictionary are fatal
+    WordUnit Encode(const std::string &value) const;
+    void EncodeArray(const std::vector<std::string> &values, WordUnit* codes) const;
+    const std::string& Decode(WordUnit code) const;
+
+    /**
+     * @brief Translate "value comparator literal" into a predicate on the codes.
+     * Literals not in the dictionary adjust the comparator, so the result is exact.
+     * kLess/kLessEqual stay kLess/kLessEqual and kGreater/kGreaterEqual stay
+     * kGreater/kGreaterEqual, so the translated bounds of a range still form a range.
+     */
+    void Translate(Comparator comparator, const std::string &literal,
+            Comparator* code_comparator, WordUnit* code_literal) const;
+
+    /**
+     * @brief Translate "value LIKE 'prefix%'" into the range
+     * code comparator_lo literal_lo AND code comparator_hi literal_hi.
+     */
+    void TranslatePrefix(const std::string &prefix,
+            Comparator* comparator_lo, WordUnit* literal_lo,
+            Comparator* comparator_hi, WordUnit* literal_hi) const;
+
+    //accessors
+    size_t size() const;
+    size_t bit_width() const;
+
+private:
+    //codes comparator position, where position is the first code not below
+    //the literal and exact if that code is the literal
+    void TranslatePosition(Comparator comparator, size_t position, bool exact,
+            Comparator* code_comparator, WordUnit* code_literal) const;
+
+    std::vector<std::string> words_;    //sorted and distinct
+    size_t bit_width_;
+};
+
+inline size_t Dictionary::size() const{
+    return words_.size();
+}
+
+inline size_t Dictionary::bit_width() const{
+    return bit_width_;
+}
+
+}   // namespace
+
+#endif  //DICTIONARY_H
@@ -0,0 +1,353 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include "encoder.h"
+
+#include    <algorithm>
+#include    <cassert>
+#include    <cmath>
+#include    <cstdlib>
+#include    <cstring>
+#include    <limits>
+
+namespace byteslice{
+
+static constexpr uint64_t kSignBit = 1ULL << 63;
+
+//decimals are scaled into int64_t
+static constexpr size_t kMaxDecimalScale = 18;
+
+//a decimal literal within this relative distance of a multiple of 10^-scale
+//is that multiple: 0.05*100 is 5.000000000000001 in double
+static constexpr double kDecimalTolerance = 1e-9;
+
+//int64_t as a double is in [-2^63, 2^63)
+static constexpr double kInt64Bound = 9223372036854775808.0;
+
+static uint64_t FloatKey(double value){
+    if(std::isnan(value)){
+        std::cerr << "[FATAL] NaN has no order-preserving code." << std::endl;
+        exit(1);
+    }
+    if(0.0 == value){
+        value = 0.0;    //-0.0 == 0.0
+    }
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    //negative: all bits flipped; positive: above all negatives
+    return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+}
+
+static double FloatFromKey(uint64_t key){
+    uint64_t bits = (key & kSignBit) ? (key ^ kSignBit) : ~key;
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static size_t BitWidth(uint64_t range){
+    return (0 == range) ? 1 : 64 - __builtin_clzll(range);
+}
+
+Encoder::Encoder(ValueType type, size_t scale, uint64_t min_key, uint64_t max_key):
+    type_(type), scale_(scale), multiplier_(std::pow(10.0, scale)),
+    min_key_(min_key), max_key_(max_key), bit_width_(BitWidth(max_key - min_key)){
+    if(min_key > max_key){
+        std::cerr << "[FATAL] Empty value range of the encoder." << std::endl;
+        exit(1);
+    }
+}
+
+Encoder Encoder::Integer(int64_t min, int64_t max){
+    return Encoder(ValueType::kInteger, 0,
+            static_cast<uint64_t>(min) ^ kSignBit, static_cast<uint64_t>(max) ^ kSignBit);
+}
+
+Encoder Encoder::Decimal(size_t scale, double min, double max){
+    if(scale > kMaxDecimalScale){
+        std::cerr << "[FATAL] Incorrect decimal scale: " << scale << std::endl;
+        exit(1);
+    }
+    const double multiplier = std::pow(10.0, scale);
+    if(!(std::fabs(min * multiplier) < kInt64Bound && std::fabs(max * multiplier) < kInt64Bound)){
+        std::cerr << "[FATAL] Decimal range exceeds 64 bits." << std::endl;
+        exit(1);
+    }
+    return Encoder(ValueType::kDecimal, scale,
+            static_cast<uint64_t>(std::llround(min * multiplier)) ^ kSignBit,
+            static_cast<uint64_t>(std::llround(max * multiplier)) ^ kSignBit);
+}
+
+Encoder Encoder::DecimalScaled(size_t scale, int64_t min_scaled, int64_t max_scaled){
+    if(scale > kMaxDecimalScale){
+        std::cerr << "[FATAL] Incorrect decimal scale: " << scale << std::endl;
+        exit(1);
+    }
+    return Encoder(ValueType::kDecimal, scale,
+            static_cast<uint64_t>(min_scaled) ^ kSignBit,
+            static_cast<uint64_t>(max_scaled) ^ kSignBit);
+}
+
+Encoder Encoder::Float(double min, double max){
+    return Encoder(ValueType::kFloat, 0, FloatKey(min), FloatKey(max));
+}
+
+uint64_t Encoder::IntegerKey(int64_t value) const{
+    return static_cast<uint64_t>(value) ^ kSignBit;
+}
+
+WordUnit Encoder::EncodeInteger(int64_t value) const{
+    uint64_t key = 0;
+    switch(type_){
+        case ValueType::kInteger:
+            key = IntegerKey(value);
+            break;
+        case ValueType::kDecimal:{
+            int64_t scaled;
+            int64_t multiplier = std::llround(multiplier_);
+            if(__builtin_mul_overflow(value, multiplier, &scaled)){
+                std::cerr << "[FATAL] Value out of range: " << value << std::endl;
+                exit(1);
+            }
+            key = IntegerKey(scaled);
+            break;
+        }
+        case ValueType::kFloat:
+            return EncodeReal(static_cast<double>(value));
+    }
+    if(key < min_key_ || key > max_key_){
+        std::cerr << "[FATAL] Value out of range: " << value << std::endl;
+        exit(1);
+    }
+    return key - min_key_;
+}
+
+WordUnit Encoder::EncodeReal(double value) const{
+    if(std::isnan(value)){
+        std::cerr << "[FATAL] NaN has no order-preserving code." << std::endl;
+        exit(1);
+    }
+    uint64_t key = 0;
+    switch(type_){
+        case ValueType::kInteger:
+            if(std::floor(value) != value || !(std::fabs(value) < kInt64Bound)){
+                std::cerr << "[FATAL] Not a 64-bit integer: " << value << std::endl;
+                exit(1);
+            }
+            return EncodeInteger(static_cast<int64_t>(value));
+        case ValueType::kDecimal:
+            if(!(std::fabs(value * multiplier_) < kInt64Bound)){
+                std::cerr << "[FATAL] Value out of range: " << value << std::endl;
+                exit(1);
+            }
+            key = IntegerKey(std::llround(value * multiplier_));
+            break;
+        case ValueType::kFloat:
+            key = FloatKey(value);
+            break;
+    }
+    if(key < min_key_ || key > max_key_){
+        std::cerr << "[FATAL] Value out of range: " << value << std::endl;
+        exit(1);
+    }
+    return key - min_key_;
+}
+
+WordUnit Encoder::EncodeScaled(int64_t scaled) const{
+    assert(ValueType::kDecimal == type_);
+    const uint64_t key = IntegerKey(scaled);
+    if(key < min_key_ || key > max_key_){
+        std::cerr << "[FATAL] Value out of range: " << scaled << " * 10^-" << scale_ << std::endl;
+        exit(1);
+    }
+    return key - min_key_;
+}
+
+int64_t Encoder::DecodeInteger(WordUnit code) const{
+    if(ValueType::kInteger != type_){
+        std::cerr << "[FATAL] Codes of type " << type_ << " are not integers." << std::endl;
+        exit(1);
+    }
+    return static_cast<int64_t>((code + min_key_) ^ kSignBit);
+}
+
+double Encoder::DecodeReal(WordUnit code) const{
+    uint64_t key = code + min_key_;
+    switch(type_){
+        case ValueType::kInteger:
+            return static_cast<double>(static_cast<int64_t>(key ^ kSignBit));
+        case ValueType::kDecimal:
+            return static_cast<double>(static_cast<int64_t>(key ^ kSignBit)) / multiplier_;
+        case ValueType::kFloat:
+            return FloatFromKey(key);
+    }
+    return 0.0;
+}
+
+void Encoder::FloorKey(double literal, uint64_t* key, bool* exact, bool* below) const{
+    if(std::isnan(literal)){
+        std::cerr << "[FATAL] NaN has no order-preserving code." << std::endl;
+        exit(1);
+    }
+    *below = false;
+    if(ValueType::kFloat == type_){
+        *key = FloatKey(literal);
+        *exact = true;
+        return;
+    }
+
+    double x = literal;
+    if(ValueType::kDecimal == type_){
+        x = literal * multiplier_;
+        double nearest = std::nearbyint(x);
+        if(std::fabs(x - nearest) <= kDecimalTolerance * std::max(1.0, std::fabs(x))){
+            x = nearest;
+        }
+    }
+    if(x < -kInt64Bound){
+        *below = true;
+        *exact = false;
+    }
+    else if(x >= kInt64Bound){
+        *key = IntegerKey(std::numeric_limits<int64_t>::max());
+        *exact = false;
+    }
+    else{
+        double floor = std::floor(x);
+        *key = IntegerKey(static_cast<int64_t>(floor));
+        *exact = (floor == x);
+    }
+}
+
+//Codes compared with 0 or the largest code stand for "none" and "all":
+//(kLess, 0) and (kGreater, max) are never true,
+//(kGreaterEqual, 0) and (kLessEqual, max) are always true.
+void Encoder::Translate(Comparator comparator, uint64_t floor_key, bool exact, bool below,
+        Comparator* code_comparator, WordUnit* code_literal) const{
+    const WordUnit max_code = max_key_ - min_key_;
+    //the smallest key not below the literal is floor_key (exact) or floor_key + 1
+    const bool ceil_below_min = below || (exact ? floor_key <= min_key_ : floor_key < min_key_);
+    const bool ceil_above_max = !below && (exact ? floor_key > max_key_ : floor_key >= max_key_);
+    const bool floor_below_min = below || floor_key < min_key_;
+    const bool floor_above_max = !below && floor_key >= max_key_;
+    const bool representable = exact && !below && min_key_ <= floor_key && floor_key <= max_key_;
+
+    switch(comparator){
+        case Comparator::kLess:
+            if(ceil_below_min){
+                *code_comparator = Comparator::kLess;
+                *code_literal = 0;
+            }
+            else if(ceil_above_max){
+                *code_comparator = Comparator::kLessEqual;
+                *code_literal = max_code;
+            }
+            else{
+                *code_comparator = Comparator::kLess;
+                *code_literal = floor_key + (exact ? 0 : 1) - min_key_;
+            }
+            break;
+        case Comparator::kLessEqual:
+            if(floor_below_min){
+                *code_comparator = Comparator::kLess;
+                *code_literal = 0;
+            }
+            else if(floor_above_max){
+                *code_comparator = Comparator::kLessEqual;
+                *code_literal = max_code;
+            }
+            else{
+                *code_comparator = Comparator::kLessEqual;
+                *code_literal = floor_key - min_key_;
+            }
+            break;
+        case Comparator::kGreater:
+            if(floor_below_min){
+                *code_comparator = Comparator::kGreaterEqual;
+                *code_literal = 0;
+            }
+            else if(floor_above_max){
+                *code_comparator = Comparator::kGreater;
+                *code_literal = max_code;
+            }
+            else{
+                *code_comparator = Comparator::kGreater;
+                *code_literal = floor_key - min_key_;
+            }
+            break;
+        case Comparator::kGreaterEqual:
+            if(ceil_below_min){
+                *code_comparator = Comparator::kGreaterEqual;
+                *code_literal = 0;
+            }
+            else if(ceil_above_max){
+                *code_comparator = Comparator::kGreater;
+                *code_literal = max_code;
+            }
+            else{
+                *code_comparator = Comparator::kGreaterEqual;
+                *code_literal = floor_key + (exact ? 0 : 1) - min_key_;
+            }
+            break;
+        case Comparator::kEqual:
+            *code_comparator = representable ? Comparator::kEqual : Comparator::kLess;
+            *code_literal = representable ? floor_key - min_key_ : 0;
+            break;
+        case Comparator::kInequal:
+            *code_comparator = representable ? Comparator::kInequal : Comparator::kGreaterEqual;
+            *code_literal = representable ? floor_key - min_key_ : 0;
+            break;
+    }
+}
+
+void Encoder::TranslateInteger(Comparator comparator, int64_t literal,
+        Comparator* code_comparator, WordUnit* code_literal) const{
+    int64_t scaled;
+    switch(type_){
+        case ValueType::kInteger:
+            return Translate(comparator, IntegerKey(literal), true, false,
+                    code_comparator, code_literal);
+        case ValueType::kDecimal:
+            if(!__builtin_mul_overflow(literal, std::llround(multiplier_), &scaled)){
+                return Translate(comparator, IntegerKey(scaled), true, false,
+                        code_comparator, code_literal);
+            }
+            //far out of range anyway
+            return TranslateReal(comparator, static_cast<double>(literal),
+                    code_comparator, code_literal);
+        case ValueType::kFloat:
+            return TranslateReal(comparator, static_cast<double>(literal),
+                    code_comparator, code_literal);
+    }
+}
+
+void Encoder::TranslateReal(Comparator comparator, double literal,
+        Comparator* code_comparator, WordUnit* code_literal) const{
+    uint64_t floor_key = 0;
+    bool exact = false;
+    bool below = false;
+    FloorKey(literal, &floor_key, &exact, &below);
+    Translate(comparator, floor_key, exact, below, code_comparator, code_literal);
+}
+
+std::ostream& operator<< (std::ostream &out, ValueType type){
+    switch(type){
+        case ValueType::kInteger:
+            out << "Integer";
+            break;
+        case ValueType::kDecimal:
+            out << "Decimal";
+            break;
+        case ValueType::kFloat:
+            out << "Float";
+            break;
+    }
+    return out;
+}
+
+}   // namespace
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include    <iostream>
+
+#include "../src/types.h"
+
+namespace byteslice{
+
+//value types with an order-preserving encoding
+enum class ValueType{
+    kInteger,   //signed 64-bit integers
+    kDecimal,   //fixed-point decimals with scale digits after the point
+    kFloat      //IEEE doubles (floats are widened)
+};
+
+/**
+  Order-preserving encoding of typed values into unsigned codes.
+  The values in [min, max] are mapped onto [0, 2^bit_width()) with
+  a < b iff Encode(a) < Encode(b), so a column of the codes can be scanned
+  with the translated literals (see Translate*).
+*/
+class Encoder{
+public:
+    static Encoder Integer(int64_t min, int64_t max);
+    static Encoder Decimal(size_t scale, double min, double max);
+    //decimals given as value * 10^scale, e.g. 5 for 0.05 with a scale of 2
+    static Encoder DecimalScaled(size_t scale, int64_t min_scaled, int64_t max_scaled);
+    static Encoder Float(double min, double max);
+
+    //values out of [min, max] (or not integral for kInteger) are fatal;
+    //decimals are rounded to the nearest multiple of 10^-scale
+    WordUnit EncodeInteger(int64_t value) const;
+    WordUnit EncodeReal(double value) const;
+    WordUnit EncodeScaled(int64_t scaled) const;    //kDecimal only: value * 10^scale
+    int64_t DecodeInteger(WordUnit code) const;     //kInteger only
+    double DecodeReal(WordUnit code) const;
+
+    /**
+     * @brief Translate "value comparator literal" into a predicate on the codes.
+     * Literals out of [min, max] or between two representable values (e.g.,
+     * 0.055 for a scale of 2) adjust the comparator, so the result is exact.
+     * kLess/kLessEqual stay kLess/kLessEqual and kGreater/kGreaterEqual stay
+     * kGreater/kGreaterEqual, so the translated bounds of a range still form a range.
+     */
+    void TranslateInteger(Comparator comparator, int64_t literal,
+            Comparator* code_comparator, WordUnit* code_literal) const;
+    void TranslateReal(Comparator comparator, double literal,
+            Comparator* code_comparator, WordUnit* code_literal) const;
+
+    //accessors
+    ValueType type() const;
+    size_t scale() const;
+    size_t bit_width() const;
+
+private:
+    Encoder(ValueType type, size_t scale, uint64_t min_key, uint64_t max_key);
+
+    //keys: the values mapped to uint64_t in order, before the frame of reference
+    uint64_t IntegerKey(int64_t value) const;
+    //largest key not above literal; exact if literal is representable;
+    //below if literal is below all values of the type
+    void FloorKey(double literal, uint64_t* key, bool* exact, bool* below) const;
+    void Translate(Comparator comparator, uint64_t floor_key, bool exact, bool below,
+            Comparator* code_comparator, WordUnit* code_literal) const;
+
+    ValueType type_;
+    size_t scale_;
+    double multiplier_;     //10^scale
+    uint64_t min_key_;
+    uint64_t max_key_;
+    size_t bit_width_;
+};
+
+inline ValueType Encoder::type() const{
+    return type_;
+}
+
+inline size_t Encoder::scale() const{
+    return scale_;
+}
+
+inline size_t Encoder::bit_width() const{
+    return bit_width_;
+}
+
+//for debug use
+std::ostream& operator<< (std::ostream &out, ValueType type);
+
+}   // namespace
+
+#endif  //ENCODER_H
@@ -16,4 +16,7 @@
 
 #define POPCNT64(X) (_mm_popcnt_u64(X))
 
+//the lowest W bits, 0 < W <= 64
+#define CODE_MASK(W) (~0ULL >> (64 - (W)))
+
 #endif  // MACROS_H
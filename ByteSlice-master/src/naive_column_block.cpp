@@ -8,8 +8,10 @@
  *******************************************************************************/
 #include "naive_column_block.h"
 
+#include    <algorithm>
 #include	<cassert>
 #include    <cstring>
+#include    <vector>
 
 namespace byteslice{
 
@@ -22,7 +24,9 @@ NaiveColumnBlock<DTYPE>::NaiveColumnBlock(size_t num):
 
 template <typename DTYPE>
 NaiveColumnBlock<DTYPE>::~NaiveColumnBlock(){
-    delete[] data_;
+    if(owns_data_){
+        delete[] data_;
+    }
 }
 
 template <typename DTYPE>
@@ -31,6 +35,40 @@ bool NaiveColumnBlock<DTYPE>::Resize(size_t num){
     return true;
 }
 
+template <typename DTYPE>
+const ByteUnit* NaiveColumnBlock<DTYPE>::GetByteSlice(size_t byte_id) const{
+    (void)byte_id;
+    return nullptr;     //not byte-sliced
+}
+
+template <typename DTYPE>
+size_t NaiveColumnBlock<DTYPE>::GetNumBuffers() const{
+    return 1;
+}
+
+template <typename DTYPE>
+size_t NaiveColumnBlock<DTYPE>::GetBufferSize() const{
+    return sizeof(DTYPE)*kNumTuplesPerBlock;
+}
+
+template <typename DTYPE>
+const ByteUnit* NaiveColumnBlock<DTYPE>::GetBuffer(size_t buffer_id) const{
+    assert(0 == buffer_id);
+    (void)buffer_id;
+    return reinterpret_cast<const ByteUnit*>(data_);
+}
+
+template <typename DTYPE>
+void NaiveColumnBlock<DTYPE>::AttachBuffers(ByteUnit* const* buffers, size_t num){
+    assert(num <= kNumTuplesPerBlock);
+    if(owns_data_){
+        delete[] data_;
+    }
+    data_ = reinterpret_cast<DTYPE*>(buffers[0]);
+    owns_data_ = false;
+    num_tuples_ = num;
+}
+
 template <typename DTYPE>
 void NaiveColumnBlock<DTYPE>::SerToFile(SequentialWriteBinaryFile &file) const{
     file.Append(&num_tuples_, sizeof(num_tuples_));
@@ -46,21 +84,22 @@ void NaiveColumnBlock<DTYPE>::DeserFromFile(const SequentialReadBinaryFile &file
 //Scan against a literal
 template <typename DTYPE>
 void NaiveColumnBlock<DTYPE>::Scan(Comparator comparator, WordUnit literal, 
-        BitVectorBlock* bv_block, Bitwise bit_opt) const{
+        BitVectorBlock* bv_block, Bitwise bit_opt, size_t begin, size_t end) const{
     assert(bv_block->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
     switch(comparator){
         case Comparator::kLess:
-            return ScanHelper1<Comparator::kLess>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kLess>(literal, bv_block, bit_opt, begin, end);
         case Comparator::kGreater:
-            return ScanHelper1<Comparator::kGreater>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kGreater>(literal, bv_block, bit_opt, begin, end);
         case Comparator::kLessEqual:
-            return ScanHelper1<Comparator::kLessEqual>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kLessEqual>(literal, bv_block, bit_opt, begin, end);
         case Comparator::kGreaterEqual:
-            return ScanHelper1<Comparator::kGreaterEqual>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kGreaterEqual>(literal, bv_block, bit_opt, begin, end);
         case Comparator::kEqual:
-            return ScanHelper1<Comparator::kEqual>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kEqual>(literal, bv_block, bit_opt, begin, end);
         case Comparator::kInequal:
-            return ScanHelper1<Comparator::kInequal>(literal, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kInequal>(literal, bv_block, bit_opt, begin, end);
     }
 
 }
@@ -68,27 +107,28 @@ void NaiveColumnBlock<DTYPE>::Scan(Comparator comparator, WordUnit literal,
 template <typename DTYPE>
 template <Comparator CMP>
 void NaiveColumnBlock<DTYPE>::ScanHelper1(WordUnit literal, BitVectorBlock* bv_block, 
-        Bitwise bit_opt) const{
+        Bitwise bit_opt, size_t begin, size_t end) const{
     switch(bit_opt){
         case Bitwise::kSet:
-            return ScanHelper2<CMP, Bitwise::kSet>(literal, bv_block);
+            return ScanHelper2<CMP, Bitwise::kSet>(literal, bv_block, begin, end);
         case Bitwise::kAnd:
-            return ScanHelper2<CMP, Bitwise::kAnd>(literal, bv_block);
+            return ScanHelper2<CMP, Bitwise::kAnd>(literal, bv_block, begin, end);
         case Bitwise::kOr:
-            return ScanHelper2<CMP, Bitwise::kOr>(literal, bv_block);
+            return ScanHelper2<CMP, Bitwise::kOr>(literal, bv_block, begin, end);
     }
 }
 
 template <typename DTYPE>
 template <Comparator CMP, Bitwise OPT>
-void NaiveColumnBlock<DTYPE>::ScanHelper2(WordUnit literal, BitVectorBlock* bv_block) const{
+void NaiveColumnBlock<DTYPE>::ScanHelper2(WordUnit literal, BitVectorBlock* bv_block,
+        size_t begin, size_t end) const{
     //Do the real work here
     DTYPE lit = static_cast<DTYPE>(literal);
-    for(size_t offset = 0; offset < num_tuples_; offset += kNumWordBits){
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
         WordUnit word = 0;
         for(size_t i = 0; i < kNumWordBits; i++){
             size_t pos = offset + i;
-            if(pos >= num_tuples_){
+            if(pos >= end){
                 break;
             }
 
@@ -140,51 +180,53 @@ void NaiveColumnBlock<DTYPE>::ScanHelper2(WordUnit literal, BitVectorBlock* bv_b
 //Scan against another column block
 template <typename DTYPE>
 void NaiveColumnBlock<DTYPE>::Scan(Comparator comparator, const ColumnBlock* column_block, 
-        BitVectorBlock* bv_block, Bitwise bit_opt) const{
+        BitVectorBlock* bv_block, Bitwise bit_opt, size_t begin, size_t end) const{
     assert(column_block->type() == type_);
     assert(column_block->num_tuples() == num_tuples_);
     assert(column_block->bit_width() == bit_width_);
+    end = std::min(end, num_tuples_);
 
     switch(comparator){
         case Comparator::kLess:
-            return ScanHelper1<Comparator::kLess>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kLess>(column_block, bv_block, bit_opt, begin, end);
         case Comparator::kGreater:
-            return ScanHelper1<Comparator::kGreater>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kGreater>(column_block, bv_block, bit_opt, begin, end);
         case Comparator::kLessEqual:
-            return ScanHelper1<Comparator::kLessEqual>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kLessEqual>(column_block, bv_block, bit_opt, begin, end);
         case Comparator::kGreaterEqual:
-            return ScanHelper1<Comparator::kGreaterEqual>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kGreaterEqual>(column_block, bv_block, bit_opt, begin, end);
         case Comparator::kEqual:
-            return ScanHelper1<Comparator::kEqual>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kEqual>(column_block, bv_block, bit_opt, begin, end);
         case Comparator::kInequal:
-            return ScanHelper1<Comparator::kInequal>(column_block, bv_block, bit_opt);
+            return ScanHelper1<Comparator::kInequal>(column_block, bv_block, bit_opt, begin, end);
     }
 }
 
 template <typename DTYPE>
 template <Comparator CMP>
 void NaiveColumnBlock<DTYPE>::ScanHelper1(const ColumnBlock* colblock,
-        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+        BitVectorBlock* bvblock, Bitwise bit_opt, size_t begin, size_t end) const{
     switch(bit_opt){
         case Bitwise::kSet:
-            return ScanHelper2<CMP, Bitwise::kSet>(colblock, bvblock);
+            return ScanHelper2<CMP, Bitwise::kSet>(colblock, bvblock, begin, end);
         case Bitwise::kAnd:
-            return ScanHelper2<CMP, Bitwise::kAnd>(colblock, bvblock);
+            return ScanHelper2<CMP, Bitwise::kAnd>(colblock, bvblock, begin, end);
         case Bitwise::kOr:
-            return ScanHelper2<CMP, Bitwise::kOr>(colblock, bvblock);
+            return ScanHelper2<CMP, Bitwise::kOr>(colblock, bvblock, begin, end);
     }
 }
 
 template <typename DTYPE>
 template <Comparator CMP, Bitwise OPT>
 void NaiveColumnBlock<DTYPE>::ScanHelper2(const ColumnBlock* colblock, 
-                                        BitVectorBlock* bvblock) const{
+                                        BitVectorBlock* bvblock,
+                                        size_t begin, size_t end) const{
     //DO the real work real
-    for(size_t offset = 0; offset < num_tuples_; offset += kNumWordBits){
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
         WordUnit word = 0;
         for(size_t i = 0; i < kNumWordBits; i++){
             size_t pos = offset + i;
-            if(pos >= num_tuples_){
+            if(pos >= end){
                 break;
             }
 
@@ -233,6 +275,111 @@ void NaiveColumnBlock<DTYPE>::ScanHelper2(const ColumnBlock* colblock,
     }
 }
 
+//Scan against a list of literals
+template <typename DTYPE>
+void NaiveColumnBlock<DTYPE>::ScanIn(const WordUnit* literals, size_t num_literals,
+        BitVectorBlock* bv_block, Bitwise bit_opt, size_t begin, size_t end) const{
+    assert(bv_block->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
+    //literals out of the domain never match (and must not be narrowed to DTYPE)
+    std::vector<DTYPE> list;
+    for(size_t l = 0; l < num_literals; l++){
+        if(literals[l] <= CODE_MASK(bit_width_)){
+            list.push_back(static_cast<DTYPE>(literals[l]));
+        }
+    }
+    std::sort(list.begin(), list.end());
+
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        WordUnit word = 0;
+        for(size_t i = 0; i < kNumWordBits; i++){
+            size_t pos = offset + i;
+            if(pos >= end){
+                break;
+            }
+            WordUnit bit = std::binary_search(list.begin(), list.end(), data_[pos]);
+            word |= (bit << i);
+        }
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit x = word;
+        switch(bit_opt){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bv_block->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bv_block->GetWordUnit(bv_word_id);
+                break;
+        }
+        bv_block->SetWordUnit(x, bv_word_id);
+    }
+}
+
+//Scan against a range
+template <typename DTYPE>
+void NaiveColumnBlock<DTYPE>::ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+        Comparator comparator_hi, WordUnit literal_hi,
+        BitVectorBlock* bv_block, Bitwise bit_opt, size_t begin, size_t end) const{
+    assert(bv_block->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
+    assert(Comparator::kGreater == comparator_lo || Comparator::kGreaterEqual == comparator_lo);
+    assert(Comparator::kLess == comparator_hi || Comparator::kLessEqual == comparator_hi);
+    const bool inclusive_lo = (Comparator::kGreaterEqual == comparator_lo);
+    const bool inclusive_hi = (Comparator::kLessEqual == comparator_hi);
+
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        WordUnit word = 0;
+        for(size_t i = 0; i < kNumWordBits; i++){
+            size_t pos = offset + i;
+            if(pos >= end){
+                break;
+            }
+            WordUnit code = data_[pos];
+            WordUnit bit = (inclusive_lo ? code >= literal_lo : code > literal_lo)
+                            && (inclusive_hi ? code <= literal_hi : code < literal_hi);
+            word |= (bit << i);
+        }
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit x = word;
+        switch(bit_opt){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                x &= bv_block->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                x |= bv_block->GetWordUnit(bv_word_id);
+                break;
+        }
+        bv_block->SetWordUnit(x, bv_word_id);
+    }
+}
+
+template <typename DTYPE>
+void NaiveColumnBlock<DTYPE>::GetTuples(const uint32_t* positions, size_t num,
+        WordUnit* codes) const{
+    for(size_t i = 0; i < num; i++){
+        codes[i] = static_cast<WordUnit>(data_[positions[i]]);
+    }
+}
+
+template <typename DTYPE>
+size_t NaiveColumnBlock<DTYPE>::GetTuples(const BitVectorBlock* bvblock,
+        WordUnit* codes, size_t begin, size_t end) const{
+    assert(bvblock->num() == num_tuples_);
+    end = std::min(end, num_tuples_);
+    size_t n = 0;
+    for(size_t offset = begin; offset < end; offset += kNumWordBits){
+        WordUnit word = bvblock->GetWordUnit(offset / kNumWordBits);
+        while(0 != word){
+            codes[n++] = static_cast<WordUnit>(data_[offset + __builtin_ctzll(word)]);
+            word &= word - 1;
+        }
+    }
+    return n;
+}
+
 template <typename DTYPE>
 void NaiveColumnBlock<DTYPE>::BulkLoadArray(const WordUnit* codes, size_t num, 
         size_t start_pos){
@@ -24,29 +24,50 @@ public:
 
     WordUnit GetTuple(size_t pos_in_block) const override;
     void SetTuple(size_t pos_in_block, WordUnit value) override;
+    void GetTuples(const uint32_t* positions, size_t num, WordUnit* codes) const override;
+    size_t GetTuples(const BitVectorBlock* bvblock, WordUnit* codes,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const override;
     
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bv_block,
-            Bitwise bit_opt=Bitwise::kSet) const override;
+            Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const override;
     void Scan(Comparator comparator, const ColumnBlock* column_block,
-            BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet) const override;
+            BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const override;
+    void ScanIn(const WordUnit* literals, size_t num_literals, BitVectorBlock* bv_block,
+            Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const override;
+    void ScanBetween(Comparator comparator_lo, WordUnit literal_lo,
+            Comparator comparator_hi, WordUnit literal_hi,
+            BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet,
+            size_t begin=0, size_t end=kNumTuplesPerBlock) const override;
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) override;
 
     void SerToFile(SequentialWriteBinaryFile &file) const override;
     void DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
+    const ByteUnit* GetByteSlice(size_t byte_id) const override;
+    size_t GetNumBuffers() const override;
+    size_t GetBufferSize() const override;
+    const ByteUnit* GetBuffer(size_t buffer_id) const override;
+    void AttachBuffers(ByteUnit* const* buffers, size_t num) override;
 
 private:
     DTYPE* data_;
+    bool owns_data_ = true;     //false once a buffer is attached
     //scan helper: against a given literal
     template <Comparator CMP>
-    void ScanHelper1(WordUnit literal, BitVectorBlock* bv_block, Bitwise bit_opt) const;
+    void ScanHelper1(WordUnit literal, BitVectorBlock* bv_block, Bitwise bit_opt,
+            size_t begin, size_t end) const;
     template <Comparator CMP, Bitwise OPT>
-    void ScanHelper2(WordUnit literal, BitVectorBlock* bv_block) const;
+    void ScanHelper2(WordUnit literal, BitVectorBlock* bv_block, size_t begin, size_t end) const;
     //scan helper: against another column_block
     template <Comparator CMP>
-    void ScanHelper1(const ColumnBlock* colblock, BitVectorBlock* bvblock, Bitwise bit_opt) const;
+    void ScanHelper1(const ColumnBlock* colblock, BitVectorBlock* bvblock, Bitwise bit_opt,
+            size_t begin, size_t end) const;
     template <Comparator CMP, Bitwise OPT>
-    void ScanHelper2(const ColumnBlock* colblock, BitVectorBlock* bvblock) const;
+    void ScanHelper2(const ColumnBlock* colblock, BitVectorBlock* bvblock,
+            size_t begin, size_t end) const;
 
 };
 
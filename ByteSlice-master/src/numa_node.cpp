@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include "numa_node.h"
+
+#include    <algorithm>
+#include    <cstdint>
+#include    <fstream>
+#include    <sched.h>
+#include    <string>
+#include    <sys/syscall.h>
+#include    <unistd.h>
+#include    <vector>
+
+#include    <linux/mempolicy.h>
+
+namespace byteslice{
+
+//nodemask passed to mbind: enough for 1023 nodes
+static constexpr size_t kNumNodeMaskWords = 16;
+
+struct NumaTopology{
+    size_t num_nodes = 1;
+    std::vector<size_t> node_of_cpu;
+};
+
+//"0-3,8,10-11" as {0,1,2,3,8,10,11}
+static std::vector<size_t> ParseList(const std::string &list){
+    std::vector<size_t> ids;
+    size_t pos = 0;
+    while(pos < list.size()){
+        size_t end = list.find(',', pos);
+        end = (std::string::npos == end) ? list.size() : end;
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        if(!range.empty()){
+            const size_t first = std::stoul(range.substr(0, dash));
+            const size_t last = (std::string::npos == dash) ?
+                first : std::stoul(range.substr(dash + 1));
+            for(size_t id = first; id <= last; id++){
+                ids.push_back(id);
+            }
+        }
+        pos = end + 1;
+    }
+    return ids;
+}
+
+static NumaTopology DetectTopology(){
+    NumaTopology topology;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if(!(online >> list)){
+        return topology;
+    }
+    for(size_t node : ParseList(list)){
+        topology.num_nodes = std::max(topology.num_nodes, node + 1);
+        std::ifstream cpus("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string cpu_list;
+        if(!(cpus >> cpu_list)){
+            continue;
+        }
+        for(size_t cpu : ParseList(cpu_list)){
+            if(cpu >= topology.node_of_cpu.size()){
+                topology.node_of_cpu.resize(cpu + 1, 0);
+            }
+            topology.node_of_cpu[cpu] = node;
+        }
+    }
+    return topology;
+}
+
+static const NumaTopology& Topology(){
+    static const NumaTopology topology = DetectTopology();
+    return topology;
+}
+
+size_t GetNumNumaNodes(){
+    return Topology().num_nodes;
+}
+
+size_t GetNumaNodeOfCpu(int cpu){
+    const std::vector<size_t> &node_of_cpu = Topology().node_of_cpu;
+    return (cpu >= 0 && static_cast<size_t>(cpu) < node_of_cpu.size()) ? node_of_cpu[cpu] : 0;
+}
+
+size_t GetCurrentNumaNode(){
+    return GetNumaNodeOfCpu(sched_getcpu());
+}
+
+int GetNumaNodeOfAddress(const void* addr){
+    const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(addr) & ~(page_size - 1));
+    int status = -1;
+    //with no target nodes, move_pages only reports where the pages are
+    if(0 != syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0)){
+        return -1;
+    }
+    return (status < 0) ? -1 : status;
+}
+
+bool BindToNumaNode(void* addr, size_t size, size_t node){
+    if(node >= 64 * kNumNodeMaskWords - 1){
+        return false;
+    }
+    const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if(begin >= end){
+        return true;
+    }
+    unsigned long mask[kNumNodeMaskWords] = {0};
+    mask[node / 64] = 1UL << (node % 64);
+    return 0 == syscall(SYS_mbind, begin, end - begin, MPOL_BIND, mask,
+            64 * kNumNodeMaskWords, MPOL_MF_MOVE);
+}
+
+}   // namespace
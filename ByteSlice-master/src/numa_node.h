@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef NUMA_NODE_H
+#define NUMA_NODE_H
+
+#include    <cstddef>
+
+namespace byteslice{
+
+/**
+  NUMA nodes, read from /sys/devices/system/node at first use.
+  Memory policies are set with the mbind/move_pages system calls,
+  so libnuma is not needed. On a machine (or kernel) without NUMA
+  there is a single node 0 and placement is a no-op.
+*/
+
+size_t GetNumNumaNodes();
+
+//node of the CPU; 0 if unknown
+size_t GetNumaNodeOfCpu(int cpu);
+
+//node of the CPU the calling thread runs on now
+size_t GetCurrentNumaNode();
+
+//node of the page holding addr; -1 if it is not faulted in yet or unknown
+int GetNumaNodeOfAddress(const void* addr);
+
+/**
+ * @brief Bind the pages inside [addr, addr + size) to node: pages faulted in
+ * later are allocated there, and those already faulted in are moved there.
+ * Partial pages at both ends are left alone. Returns false if the kernel
+ * refuses (e.g., no NUMA support).
+ */
+bool BindToNumaNode(void* addr, size_t size, size_t node);
+
+}   // namespace
+
+#endif  //NUMA_NODE_H
@@ -13,6 +13,50 @@ namespace byteslice{
 
 constexpr size_t kNumTuplesPerBlock = 1024*1024*1024;    // each block contains 1M tuples
 
+// unit of intra-block parallelism (morsel): blocks are scanned by all threads
+// in morsels of 16K tuples, i.e. up to 64KB of byte slices, which stays in L2.
+// It must be a multiple of 64 tuples so that no WordUnit of the bit vector is shared.
+constexpr size_t kNumTuplesPerMorsel = 16*1024;
+constexpr size_t kNumWordsPerMorsel = kNumTuplesPerMorsel/64;
+static_assert(0 == kNumTuplesPerMorsel % 64, "morsel must be 64-tuple aligned");
+static_assert(0 == kNumTuplesPerBlock % kNumTuplesPerMorsel, "block must hold whole morsels");
+
+// number of morsels of num tuples (0 for none)
+constexpr size_t NumMorsels(size_t num){
+    return (num + kNumTuplesPerMorsel - 1) / kNumTuplesPerMorsel;
+}
+
+// max number of byte slices of a code: codes are up to 64 bits wide
+constexpr size_t kMaxNumBytesPerCode = 8;
+
+// max number of predicates in one fused conjunction scan
+constexpr size_t kMaxNumConjunctionPredicates = 16;
+
+// max number of queries evaluated in one pass of a shared scan;
+// larger batches take several passes
+constexpr size_t kMaxNumSharedScanQueries = 64;
+
+// IN-lists up to this size compare every literal with SIMD; longer lists
+// filter the first byte slice with a bitmap lookup instead
+constexpr size_t kMaxNumSimdInLiterals = 8;
+
+// segments (of 32 codes) sampled per estimate to order the predicates of ScanOrdered
+constexpr size_t kNumSampleSegments = 32;
+
+// ScanOrdered estimates the order of its predicates afresh every 16 morsels
+// (256K tuples) of a block, so that it follows data whose selectivity drifts
+constexpr size_t kNumMorselsPerEstimate = 16;
+constexpr size_t kNumTuplesPerEstimate = kNumMorselsPerEstimate*kNumTuplesPerMorsel;
+static_assert(0 == kNumTuplesPerBlock % kNumTuplesPerEstimate, "block must hold whole estimates");
+
+// GetTuples rebuilds all codes of a 64-tuple word of the bit vector by sweeping
+// the byte slices once it has this many 1's; sparser words are gathered
+constexpr size_t kMinNumDenseBitsPerWord = 16;
+
+// the dictionary of a string column is built from sorted runs of at least
+// this many strings each, one run per thread
+constexpr size_t kMinNumStringsPerSortRun = 64*1024;
+
 }   // namespace
 
 #endif  // PARAM_H
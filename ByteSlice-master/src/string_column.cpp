@@ -0,0 +1,60 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include 	"string_column.h"
+
+namespace byteslice {
+
+StringColumn::StringColumn(const std::vector<std::string> &values, ColumnType type) :
+		dictionary_(values), column_(type, dictionary_.bit_width(), values.size()) {
+	std::vector<WordUnit> codes(values.size());
+	dictionary_.EncodeArray(values, codes.data());
+	column_.BulkLoadArray(codes.data(), codes.size());
+}
+
+const std::string& StringColumn::GetValue(size_t id) const {
+	return dictionary_.Decode(column_.GetTuple(id));
+}
+
+void StringColumn::Scan(Comparator comparator, const std::string &literal,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	Comparator code_comparator;
+	WordUnit code_literal;
+	dictionary_.Translate(comparator, literal, &code_comparator, &code_literal);
+	column_.Scan(code_comparator, code_literal, bitvector, bit_opt);
+}
+
+void StringColumn::ScanBetween(Comparator comparator_lo, const std::string &literal_lo,
+		Comparator comparator_hi, const std::string &literal_hi,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	Comparator code_comparator_lo, code_comparator_hi;
+	WordUnit code_literal_lo, code_literal_hi;
+	dictionary_.Translate(comparator_lo, literal_lo, &code_comparator_lo, &code_literal_lo);
+	dictionary_.Translate(comparator_hi, literal_hi, &code_comparator_hi, &code_literal_hi);
+	column_.ScanBetween(code_comparator_lo, code_literal_lo,
+			code_comparator_hi, code_literal_hi, bitvector, bit_opt);
+}
+
+void StringColumn::ScanPrefix(const std::string &prefix,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	Comparator code_comparator_lo, code_comparator_hi;
+	WordUnit code_literal_lo, code_literal_hi;
+	dictionary_.TranslatePrefix(prefix, &code_comparator_lo, &code_literal_lo,
+			&code_comparator_hi, &code_literal_hi);
+	column_.ScanBetween(code_comparator_lo, code_literal_lo,
+			code_comparator_hi, code_literal_hi, bitvector, bit_opt);
+}
+
+ColumnPredicate StringColumn::GetPredicate(Comparator comparator,
+		const std::string &literal) const {
+	ColumnPredicate predicate = {&column_, comparator, 0, nullptr};
+	dictionary_.Translate(comparator, literal, &predicate.comparator, &predicate.literal);
+	return predicate;
+}
+
+}   // namespace
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef STRING_COLUMN_H
+#define STRING_COLUMN_H
+
+#include    <string>
+#include    <vector>
+
+#include 	"bitvector.h"
+#include 	"column.h"
+#include 	"dictionary.h"
+#include 	"types.h"
+
+namespace byteslice{
+
+/**
+  A column of strings, stored as the codes of its order-preserving
+  Dictionary in a column of bit_width() bits.
+  Literals and prefixes are translated by the dictionary, so scans run on the codes.
+*/
+class StringColumn{
+public:
+    explicit StringColumn(const std::vector<std::string> &values,
+            ColumnType type=ColumnType::kByteSlicePadRight);
+
+    const std::string& GetValue(size_t id) const;
+
+    void Scan(Comparator comparator, const std::string &literal,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    void ScanBetween(Comparator comparator_lo, const std::string &literal_lo,
+            Comparator comparator_hi, const std::string &literal_hi,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    //value LIKE 'prefix%'
+    void ScanPrefix(const std::string &prefix,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+
+    /**
+     * @brief The translated term for Column::ScanConjunction and Column::ScanOrdered.
+     */
+    ColumnPredicate GetPredicate(Comparator comparator, const std::string &literal) const;
+
+    const Dictionary& dictionary() const { return dictionary_;}
+    const Column* column() const { return &column_;}
+    size_t GetNumTuples() const { return column_.GetNumTuples();}
+
+private:
+    const Dictionary dictionary_;
+    Column column_;
+};
+
+}   // namespace
+
+#endif  //STRING_COLUMN_H
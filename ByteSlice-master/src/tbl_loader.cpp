@@ -0,0 +1,356 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include 	"tbl_loader.h"
+
+#include    <algorithm>
+#include    <cstdlib>
+#include    <cstring>
+#include    <fcntl.h>
+#include    <fstream>
+#include    <limits>
+#include    <omp.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <unistd.h>
+
+#include 	"avx-utility.h"
+
+namespace byteslice {
+
+//the file is split into chunks of whole lines of about this size (or more)
+static constexpr size_t kMinNumBytesPerChunk = 1 << 20;
+
+//chunks per thread, for load balance
+static constexpr size_t kNumChunksPerThread = 4;
+
+static constexpr size_t kNoField = std::numeric_limits<size_t>::max();
+
+static void Malformed(const TblField &field, const char* begin, const char* file) {
+	std::cerr << "[FATAL] Malformed " << field.type << " field " << field.name
+			<< " at byte " << (begin - file) << std::endl;
+	exit(1);
+}
+
+static bool ParseDigits(const char* begin, const char* end, int64_t* value) {
+	if (begin == end) {
+		return false;
+	}
+	int64_t v = 0;
+	for (const char* p = begin; p < end; p++) {
+		if (*p < '0' || *p > '9') {
+			return false;
+		}
+		v = v * 10 + (*p - '0');
+	}
+	*value = v;
+	return true;
+}
+
+static bool ParseInteger(const char* begin, const char* end, int64_t* value) {
+	const bool negative = (begin < end && '-' == *begin);
+	if (!ParseDigits(begin + negative, end, value)) {
+		return false;
+	}
+	*value = negative ? -*value : *value;
+	return true;
+}
+
+//"-12.3" with scale 2 is -1230
+static bool ParseDecimal(const char* begin, const char* end, size_t scale, int64_t* value) {
+	const bool negative = (begin < end && '-' == *begin);
+	begin += negative;
+	const char* point = std::find(begin, end, '.');
+	int64_t integral = 0;
+	int64_t fraction = 0;
+	const size_t num_digits = (point == end) ? 0 : end - point - 1;
+	if (!ParseDigits(begin, point, &integral) || num_digits > scale
+			|| (num_digits > 0 && !ParseDigits(point + 1, end, &fraction))) {
+		return false;
+	}
+	int64_t v = integral;
+	for (size_t i = 0; i < scale; i++) {
+		v *= 10;
+	}
+	for (size_t i = num_digits; i < scale; i++) {
+		fraction *= 10;
+	}
+	v += fraction;
+	*value = negative ? -v : v;
+	return true;
+}
+
+static bool ParseDate(const char* begin, const char* end, int64_t* value) {
+	int64_t year, month, day;
+	if (10 != end - begin || '-' != begin[4] || '-' != begin[7]
+			|| !ParseDigits(begin, begin + 4, &year)
+			|| !ParseDigits(begin + 5, begin + 7, &month)
+			|| !ParseDigits(begin + 8, begin + 10, &day)) {
+		return false;
+	}
+	*value = (year - 1990) * 12 * 31 + (month - 1) * 31 + day;
+	return true;
+}
+
+//bit i is set if p[i] is '|' or '\n', for the first min(sizeof(AvxUnit), end - p) bytes
+static inline uint32_t DelimiterMask(const char* p, const char* end) {
+	if (p + sizeof(AvxUnit) <= end) {
+		AvxUnit bytes = avx_load(const_cast<char*>(p));
+		return avx_movemask(avx_or(avx_cmpeq<uint8_t>(bytes, avx_set1<uint8_t>('|')),
+				avx_cmpeq<uint8_t>(bytes, avx_set1<uint8_t>('\n'))));
+	}
+	uint32_t mask = 0;
+	for (size_t i = 0; p + i < end; i++) {
+		mask |= static_cast<uint32_t>('|' == p[i] || '\n' == p[i]) << i;
+	}
+	return mask;
+}
+
+TblLoader::TblLoader(const std::vector<TblField> &fields, ColumnType type) :
+		fields_(fields), type_(type) {
+}
+
+TblLoader::~TblLoader() {
+	Clear();
+}
+
+void TblLoader::Clear() {
+	for (auto column : columns_) {
+		delete column;
+	}
+	for (auto encoder : encoders_) {
+		delete encoder;
+	}
+	for (auto dictionary : dictionaries_) {
+		delete dictionary;
+	}
+	columns_.clear();
+	encoders_.clear();
+	dictionaries_.clear();
+	min_.clear();
+	max_.clear();
+	num_tuples_ = 0;
+}
+
+size_t TblLoader::Load(const std::string &filepath) {
+	Clear();
+
+	int fd = open(filepath.c_str(), O_RDONLY);
+	struct stat st;
+	if (fd < 0 || 0 != fstat(fd, &st)) {
+		std::cerr << "[FATAL] Can't open file: " << filepath << std::endl;
+		exit(1);
+	}
+	const size_t size = st.st_size;
+	if (0 == size) {
+		close(fd);
+		return 0;
+	}
+	const char* file = static_cast<const char*>(
+			mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+	if (MAP_FAILED == file) {
+		std::cerr << "[FATAL] Can't map file: " << filepath << std::endl;
+		exit(1);
+	}
+	madvise(const_cast<char*>(file), size, MADV_SEQUENTIAL);
+	const char* const file_end = file + size;
+
+	//1. chunks of whole lines
+	const size_t num_chunks = std::max<size_t>(1, std::min<size_t>(
+			kNumChunksPerThread * omp_get_max_threads(), size / kMinNumBytesPerChunk));
+	std::vector<const char*> chunks(num_chunks + 1, file_end);
+	chunks[0] = file;
+	for (size_t c = 1; c < num_chunks; c++) {
+		const char* p = std::max(file + size * c / num_chunks, chunks[c - 1]);
+		p = static_cast<const char*>(memchr(p, '\n', file_end - p));
+		chunks[c] = (nullptr == p) ? file_end : p + 1;
+	}
+
+	//2. lines per chunk; the last line may have no '\n'
+	std::vector<size_t> first_rows(num_chunks + 1, 0);
+#pragma omp parallel for schedule(dynamic)
+	for (size_t c = 0; c < num_chunks; c++) {
+		const char* begin = chunks[c];
+		const char* end = chunks[c + 1];
+		size_t count = std::count(begin, end, '\n');
+		first_rows[c + 1] = count + (begin < end && '\n' != end[-1]);
+	}
+	for (size_t c = 0; c < num_chunks; c++) {
+		first_rows[c + 1] += first_rows[c];
+	}
+	const size_t num = first_rows[num_chunks];
+
+	//3. tokenize and parse
+	size_t num_indexes = 0;
+	for (auto field : fields_) {
+		num_indexes = std::max(num_indexes, field.index + 1);
+	}
+	std::vector<size_t> field_of_index(num_indexes + 1, kNoField);
+	for (size_t f = 0; f < fields_.size(); f++) {
+		field_of_index[fields_[f].index] = f;
+	}
+	std::vector<std::vector<int64_t>> numbers(fields_.size());
+	std::vector<std::vector<std::string>> strings(fields_.size());
+	for (size_t f = 0; f < fields_.size(); f++) {
+		if (FieldType::kString == fields_[f].type) {
+			strings[f].resize(num);
+		} else {
+			numbers[f].resize(num);
+		}
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (size_t c = 0; c < num_chunks; c++) {
+		const char* const end = chunks[c + 1];
+		const char* field_begin = chunks[c];
+		size_t row = first_rows[c];
+		size_t index = 0;
+		auto parse = [&](const char* field_end) {
+			const size_t f = field_of_index[std::min(index, num_indexes)];
+			if (kNoField == f) {
+				return;
+			}
+			const TblField &field = fields_[f];
+			bool ok = true;
+			switch (field.type) {
+			case FieldType::kInteger:
+				ok = ParseInteger(field_begin, field_end, &numbers[f][row]);
+				break;
+			case FieldType::kDecimal:
+				ok = ParseDecimal(field_begin, field_end, field.scale, &numbers[f][row]);
+				break;
+			case FieldType::kDate:
+				ok = ParseDate(field_begin, field_end, &numbers[f][row]);
+				break;
+			case FieldType::kString:
+				strings[f][row].assign(field_begin, field_end);
+				break;
+			}
+			if (!ok) {
+				Malformed(field, field_begin, file);
+			}
+		};
+
+		for (const char* p = chunks[c]; p < end; p += sizeof(AvxUnit)) {
+			for (uint32_t mask = DelimiterMask(p, end); 0 != mask; mask &= mask - 1) {
+				const char* delimiter = p + __builtin_ctz(mask);
+				parse(delimiter);
+				if ('\n' == *delimiter) {
+					if (index + 1 < num_indexes) {
+						Malformed(fields_[field_of_index[num_indexes - 1]], delimiter, file);
+					}
+					row++;
+					index = 0;
+				} else {
+					index++;
+				}
+				field_begin = delimiter + 1;
+			}
+		}
+		if (field_begin < end) {    //no '\n' at the end of the file
+			parse(end);
+		}
+	}
+	munmap(const_cast<char*>(file), size);
+	close(fd);
+
+	//4. encode
+	num_tuples_ = num;
+	for (size_t f = 0; f < fields_.size(); f++) {
+		const TblField &field = fields_[f];
+		std::vector<WordUnit> codes(num);
+		Encoder* encoder = nullptr;
+		Dictionary* dictionary = nullptr;
+		int64_t min = std::numeric_limits<int64_t>::max();
+		int64_t max = std::numeric_limits<int64_t>::min();
+		if (FieldType::kString == field.type) {
+			dictionary = new Dictionary(strings[f]);
+			dictionary->EncodeArray(strings[f], codes.data());
+			std::vector<std::string>().swap(strings[f]);
+		} else {
+			const int64_t* values = numbers[f].data();
+#pragma omp parallel for schedule(static) reduction(min: min) reduction(max: max)
+			for (size_t i = 0; i < num; i++) {
+				min = std::min(min, values[i]);
+				max = std::max(max, values[i]);
+			}
+			if (FieldType::kDecimal == field.type) {
+				//the values are parsed as value * 10^scale already
+				encoder = new Encoder(Encoder::DecimalScaled(field.scale, min, max));
+#pragma omp parallel for schedule(static)
+				for (size_t i = 0; i < num; i++) {
+					codes[i] = encoder->EncodeScaled(values[i]);
+				}
+			} else {
+				encoder = new Encoder(Encoder::Integer(min, max));
+#pragma omp parallel for schedule(static)
+				for (size_t i = 0; i < num; i++) {
+					codes[i] = encoder->EncodeInteger(values[i]);
+				}
+			}
+			std::vector<int64_t>().swap(numbers[f]);
+		}
+		const size_t bit_width = (nullptr == encoder) ?
+				dictionary->bit_width() : encoder->bit_width();
+		Column* column = new Column(type_, bit_width, num);
+		column->BulkLoadArray(codes.data(), num);
+		columns_.push_back(column);
+		encoders_.push_back(encoder);
+		dictionaries_.push_back(dictionary);
+		min_.push_back(min);
+		max_.push_back(max);
+	}
+	return num;
+}
+
+void TblLoader::Write(const std::string &directory) const {
+	std::ofstream schema(directory + "/schema.txt");
+	if (!schema.good()) {
+		std::cerr << "[FATAL] Can't write to directory: " << directory << std::endl;
+		exit(1);
+	}
+	for (size_t f = 0; f < columns_.size(); f++) {
+		const TblField &field = fields_[f];
+		columns_[f]->WriteFile(directory + "/" + field.name + ".col");
+
+		schema << field.name << " " << field.type << " " << columns_[f]->GetBitWidth()
+				<< " " << num_tuples_;
+		if (FieldType::kString == field.type) {
+			std::ofstream dict(directory + "/dict_" + field.name + ".txt");
+			for (size_t code = 0; code < dictionaries_[f]->size(); code++) {
+				dict << code << " " << dictionaries_[f]->Decode(code) << "\n";
+			}
+		} else {
+			if (FieldType::kDecimal == field.type) {
+				schema << " " << field.scale;
+			}
+			schema << " " << min_[f] << " " << max_[f];
+		}
+		schema << std::endl;
+	}
+}
+
+std::ostream& operator<< (std::ostream &out, FieldType type) {
+	switch (type) {
+	case FieldType::kInteger:
+		out << "Integer";
+		break;
+	case FieldType::kDecimal:
+		out << "Decimal";
+		break;
+	case FieldType::kDate:
+		out << "Date";
+		break;
+	case FieldType::kString:
+		out << "String";
+		break;
+	}
+	return out;
+}
+
+}   // namespace
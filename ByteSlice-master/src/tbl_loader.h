@@ -0,0 +1,89 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef TBL_LOADER_H
+#define TBL_LOADER_H
+
+#include    <string>
+#include    <vector>
+
+#include 	"column.h"
+#include 	"dictionary.h"
+#include 	"encoder.h"
+#include 	"types.h"
+
+namespace byteslice{
+
+enum class FieldType{
+    kInteger,   //e.g., l_partkey
+    kDecimal,   //e.g., l_discount, with scale digits after the point
+    kDate,      //YYYY-MM-DD as (year-1990)*12*31 + (month-1)*31 + day,
+                //the same key as tpch_table/zeke_count_date_final.py
+    kString     //dictionary-coded, e.g., l_shipmode
+};
+
+//a field of a .tbl file to load as a column
+struct TblField{
+    std::string name;   //name of the column (and of its files)
+    size_t index;       //position of the field in a line, from 0
+    FieldType type;
+    size_t scale;       //kDecimal only
+};
+
+/**
+  Loader of the pipe-delimited .tbl files of dbgen.
+  The file is memory-mapped and split into chunks of whole lines, which are
+  tokenized with SIMD and parsed by all threads in one pass. The fields are
+  then encoded (Encoder for numbers and dates, Dictionary for strings) and
+  bulk-loaded into columns.
+*/
+class TblLoader{
+public:
+    explicit TblLoader(const std::vector<TblField> &fields,
+            ColumnType type=ColumnType::kByteSlicePadRight);
+    ~TblLoader();
+
+    //returns the number of tuples loaded
+    size_t Load(const std::string &filepath);
+
+    /**
+     * @brief Write every column to directory/<name>.col (Column::WriteFile),
+     * the dictionaries to directory/dict_<name>.txt, and the layout of the
+     * columns to directory/schema.txt, one line per column:
+     * name type bit_width num_tuples [scale] [min max]
+     * where decimals have a scale and min/max are in units of 10^-scale,
+     * and strings have neither.
+     */
+    void Write(const std::string &directory) const;
+
+    size_t GetNumTuples() const { return num_tuples_;}
+    const Column* GetColumn(size_t field_id) const { return columns_[field_id];}
+    //nullptr for kString fields
+    const Encoder* GetEncoder(size_t field_id) const { return encoders_[field_id];}
+    //nullptr for all but kString fields
+    const Dictionary* GetDictionary(size_t field_id) const { return dictionaries_[field_id];}
+
+private:
+    void Clear();
+
+    const std::vector<TblField> fields_;
+    const ColumnType type_;
+    size_t num_tuples_ = 0;
+    std::vector<Column*> columns_;
+    std::vector<Encoder*> encoders_;
+    std::vector<Dictionary*> dictionaries_;
+    //min and max of the numbers and dates, as parsed
+    std::vector<int64_t> min_;
+    std::vector<int64_t> max_;
+};
+
+std::ostream& operator<< (std::ostream &out, FieldType type);
+
+}   // namespace
+
+#endif  //TBL_LOADER_H
@@ -0,0 +1,67 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include 	"typed_column.h"
+
+#include    <omp.h>
+
+namespace byteslice {
+
+TypedColumn::TypedColumn(const Encoder &encoder, size_t num, ColumnType type) :
+		encoder_(encoder), column_(type, encoder.bit_width(), num) {
+}
+
+void TypedColumn::BulkLoadArray(const int64_t* values, size_t num, size_t pos) {
+	std::vector<WordUnit> codes(num);
+#pragma omp parallel for schedule(static)
+	for (size_t i = 0; i < num; i++) {
+		codes[i] = encoder_.EncodeInteger(values[i]);
+	}
+	column_.BulkLoadArray(codes.data(), num, pos);
+}
+
+void TypedColumn::BulkLoadArray(const double* values, size_t num, size_t pos) {
+	std::vector<WordUnit> codes(num);
+#pragma omp parallel for schedule(static)
+	for (size_t i = 0; i < num; i++) {
+		codes[i] = encoder_.EncodeReal(values[i]);
+	}
+	column_.BulkLoadArray(codes.data(), num, pos);
+}
+
+double TypedColumn::GetValue(size_t id) const {
+	return encoder_.DecodeReal(column_.GetTuple(id));
+}
+
+void TypedColumn::Scan(Comparator comparator, double literal,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	Comparator code_comparator;
+	WordUnit code_literal;
+	encoder_.TranslateReal(comparator, literal, &code_comparator, &code_literal);
+	column_.Scan(code_comparator, code_literal, bitvector, bit_opt);
+}
+
+void TypedColumn::ScanBetween(Comparator comparator_lo, double literal_lo,
+		Comparator comparator_hi, double literal_hi,
+		BitVector* bitvector, Bitwise bit_opt) const {
+	//translated bounds keep their direction, so they still form a range
+	Comparator code_comparator_lo, code_comparator_hi;
+	WordUnit code_literal_lo, code_literal_hi;
+	encoder_.TranslateReal(comparator_lo, literal_lo, &code_comparator_lo, &code_literal_lo);
+	encoder_.TranslateReal(comparator_hi, literal_hi, &code_comparator_hi, &code_literal_hi);
+	column_.ScanBetween(code_comparator_lo, code_literal_lo,
+			code_comparator_hi, code_literal_hi, bitvector, bit_opt);
+}
+
+ColumnPredicate TypedColumn::GetPredicate(Comparator comparator, double literal) const {
+	ColumnPredicate predicate = {&column_, comparator, 0, nullptr};
+	encoder_.TranslateReal(comparator, literal, &predicate.comparator, &predicate.literal);
+	return predicate;
+}
+
+}   // namespace
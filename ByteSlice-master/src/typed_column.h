@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp DOT polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef TYPED_COLUMN_H
+#define TYPED_COLUMN_H
+
+#include    <vector>
+
+#include 	"bitvector.h"
+#include 	"column.h"
+#include 	"encoder.h"
+#include 	"types.h"
+
+namespace byteslice{
+
+/**
+  A column of typed values (signed integers, decimals or floats), stored as
+  the order-preserving codes of an Encoder in a column of bit_width() bits.
+  Literals are translated by the encoder, so scans run on the codes directly.
+*/
+class TypedColumn{
+public:
+    TypedColumn(const Encoder &encoder, size_t num=0,
+            ColumnType type=ColumnType::kByteSlicePadRight);
+
+    void BulkLoadArray(const int64_t* values, size_t num, size_t pos=0);
+    void BulkLoadArray(const double* values, size_t num, size_t pos=0);
+    double GetValue(size_t id) const;
+
+    void Scan(Comparator comparator, double literal,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    void ScanBetween(Comparator comparator_lo, double literal_lo,
+            Comparator comparator_hi, double literal_hi,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+
+    /**
+     * @brief The translated term for Column::ScanConjunction and Column::ScanOrdered.
+     */
+    ColumnPredicate GetPredicate(Comparator comparator, double literal) const;
+
+    const Encoder& encoder() const { return encoder_;}
+    const Column* column() const { return &column_;}
+    size_t GetNumTuples() const { return column_.GetNumTuples();}
+
+private:
+    const Encoder encoder_;
+    Column column_;
+};
+
+}   // namespace
+
+#endif  //TYPED_COLUMN_H
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: A pool of long-lived worker threads pinned to CPUs.
+ *******************************************************************************/
+#include <assert.h>
+#include <omp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <deque>
+
+#include "cpu_mapping.h"
+#include "worker_pool.h"
+
+typedef struct {
+    worker_task_t fn;
+    void         *arg;
+} pool_task_t;
+
+struct worker_pool {
+    int                      threads;
+    pthread_t               *tids;
+    pool_task_t             *own_tasks;   /* one per worker, from worker_pool_run */
+    std::deque<pool_task_t>  queue;       /* from worker_pool_submit */
+    int                      pending;     /* tasks queued or running */
+    int                      stop;
+    pthread_mutex_t          lock;
+    pthread_cond_t           work;        /* new tasks, or stop */
+    pthread_cond_t           done;        /* pending dropped to 0 */
+};
+
+typedef struct {
+    worker_pool_t *pool;
+    int            id;
+} worker_arg_t;
+
+static thread_local worker_pool_t *current_pool   = NULL;
+static thread_local int            current_worker = -1;
+
+static void *
+worker_main(void *arg)
+{
+    worker_arg_t  *w    = (worker_arg_t *) arg;
+    worker_pool_t *pool = w->pool;
+    int            id   = w->id;
+    free(w);
+
+    current_pool   = pool;
+    current_worker = id;
+    omp_set_num_threads(1);
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->own_tasks[id].fn == NULL && pool->queue.empty())
+            pthread_cond_wait(&pool->work, &pool->lock);
+
+        pool_task_t task;
+        if (pool->own_tasks[id].fn != NULL) {
+            task = pool->own_tasks[id];
+            pool->own_tasks[id].fn = NULL;
+        } else if (!pool->queue.empty()) {
+            task = pool->queue.front();
+            pool->queue.pop_front();
+        } else {
+            break;  /* stopped, and nothing left to do */
+        }
+        pthread_mutex_unlock(&pool->lock);
+        task.fn(task.arg);
+        pthread_mutex_lock(&pool->lock);
+
+        if (--pool->pending == 0)
+            pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+worker_pool_t *
+worker_pool_create(int threads)
+{
+    assert(threads > 0);
+    worker_pool_t *pool = new worker_pool_t;
+    pool->threads   = threads;
+    pool->tids      = (pthread_t *) malloc(threads * sizeof(pthread_t));
+    pool->own_tasks = (pool_task_t *) calloc(threads, sizeof(pool_task_t));
+    pool->pending   = 0;
+    pool->stop      = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pthread_attr_t attr;
+    cpu_set_t      set;
+    pthread_attr_init(&attr);
+    for (int i = 0; i < threads; i++) {
+        CPU_ZERO(&set);
+        CPU_SET(get_cpu_id(i), &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+
+        worker_arg_t *w = (worker_arg_t *) malloc(sizeof(worker_arg_t));
+        w->pool = pool;
+        w->id   = i;
+        if (pthread_create(&pool->tids[i], &attr, worker_main, w) != 0) {
+            printf("worker_pool_create: cannot create worker %d\n", i);
+            exit(1);
+        }
+    }
+    pthread_attr_destroy(&attr);
+    return pool;
+}
+
+void
+worker_pool_destroy(worker_pool_t *pool)
+{
+    worker_pool_wait(pool);
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->threads; i++)
+        pthread_join(pool->tids[i], NULL);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->own_tasks);
+    free(pool->tids);
+    delete pool;
+}
+
+worker_pool_t *
+worker_pool_global(int threads)
+{
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    static worker_pool_t  *pool = NULL;
+    pthread_mutex_lock(&lock);
+    if (pool == NULL)
+        pool = worker_pool_create(threads > 0 ? threads : (int) sysconf(_SC_NPROCESSORS_ONLN));
+    pthread_mutex_unlock(&lock);
+    return pool;
+}
+
+int
+worker_pool_size(const worker_pool_t *pool)
+{
+    return pool->threads;
+}
+
+void
+worker_pool_submit(worker_pool_t *pool, worker_task_t fn, void *arg)
+{
+    pool_task_t task = {fn, arg};
+    pthread_mutex_lock(&pool->lock);
+    pool->queue.push_back(task);
+    pool->pending++;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void
+worker_pool_wait(worker_pool_t *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void
+worker_pool_run(worker_pool_t *pool, worker_task_t fn, void *args, size_t arg_size)
+{
+    assert(current_pool != pool);
+    pthread_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->threads; i++) {
+        assert(pool->own_tasks[i].fn == NULL);
+        pool->own_tasks[i].fn  = fn;
+        pool->own_tasks[i].arg = (char *) args + i * arg_size;
+    }
+    pool->pending += pool->threads;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    worker_pool_wait(pool);
+}
+
+int
+worker_pool_current_worker(void)
+{
+    return current_worker;
+}
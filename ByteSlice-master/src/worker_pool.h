@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: A pool of long-lived worker threads, each pinned to the CPU
+ * given by get_cpu_id (cpu_mapping.h), with a task queue. Threads are
+ * started once per pool instead of once per query.
+ *******************************************************************************/
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stddef.h>
+
+typedef void *(*worker_task_t)(void *arg);
+
+typedef struct worker_pool worker_pool_t;
+
+/**
+ * Starts threads workers; worker i is pinned to get_cpu_id(i).
+ * Workers run OpenMP regions with one thread, so code that uses OpenMP
+ * inside a task does not oversubscribe the CPUs.
+ */
+worker_pool_t *worker_pool_create(int threads);
+
+/**
+ * Waits for the queued tasks, then stops the workers.
+ */
+void worker_pool_destroy(worker_pool_t *pool);
+
+/**
+ * The pool of the process, created by the first call with threads workers
+ * (0: one per online CPU). Later calls return the same pool, whatever threads.
+ */
+worker_pool_t *worker_pool_global(int threads);
+
+int worker_pool_size(const worker_pool_t *pool);
+
+/**
+ * Queues fn(arg) for the first idle worker.
+ */
+void worker_pool_submit(worker_pool_t *pool, worker_task_t fn, void *arg);
+
+/**
+ * Waits until all the tasks of the pool have finished.
+ */
+void worker_pool_wait(worker_pool_t *pool);
+
+/**
+ * Runs fn((char *) args + i * arg_size) on every worker i at the same time
+ * and waits for all of them (and for any submitted task), so the tasks may
+ * synchronize with each other (e.g., with a pthread barrier of
+ * worker_pool_size threads).
+ * Must not be called from a worker of the same pool.
+ */
+void worker_pool_run(worker_pool_t *pool, worker_task_t fn, void *args, size_t arg_size);
+
+/**
+ * Index of the calling thread in its pool, -1 if it is not a worker.
+ */
+int worker_pool_current_worker(void);
+
+#endif
@@ -13,6 +13,7 @@
 #include 	"gtest/gtest.h"
 #include 	"src/byteslice_column_block.h"
 #include 	"src/bitvector_block.h"
+#include 	"src/cpu_dispatch.h"
 
 namespace byteslice{
 
@@ -83,6 +84,32 @@ TEST_F(ByteSliceColumnBlockTest, ScanLiteral){
     delete bvblock;
 }
 
+TEST_F(ByteSliceColumnBlockTest, ScanRange){
+    BitVectorBlock* bvblock = new BitVectorBlock(num_);
+    BitVectorBlock* bvblock2 = new BitVectorBlock(num_);
+
+    const WordUnit lit = num_ / 3;
+    block_->Scan(Comparator::kLess, lit, bvblock, Bitwise::kSet);
+    //morsel by morsel, the last one cut to the block
+    for(size_t begin = 0; begin < num_; begin += kNumTuplesPerMorsel){
+        block_->Scan(Comparator::kLess, lit, bvblock2, Bitwise::kSet,
+                begin, begin + kNumTuplesPerMorsel);
+    }
+    for(size_t i=0; i < bvblock->num_word_units(); i++){
+        EXPECT_EQ(bvblock->GetWordUnit(i), bvblock2->GetWordUnit(i));
+    }
+
+    //the tuples out of the range are left alone
+    bvblock2->SetOnes();
+    block_->Scan(Comparator::kGreaterEqual, lit, bvblock2, Bitwise::kAnd,
+            0, kNumTuplesPerMorsel);
+    EXPECT_EQ(0, bvblock2->CountOnes(0, kNumTuplesPerMorsel));
+    EXPECT_EQ(num_ - kNumTuplesPerMorsel, bvblock2->CountOnes());
+
+    delete bvblock2;
+    delete bvblock;
+}
+
 TEST_F(ByteSliceColumnBlockTest, ScanOtherBlock){
     BitVectorBlock* bvblock = new BitVectorBlock(num_);
     ByteSliceColumnBlock<20>* block2 = new ByteSliceColumnBlock<20>(num_);
@@ -101,4 +128,28 @@ TEST_F(ByteSliceColumnBlockTest, ScanOtherBlock){
     delete bvblock;
 }
 
+TEST_F(ByteSliceColumnBlockTest, ScanLiteralEveryIsa){
+    BitVectorBlock* bvblock = new BitVectorBlock(num_);
+    const SimdIsa default_isa = GetSimdIsa();
+
+    std::srand(std::time(0));
+    const WordUnit lit = std::rand() % num_;
+    for(SimdIsa isa : {SimdIsa::kAvx2, SimdIsa::kAvx512}){
+        if(!CpuSupports(isa)){
+            continue;
+        }
+        SetSimdIsa(isa);
+        block_->Scan(Comparator::kGreaterEqual, lit, bvblock, Bitwise::kSet);
+        EXPECT_EQ(num_ - lit, bvblock->CountOnes());
+        block_->Scan(Comparator::kEqual, lit, bvblock, Bitwise::kOr);
+        EXPECT_EQ(num_ - lit, bvblock->CountOnes());
+        block_->Scan(Comparator::kLessEqual, lit, bvblock, Bitwise::kAnd);
+        EXPECT_EQ(1, bvblock->CountOnes());
+        EXPECT_TRUE(bvblock->GetBit(lit));
+    }
+
+    SetSimdIsa(default_isa);
+    delete bvblock;
+}
+
 }   // namespace
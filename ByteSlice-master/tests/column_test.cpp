@@ -7,13 +7,17 @@
  * See file LICENSE.md for details.
  *******************************************************************************/
 
+#include    <algorithm>
 #include    <cstdlib>
 #include    <fstream>
 #include    <string>
+#include    <vector>
+#include    <sys/stat.h>
 
 #include    "gtest/gtest.h"
 
 #include 	"src/column.h"
+#include 	"src/numa_node.h"
 
 
 namespace byteslice{
@@ -58,6 +62,160 @@ TEST_F(ColumnTest, LoadTextFile){
     delete column;
 }
 
+TEST_F(ColumnTest, MapFile){
+    std::string filename(std::tmpnam(nullptr));
+    for(ColumnType type : {ColumnType::kNaive, ColumnType::kByteSlicePadRight}){
+        for(size_t bit_width : {size_t(7), size_t(21), size_t(45)}){
+            const WordUnit mask = CODE_MASK(bit_width);
+            std::vector<WordUnit> codes(num_);
+            for(size_t i=0; i < num_; i++){
+                codes[i] = (data_[i] * 2654435761ULL) & mask;
+            }
+            Column* column = new Column(type, bit_width, num_);
+            column->BulkLoadArray(codes.data(), num_);
+            column->WriteFile(filename);
+
+            for(bool populate : {false, true}){
+                Column* mapped = Column::MapFile(filename, populate, !populate);
+                ASSERT_EQ(type, mapped->GetType());
+                ASSERT_EQ(bit_width, mapped->GetBitWidth());
+                ASSERT_EQ(num_, mapped->GetNumTuples());
+                ASSERT_EQ(column->GetNumBlocks(), mapped->GetNumBlocks());
+                for(size_t i=0; i < num_; i++){
+                    EXPECT_EQ(codes[i], mapped->GetTuple(i));
+                }
+
+                BitVector* bitvector = new BitVector(column);
+                BitVector* bitvector_mapped = new BitVector(mapped);
+                column->Scan(Comparator::kLess, mask / 3, bitvector);
+                mapped->Scan(Comparator::kLess, mask / 3, bitvector_mapped);
+                EXPECT_EQ(bitvector->CountOnes(), bitvector_mapped->CountOnes());
+                delete bitvector;
+                delete bitvector_mapped;
+
+                //writes are private to the mapping
+                mapped->SetTuple(0, codes[0] ^ 1);
+                EXPECT_EQ(codes[0] ^ 1, mapped->GetTuple(0));
+                delete mapped;
+            }
+            Column* mapped = Column::MapFile(filename);
+            EXPECT_EQ(codes[0], mapped->GetTuple(0));
+            delete mapped;
+            delete column;
+        }
+    }
+
+    //a short column writes its codes only, not the capacity of its buffers
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, 1000);
+    column->BulkLoadArray(data_, 1000);
+    column->WriteFile(filename);
+    struct stat st;
+    ASSERT_EQ(0, stat(filename.c_str(), &st));
+    EXPECT_LT(static_cast<size_t>(st.st_blocks) * 512, column->GetBlock(0)->GetBufferSize());
+    Column* mapped = Column::MapFile(filename);
+    for(size_t i=0; i < 1000; i++){
+        EXPECT_EQ(data_[i], mapped->GetTuple(i));
+    }
+    delete mapped;
+    delete column;
+    std::remove(filename.c_str());
+}
+
+TEST_F(ColumnTest, NumaPlacement){
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    column->BulkLoadArray(data_, num_);
+    column->PlaceOnNumaNodes();
+    ASSERT_TRUE(column->IsPlacedOnNumaNodes());
+    for(size_t morsel=0; morsel < NumMorsels(num_); morsel++){
+        EXPECT_GT(GetNumNumaNodes(), column->GetMorselNumaNode(morsel));
+    }
+    //a single block is spread over all the nodes, whatever this machine has
+    const size_t num_block_morsels = NumMorsels(kNumTuplesPerBlock);
+    EXPECT_EQ(0u, Column::GetPlannedNumaNode(0, num_block_morsels, 4));
+    EXPECT_EQ(3u, Column::GetPlannedNumaNode(num_block_morsels - 1, num_block_morsels, 4));
+    for(size_t morsel=1; morsel < num_block_morsels; morsel++){
+        EXPECT_LE(Column::GetPlannedNumaNode(morsel - 1, num_block_morsels, 4),
+                Column::GetPlannedNumaNode(morsel, num_block_morsels, 4));
+    }
+    for(size_t i=0; i < num_; i++){
+        EXPECT_EQ(data_[i], column->GetTuple(i));
+    }
+
+    WordUnit literal = std::rand() & mask_;
+    BitVector* bitvector = new BitVector(column);
+    column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+    for(size_t i=0; i < num_; i++){
+        EXPECT_EQ((data_[i] < literal), bitvector->GetBit(i));
+    }
+    NumaScanStats stats = column->GetNumaScanStats();
+    EXPECT_EQ(num_ * CEIL(bit_width_, 8), stats.local_bytes + stats.remote_bytes);
+
+    //an unplaced column in the conjunction is not counted
+    Column* other = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    other->BulkLoadArray(data_, num_);
+    column->ResetNumaScanStats();
+    Column::ScanConjunction({{column, Comparator::kGreaterEqual, literal / 2, nullptr},
+            {other, Comparator::kLess, literal, nullptr}}, bitvector);
+    for(size_t i=0; i < num_; i++){
+        EXPECT_EQ((data_[i] >= literal / 2 && data_[i] < literal), bitvector->GetBit(i));
+    }
+    stats = column->GetNumaScanStats();
+    EXPECT_EQ(num_ * CEIL(bit_width_, 8), stats.local_bytes + stats.remote_bytes);
+    EXPECT_EQ(0ULL, other->GetNumaScanStats().local_bytes + other->GetNumaScanStats().remote_bytes);
+
+    column->Resize(num_ + kNumTuplesPerBlock);
+    EXPECT_FALSE(column->IsPlacedOnNumaNodes());
+    delete bitvector;
+    delete other;
+    delete column;
+}
+
+TEST_F(ColumnTest, WorkerPool){
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    column->BulkLoadArray(data_, num_);
+    BitVector* bitvector = new BitVector(column);
+    WordUnit literal = std::rand() & mask_;
+    //a single block of a few morsels
+    const size_t num_small = 5*kNumTuplesPerMorsel + 17;
+    Column* small_column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_small);
+    small_column->BulkLoadArray(data_, num_small);
+    BitVector* small_bitvector = new BitVector(small_column);
+
+    //the workers take the morsels of the blocks, whether there are
+    //more blocks (3) than workers or not
+    for(int threads : {2, 4}){
+        worker_pool_t* pool = worker_pool_create(threads);
+        Column::SetWorkerPool(pool);
+        column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ((data_[i] < literal), bitvector->GetBit(i));
+        }
+        column->PlaceOnNumaNodes();
+        column->ScanBetween(Comparator::kGreaterEqual, literal / 2,
+                Comparator::kLess, literal, bitvector, Bitwise::kSet);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ((data_[i] >= literal / 2 && data_[i] < literal), bitvector->GetBit(i));
+        }
+
+        small_column->Scan(Comparator::kLess, literal, small_bitvector, Bitwise::kSet);
+        for(size_t i=0; i < num_small; i++){
+            EXPECT_EQ((data_[i] < literal), small_bitvector->GetBit(i));
+        }
+        small_column->PlaceOnNumaNodes();
+        small_column->ResetNumaScanStats();
+        small_column->Scan(Comparator::kGreaterEqual, literal, small_bitvector, Bitwise::kOr);
+        EXPECT_EQ(num_small, small_bitvector->CountOnes());
+        NumaScanStats stats = small_column->GetNumaScanStats();
+        EXPECT_EQ(num_small * CEIL(bit_width_, 8), stats.local_bytes + stats.remote_bytes);
+        Column::SetWorkerPool(nullptr);
+        worker_pool_destroy(pool);
+    }
+    delete small_bitvector;
+    delete small_column;
+    delete bitvector;
+    delete column;
+}
+
 TEST_F(ColumnTest, NaiveSetTuple){
     Column* column = new Column(ColumnType::kNaive, bit_width_, num_);
     for(size_t i=0; i < num_; i++){
@@ -70,6 +228,147 @@ TEST_F(ColumnTest, NaiveSetTuple){
 }
 
 
+TEST_F(ColumnTest, ByteSliceBulkLoadUnaligned){
+    //loads starting and ending in the middle of vectors, morsels and blocks
+    const size_t split = kNumTuplesPerBlock + 37;
+    for(size_t bit_width : {size_t(3), size_t(12), size_t(21), size_t(32)}){
+        const WordUnit mask = (1ULL << bit_width) - 1;
+        std::vector<WordUnit> codes(num_);
+        for(size_t i=0; i < num_; i++){
+            codes[i] = (data_[i] * 2654435761ULL) & mask;
+        }
+        Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width, num_);
+        column->BulkLoadArray(codes.data(), split);
+        column->BulkLoadArray(codes.data() + split, num_ - split, split);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ(codes[i], column->GetTuple(i));
+        }
+        delete column;
+    }
+}
+
+TEST_F(ColumnTest, GetTuples){
+    //sparse and dense selections, so that both gathers and sweeps are used
+    for(ColumnType type : {ColumnType::kNaive, ColumnType::kByteSlicePadRight}){
+        for(size_t bit_width : {size_t(3), size_t(12), size_t(21), size_t(32)}){
+            const WordUnit mask = (1ULL << bit_width) - 1;
+            std::vector<WordUnit> codes(num_);
+            for(size_t i=0; i < num_; i++){
+                codes[i] = (data_[i] * 2654435761ULL) & mask;
+            }
+            Column* column = new Column(type, bit_width, num_);
+            BitVector* bitvector = new BitVector(column);
+            column->BulkLoadArray(codes.data(), num_);
+
+            for(WordUnit literal : {mask / 16 + 1, mask - mask / 16}){
+                column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+                std::vector<WordUnit> expected;
+                std::vector<size_t> ids;
+                for(size_t i=0; i < num_; i++){
+                    if(codes[i] < literal){
+                        expected.push_back(codes[i]);
+                        ids.push_back(i);
+                    }
+                }
+                std::vector<WordUnit> result(num_);
+                EXPECT_EQ(expected.size(), column->GetTuples(bitvector, result.data()));
+                result.resize(expected.size());
+                EXPECT_EQ(expected, result);
+
+                std::reverse(ids.begin(), ids.end());
+                std::reverse(expected.begin(), expected.end());
+                column->GetTuples(ids, result.data());
+                EXPECT_EQ(expected, result);
+            }
+            delete bitvector;
+            delete column;
+        }
+    }
+}
+
+TEST_F(ColumnTest, ByteSliceWideCodes){
+    //most codes tie with the literal on their high bytes, so that scans go past the 4th byte slice
+    for(size_t bit_width : {size_t(33), size_t(40), size_t(48), size_t(57), size_t(64)}){
+        const WordUnit mask = CODE_MASK(bit_width);
+        const WordUnit literal = 0x9e3779b97f4a7c15ULL & mask;
+        std::vector<WordUnit> codes(num_);
+        for(size_t i=0; i < num_; i++){
+            WordUnit hash = (i + 1) * 0xbf58476d1ce4e5b9ULL;
+            hash ^= hash >> 31;
+            codes[i] = ((0 == i % 3) ? hash : ((literal & ~0xffffULL) | (hash & 0xffff))) & mask;
+        }
+        Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width, num_);
+        BitVector* bitvector = new BitVector(column);
+        column->BulkLoadArray(codes.data(), num_);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ(codes[i], column->GetTuple(i));
+        }
+
+        for(Comparator comparator : {Comparator::kLess, Comparator::kLessEqual, Comparator::kGreater,
+                    Comparator::kGreaterEqual, Comparator::kEqual, Comparator::kInequal}){
+            column->Scan(comparator, literal, bitvector, Bitwise::kSet);
+            size_t bvcount = bitvector->CountOnes();
+            size_t count = 0;
+            for(size_t i=0; i < num_; i++){
+                bool expected = false;
+                switch(comparator){
+                    case Comparator::kLess:
+                        expected = codes[i] < literal;
+                        break;
+                    case Comparator::kLessEqual:
+                        expected = codes[i] <= literal;
+                        break;
+                    case Comparator::kGreater:
+                        expected = codes[i] > literal;
+                        break;
+                    case Comparator::kGreaterEqual:
+                        expected = codes[i] >= literal;
+                        break;
+                    case Comparator::kEqual:
+                        expected = codes[i] == literal;
+                        break;
+                    case Comparator::kInequal:
+                        expected = codes[i] != literal;
+                        break;
+                }
+                count += expected;
+                EXPECT_EQ(expected, bitvector->GetBit(i));
+            }
+            EXPECT_EQ(count, bvcount);
+        }
+
+        //kAnd and kOr combine with the input while scanning the later byte slices
+        const WordUnit literal_lo = literal & ~0xffULL;
+        column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+        column->Scan(Comparator::kGreaterEqual, literal_lo, bitvector, Bitwise::kAnd);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ((codes[i] < literal) && (codes[i] >= literal_lo), bitvector->GetBit(i));
+        }
+        column->Scan(Comparator::kGreater, literal, bitvector, Bitwise::kSet);
+        column->Scan(Comparator::kLessEqual, literal_lo, bitvector, Bitwise::kOr);
+        for(size_t i=0; i < num_; i++){
+            EXPECT_EQ((codes[i] > literal) || (codes[i] <= literal_lo), bitvector->GetBit(i));
+        }
+
+        column->ScanBetween(Comparator::kGreaterEqual, literal & ~0xffffULL,
+                Comparator::kLess, literal, bitvector, Bitwise::kSet);
+        std::vector<WordUnit> expected;
+        for(size_t i=0; i < num_; i++){
+            bool in_range = (codes[i] >= (literal & ~0xffffULL)) && (codes[i] < literal);
+            if(in_range){
+                expected.push_back(codes[i]);
+            }
+            EXPECT_EQ(in_range, bitvector->GetBit(i));
+        }
+        std::vector<WordUnit> result(num_);
+        EXPECT_EQ(expected.size(), column->GetTuples(bitvector, result.data()));
+        result.resize(expected.size());
+        EXPECT_EQ(expected, result);
+        delete bitvector;
+        delete column;
+    }
+}
+
 TEST_F(ColumnTest, NaiveBulkLoadAndScanLiteral){
     WordUnit literal = std::rand() & mask_;
     Column* column = new Column(ColumnType::kNaive, bit_width_, num_);
@@ -89,6 +388,311 @@ TEST_F(ColumnTest, NaiveBulkLoadAndScanLiteral){
     delete column;
 }
 
+TEST_F(ColumnTest, ByteSliceScanLiteralAndCombine){
+    WordUnit literal1 = std::rand() & mask_;
+    WordUnit literal2 = std::rand() & mask_;
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    BitVector* bitvector = new BitVector(column);
+    BitVector* bitvector2 = new BitVector(column);
+
+    column->BulkLoadArray(data_, num_);
+    column->Scan(Comparator::kGreater, literal1, bitvector, Bitwise::kSet);
+    column->Scan(Comparator::kLessEqual, literal2, bitvector2, Bitwise::kSet);
+    bitvector->And(bitvector2);
+    size_t bvcount = bitvector->CountOnes();
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = (data_[i] > literal1) && (data_[i] <= literal2);
+        count += expected;
+        EXPECT_EQ(expected, bitvector->GetBit(i));
+    }
+    EXPECT_EQ(count, bvcount);
+    delete bitvector2;
+    delete bitvector;
+    delete column;
+}
+
+TEST_F(ColumnTest, ByteSliceScanConjunction){
+    const size_t bit_width2 = 9;
+    const WordUnit mask2 = (1ULL << bit_width2) - 1;
+    WordUnit* data2 = new WordUnit[num_];
+    for(size_t i=0; i < num_; i++){
+        data2[i] = std::rand() & mask2;
+    }
+    WordUnit literal1 = std::rand() & (mask_ >> 1);
+    WordUnit literal2 = literal1 + (std::rand() & (mask_ >> 1));
+    WordUnit literal3 = std::rand() & mask2;
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    Column* column2 = new Column(ColumnType::kByteSlicePadRight, bit_width2, num_);
+    BitVector* bitvector = new BitVector(column);
+
+    column->BulkLoadArray(data_, num_);
+    column2->BulkLoadArray(data2, num_);
+    std::vector<ColumnPredicate> predicates = {
+        {column, Comparator::kGreaterEqual, literal1},
+        {column, Comparator::kLess, literal2},
+        {column2, Comparator::kInequal, literal3}
+    };
+    Column::ScanConjunction(predicates, bitvector, Bitwise::kSet);
+    size_t bvcount = bitvector->CountOnes();
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = (data_[i] >= literal1) && (data_[i] < literal2)
+                            && (data2[i] != literal3);
+        count += expected;
+        EXPECT_EQ(expected, bitvector->GetBit(i));
+    }
+    EXPECT_EQ(count, bvcount);
+    delete bitvector;
+    delete column2;
+    delete column;
+    delete[] data2;
+}
+
+TEST_F(ColumnTest, ScanShared){
+    const Comparator comparators[] = {Comparator::kEqual, Comparator::kInequal,
+        Comparator::kLess, Comparator::kLessEqual,
+        Comparator::kGreater, Comparator::kGreaterEqual};
+    //more queries than one pass takes
+    const size_t num_queries = kMaxNumSharedScanQueries + 6;
+    for(ColumnType type : {ColumnType::kByteSlicePadRight, ColumnType::kNaive}){
+        Column* column = new Column(type, bit_width_, num_);
+        column->BulkLoadArray(data_, num_);
+        std::vector<BitVector*> bitvectors;
+        std::vector<ColumnScanQuery> queries;
+        for(size_t q=0; q < num_queries; q++){
+            bitvectors.push_back(new BitVector(column));
+            //half of the literals hit a code
+            WordUnit literal = (q % 2) ? data_[std::rand() % num_] : (std::rand() & mask_);
+            queries.push_back({comparators[q % 6], literal, bitvectors[q]});
+        }
+        //the last query refines its bit vector
+        bitvectors.back()->SetOnes();
+        queries.back().bit_opt = Bitwise::kAnd;
+        queries.back().comparator = Comparator::kLess;
+
+        column->ScanShared(queries);
+        for(size_t q=0; q < num_queries; q++){
+            for(size_t i=0; i < num_; i++){
+                bool expected;
+                switch(queries[q].comparator){
+                    case Comparator::kEqual: expected = data_[i] == queries[q].literal; break;
+                    case Comparator::kInequal: expected = data_[i] != queries[q].literal; break;
+                    case Comparator::kLess: expected = data_[i] < queries[q].literal; break;
+                    case Comparator::kLessEqual: expected = data_[i] <= queries[q].literal; break;
+                    case Comparator::kGreater: expected = data_[i] > queries[q].literal; break;
+                    default: expected = data_[i] >= queries[q].literal; break;
+                }
+                ASSERT_EQ(expected, bitvectors[q]->GetBit(i));
+            }
+            delete bitvectors[q];
+        }
+        delete column;
+    }
+}
+
+TEST_F(ColumnTest, ByteSliceScanConjunctionColumns){
+    //column-column terms between columns of different bit widths
+    const size_t bit_width2 = 9;
+    const size_t bit_width3 = 13;
+    const WordUnit mask2 = (1ULL << bit_width2) - 1;
+    const WordUnit mask3 = (1ULL << bit_width3) - 1;
+    WordUnit* data2 = new WordUnit[num_];
+    WordUnit* data3 = new WordUnit[num_];
+    for(size_t i=0; i < num_; i++){
+        data2[i] = std::rand() & mask2;
+        data3[i] = (std::rand() & 1) ? data2[i] : (std::rand() & mask3);
+    }
+    WordUnit literal = std::rand() & (mask_ >> 1);
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    Column* column2 = new Column(ColumnType::kByteSlicePadRight, bit_width2, num_);
+    Column* column3 = new Column(ColumnType::kByteSlicePadRight, bit_width3, num_);
+    BitVector* bitvector = new BitVector(column);
+
+    column->BulkLoadArray(data_, num_);
+    column2->BulkLoadArray(data2, num_);
+    column3->BulkLoadArray(data3, num_);
+    std::vector<ColumnPredicate> predicates = {
+        {column, Comparator::kGreater, literal, nullptr},
+        {column3, Comparator::kGreaterEqual, 0, column2},
+        {column2, Comparator::kLessEqual, 0, column}
+    };
+    Column::ScanConjunction(predicates, bitvector, Bitwise::kSet);
+    size_t bvcount = bitvector->CountOnes();
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = (data_[i] > literal) && (data3[i] >= data2[i])
+                            && (data2[i] <= data_[i]);
+        count += expected;
+        EXPECT_EQ(expected, bitvector->GetBit(i));
+    }
+    EXPECT_EQ(count, bvcount);
+    delete bitvector;
+    delete column3;
+    delete column2;
+    delete column;
+    delete[] data3;
+    delete[] data2;
+}
+
+TEST_F(ColumnTest, ScanOrdered){
+    WordUnit literal = data_[std::rand() % num_];
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    Column* column2 = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    BitVector* bitvector = new BitVector(column);
+
+    column->BulkLoadArray(data_, num_);
+    column2->BulkLoadArray(data_, num_);
+    //always true, then very selective
+    std::vector<ColumnPredicate> predicates = {
+        {column, Comparator::kLessEqual, mask_, nullptr},
+        {column, Comparator::kEqual, literal, nullptr},
+        {column2, Comparator::kEqual, 0, column}
+    };
+    Column::ScanOrdered(predicates, bitvector, Bitwise::kSet);
+    size_t bvcount = bitvector->CountOnes();
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = (data_[i] == literal);
+        count += expected;
+        EXPECT_EQ(expected, bitvector->GetBit(i));
+    }
+    EXPECT_EQ(count, bvcount);
+
+    BlockPredicate block_predicates[3] = {
+        {column->GetBlock(0), Comparator::kLessEqual, mask_, nullptr},
+        {column->GetBlock(0), Comparator::kEqual, literal, nullptr},
+        {column2->GetBlock(0), Comparator::kEqual, 0, column->GetBlock(0)}
+    };
+    size_t order[3];
+    ColumnBlock::ScanOrdered(block_predicates, 3, bitvector->GetBVBlock(0),
+                                Bitwise::kSet, order);
+    EXPECT_EQ(1, order[0]);
+    delete bitvector;
+    delete column2;
+    delete column;
+}
+
+TEST_F(ColumnTest, ScanOrderedDrift){
+    //the first predicate filters the even pieces of kNumTuplesPerEstimate
+    //tuples and passes the odd ones, the second one the other way round
+    WordUnit* data1 = new WordUnit[num_];
+    WordUnit* data2 = new WordUnit[num_];
+    for(size_t i=0; i < num_; i++){
+        bool even = (0 == (i / kNumTuplesPerEstimate) % 2);
+        data1[i] = even ? data_[i] : 0;
+        data2[i] = even ? 0 : data_[i];
+    }
+    Column* column1 = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    Column* column2 = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    BitVector* bitvector = new BitVector(column1);
+    column1->BulkLoadArray(data1, num_);
+    column2->BulkLoadArray(data2, num_);
+
+    std::vector<ColumnPredicate> predicates = {
+        {column1, Comparator::kEqual, 0, nullptr},
+        {column2, Comparator::kEqual, 0, nullptr}
+    };
+    Column::ScanOrdered(predicates, bitvector, Bitwise::kSet);
+    for(size_t i=0; i < num_; i++){
+        EXPECT_EQ((0 == data_[i]), bitvector->GetBit(i));
+    }
+
+    BlockPredicate block_predicates[2] = {
+        {column1->GetBlock(0), Comparator::kEqual, 0, nullptr},
+        {column2->GetBlock(0), Comparator::kEqual, 0, nullptr}
+    };
+    size_t order[2];
+    ColumnBlock::ScanOrdered(block_predicates, 2, bitvector->GetBVBlock(0),
+                                Bitwise::kSet, order, 0, kNumTuplesPerEstimate);
+    EXPECT_EQ(0, order[0]);
+    ColumnBlock::ScanOrdered(block_predicates, 2, bitvector->GetBVBlock(0),
+                                Bitwise::kSet, order, kNumTuplesPerEstimate,
+                                2*kNumTuplesPerEstimate);
+    EXPECT_EQ(1, order[0]);
+    //one call over the whole block switches the order at every piece
+    ColumnBlock::ScanOrdered(block_predicates, 2, bitvector->GetBVBlock(0),
+                                Bitwise::kSet, order);
+    EXPECT_EQ(0, order[0]);
+    for(size_t i=0; i < kNumTuplesPerBlock; i++){
+        EXPECT_EQ((0 == data_[i]), bitvector->GetBit(i));
+    }
+    delete bitvector;
+    delete column2;
+    delete column1;
+    delete[] data2;
+    delete[] data1;
+}
 
+TEST_F(ColumnTest, ScanInList){
+    //a short list (SIMD compare) and a long list (bitmap lookup)
+    for(size_t list_size : {size_t(4), size_t(3*kMaxNumSimdInLiterals)}){
+        std::vector<WordUnit> literals;
+        for(size_t l=0; l < list_size; l++){
+            literals.push_back(data_[std::rand() % num_]);
+        }
+        literals.push_back(mask_ + 1);  //out of the domain
+        for(ColumnType type : {ColumnType::kByteSlicePadRight, ColumnType::kNaive}){
+            Column* column = new Column(type, bit_width_, num_);
+            BitVector* bitvector = new BitVector(column);
+
+            column->BulkLoadArray(data_, num_);
+            column->ScanIn(literals, bitvector, Bitwise::kSet);
+            size_t bvcount = bitvector->CountOnes();
+            size_t count = 0;
+            for(size_t i=0; i < num_; i++){
+                bool expected = std::find(literals.begin(), literals.end(), data_[i])
+                                    != literals.end();
+                count += expected;
+                EXPECT_EQ(expected, bitvector->GetBit(i));
+            }
+            EXPECT_EQ(count, bvcount);
+            delete bitvector;
+            delete column;
+        }
+    }
+
+    //256 would be narrowed to 0 in the uint8_t codes of a naive block
+    std::vector<WordUnit> codes(num_);
+    for(size_t i=0; i < num_; i++){
+        codes[i] = data_[i] & 0xff;
+    }
+    codes[0] = 0;
+    Column* column = new Column(ColumnType::kNaive, 8, num_);
+    BitVector* bitvector = new BitVector(column);
+    column->BulkLoadArray(codes.data(), num_);
+    column->ScanIn({256, 1ULL << 32}, bitvector, Bitwise::kSet);
+    EXPECT_EQ(0ULL, bitvector->CountOnes());
+    delete bitvector;
+    delete column;
+}
+
+TEST_F(ColumnTest, ByteSliceScanBetween){
+    WordUnit literal_lo = std::rand() & (mask_ >> 1);
+    WordUnit literal_hi = literal_lo + (std::rand() & (mask_ >> 1));
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    BitVector* bitvector = new BitVector(column);
+
+    column->BulkLoadArray(data_, num_);
+    for(Comparator comparator_lo : {Comparator::kGreater, Comparator::kGreaterEqual}){
+        for(Comparator comparator_hi : {Comparator::kLess, Comparator::kLessEqual}){
+            column->ScanBetween(comparator_lo, literal_lo, comparator_hi, literal_hi,
+                    bitvector, Bitwise::kSet);
+            size_t bvcount = bitvector->CountOnes();
+            size_t count = 0;
+            for(size_t i=0; i < num_; i++){
+                bool lo = (Comparator::kGreater == comparator_lo) ?
+                            (data_[i] > literal_lo) : (data_[i] >= literal_lo);
+                bool hi = (Comparator::kLess == comparator_hi) ?
+                            (data_[i] < literal_hi) : (data_[i] <= literal_hi);
+                count += (lo && hi);
+                EXPECT_EQ((lo && hi), bitvector->GetBit(i));
+            }
+            EXPECT_EQ(count, bvcount);
+        }
+    }
+    delete bitvector;
+    delete column;
+}
 
 }   // namespace
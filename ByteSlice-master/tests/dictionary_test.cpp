@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp.polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+
+#include    <cstdlib>
+#include    <ctime>
+#include    <set>
+#include    <string>
+#include    <vector>
+
+#include    "gtest/gtest.h"
+
+#include 	"src/dictionary.h"
+#include 	"src/string_column.h"
+
+
+namespace byteslice{
+
+static bool Compare(const std::string &value, Comparator comparator,
+        const std::string &literal){
+    switch(comparator){
+        case Comparator::kLess:
+            return value < literal;
+        case Comparator::kGreater:
+            return value > literal;
+        case Comparator::kLessEqual:
+            return value <= literal;
+        case Comparator::kGreaterEqual:
+            return value >= literal;
+        case Comparator::kEqual:
+            return value == literal;
+        case Comparator::kInequal:
+            return value != literal;
+    }
+    return false;
+}
+
+class DictionaryTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        //p_container-like strings with a numeric suffix
+        const char* sizes[] = {"JUMBO", "LG", "MED", "SM", "WRAP"};
+        const char* kinds[] = {"BAG", "BOX", "CAN", "CASE", "DRUM", "JAR", "PACK", "PKG"};
+        std::srand(std::time(0));
+        values_.resize(num_);
+        for(size_t i = 0; i < num_; i++){
+            values_[i] = std::string(sizes[std::rand() % 5]) + " " + kinds[std::rand() % 8]
+                + " " + std::to_string(std::rand() % 1000);
+        }
+    }
+
+protected:
+    const size_t num_ = 1.5*kNumTuplesPerBlock;
+    std::vector<std::string> values_;
+    const Comparator comparators_[6] = {
+        Comparator::kLess, Comparator::kGreater, Comparator::kLessEqual,
+        Comparator::kGreaterEqual, Comparator::kEqual, Comparator::kInequal};
+};
+
+TEST_F(DictionaryTest, Build){
+    Dictionary dictionary(values_);
+    std::set<std::string> distinct(values_.begin(), values_.end());
+    ASSERT_EQ(distinct.size(), dictionary.size());
+    WordUnit code = 0;
+    for(const std::string &word : distinct){
+        EXPECT_EQ(word, dictionary.Decode(code));
+        EXPECT_EQ(code, dictionary.Encode(word));
+        code++;
+    }
+    //minimal bit width
+    EXPECT_EQ(0ULL, (distinct.size() - 1) >> dictionary.bit_width());
+    EXPECT_EQ(1ULL, (distinct.size() - 1) >> (dictionary.bit_width() - 1));
+
+    std::vector<std::string> one(3, "MED BAG");
+    EXPECT_EQ(1ULL, Dictionary(one).bit_width());
+}
+
+TEST_F(DictionaryTest, Scan){
+    StringColumn column(values_);
+    for(size_t i = 0; i < num_; i += 997){
+        EXPECT_EQ(values_[i], column.GetValue(i));
+    }
+
+    BitVector* bitvector = new BitVector(num_);
+    //present, absent, below and above all strings
+    std::vector<std::string> literals = {values_[0], values_[1], "MED CASE 5",
+        "MED CASE 50x", "", "A", "\xff"};
+    for(const std::string &literal : literals){
+        for(Comparator comparator : comparators_){
+            column.Scan(comparator, literal, bitvector);
+            for(size_t i = 0; i < num_; i++){
+                EXPECT_EQ(Compare(values_[i], comparator, literal), bitvector->GetBit(i))
+                    << "literal " << literal << " comparator " << comparator;
+            }
+        }
+    }
+    delete bitvector;
+}
+
+TEST_F(DictionaryTest, ScanBetween){
+    StringColumn column(values_);
+    BitVector* bitvector = new BitVector(num_);
+    std::vector<std::pair<std::string, std::string>> ranges = {
+        {"LG", "MED"}, {"MED BOX 1", "SM CAN 99"}, {values_[0], values_[0]}, {"", "\xff"}};
+    for(auto range : ranges){
+        column.ScanBetween(Comparator::kGreaterEqual, range.first,
+                Comparator::kLess, range.second, bitvector);
+        for(size_t i = 0; i < num_; i++){
+            EXPECT_EQ(values_[i] >= range.first && values_[i] < range.second,
+                    bitvector->GetBit(i)) << range.first << " " << range.second;
+        }
+    }
+    delete bitvector;
+}
+
+TEST_F(DictionaryTest, ScanPrefix){
+    StringColumn column(values_);
+    BitVector* bitvector = new BitVector(num_);
+    std::vector<std::string> prefixes = {"SM", "SM CASE", "LG BOX 1", "WRAP PKG 999",
+        "", "A", "ZZ", "MED X"};
+    for(const std::string &prefix : prefixes){
+        column.ScanPrefix(prefix, bitvector);
+        for(size_t i = 0; i < num_; i++){
+            EXPECT_EQ(0 == values_[i].compare(0, prefix.size(), prefix), bitvector->GetBit(i))
+                << "prefix " << prefix;
+        }
+    }
+    delete bitvector;
+}
+
+TEST_F(DictionaryTest, GetPredicate){
+    StringColumn column(values_);
+    BitVector* bitvector = new BitVector(num_);
+    std::vector<ColumnPredicate> predicates = {
+        column.GetPredicate(Comparator::kGreater, "LG BOX"),
+        column.GetPredicate(Comparator::kInequal, values_[0]),
+        column.GetPredicate(Comparator::kLessEqual, "SM PACK 5")};
+    Column::ScanConjunction(predicates, bitvector);
+    for(size_t i = 0; i < num_; i++){
+        EXPECT_EQ(values_[i] > "LG BOX" && values_[i] != values_[0] && values_[i] <= "SM PACK 5",
+                bitvector->GetBit(i));
+    }
+    delete bitvector;
+}
+
+}   // namespace
@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp.polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+
+#include    <cstdlib>
+#include    <ctime>
+#include    <vector>
+
+#include    "gtest/gtest.h"
+
+#include 	"src/encoder.h"
+#include 	"src/typed_column.h"
+
+
+namespace byteslice{
+
+static bool Compare(double value, Comparator comparator, double literal){
+    switch(comparator){
+        case Comparator::kLess:
+            return value < literal;
+        case Comparator::kGreater:
+            return value > literal;
+        case Comparator::kLessEqual:
+            return value <= literal;
+        case Comparator::kGreaterEqual:
+            return value >= literal;
+        case Comparator::kEqual:
+            return value == literal;
+        case Comparator::kInequal:
+            return value != literal;
+    }
+    return false;
+}
+
+static const Comparator kComparators[] = {
+    Comparator::kLess, Comparator::kGreater, Comparator::kLessEqual,
+    Comparator::kGreaterEqual, Comparator::kEqual, Comparator::kInequal};
+
+TEST(EncoderTest, Integer){
+    Encoder encoder = Encoder::Integer(-1000, 1000);
+    EXPECT_EQ(11ULL, encoder.bit_width());
+    for(int64_t v = -1000; v < 1000; v++){
+        EXPECT_EQ(v, encoder.DecodeInteger(encoder.EncodeInteger(v)));
+        EXPECT_LT(encoder.EncodeInteger(v), encoder.EncodeInteger(v + 1));
+    }
+    EXPECT_EQ(0ULL, encoder.EncodeInteger(-1000));
+
+    Encoder full = Encoder::Integer(INT64_MIN, INT64_MAX);
+    EXPECT_EQ(64ULL, full.bit_width());
+    EXPECT_LT(full.EncodeInteger(-1), full.EncodeInteger(0));
+    EXPECT_EQ(INT64_MIN, full.DecodeInteger(full.EncodeInteger(INT64_MIN)));
+    EXPECT_EQ(INT64_MAX, full.DecodeInteger(full.EncodeInteger(INT64_MAX)));
+}
+
+TEST(EncoderTest, Decimal){
+    Encoder encoder = Encoder::Decimal(2, -10.0, 10.0);
+    EXPECT_EQ(11ULL, encoder.bit_width());
+    for(int64_t i = -1000; i < 1000; i++){
+        double v = i / 100.0;
+        EXPECT_DOUBLE_EQ(v, encoder.DecodeReal(encoder.EncodeReal(v)));
+        EXPECT_LT(encoder.EncodeReal(v), encoder.EncodeReal((i + 1) / 100.0));
+    }
+    EXPECT_EQ(encoder.EncodeReal(0.07), encoder.EncodeReal(0.07 * 100 / 100));
+    EXPECT_EQ(encoder.EncodeReal(3.0), encoder.EncodeInteger(3));
+
+    //value * 10^scale, as parsed by the table loader
+    Encoder scaled = Encoder::DecimalScaled(2, -1000, 1000);
+    EXPECT_EQ(encoder.bit_width(), scaled.bit_width());
+    for(int64_t i = -1000; i <= 1000; i++){
+        EXPECT_EQ(encoder.EncodeReal(i / 100.0), scaled.EncodeScaled(i));
+    }
+}
+
+TEST(EncoderTest, Float){
+    Encoder encoder = Encoder::Float(-1e10, 1e10);
+    std::vector<double> values = {-1e10, -3.5, -1e-300, -0.0, 0.0, 1e-300, 2.25, 1e10};
+    for(size_t i = 0; i < values.size(); i++){
+        EXPECT_EQ(values[i], encoder.DecodeReal(encoder.EncodeReal(values[i])));
+        if(i + 1 < values.size() && values[i] < values[i + 1]){
+            EXPECT_LT(encoder.EncodeReal(values[i]), encoder.EncodeReal(values[i + 1]));
+        }
+    }
+    EXPECT_EQ(encoder.EncodeReal(-0.0), encoder.EncodeReal(0.0));
+}
+
+class TypedColumnTest: public ::testing::TestWithParam<ValueType>{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+        values_.resize(num_);
+        for(size_t i = 0; i < num_; i++){
+            int64_t r = static_cast<int64_t>(std::rand() % 2001) - 1000;
+            switch(GetParam()){
+                case ValueType::kInteger:
+                    values_[i] = r;
+                    break;
+                case ValueType::kDecimal:
+                    values_[i] = r / 100.0;
+                    break;
+                case ValueType::kFloat:
+                    values_[i] = r / 7.0;
+                    break;
+            }
+        }
+    }
+
+    Encoder MakeEncoder() const{
+        switch(GetParam()){
+            case ValueType::kInteger:
+                return Encoder::Integer(-1000, 1000);
+            case ValueType::kDecimal:
+                return Encoder::Decimal(2, -10.0, 10.0);
+            case ValueType::kFloat:
+                break;
+        }
+        return Encoder::Float(-1000 / 7.0, 1000 / 7.0);
+    }
+
+    std::vector<double> Literals() const{
+        //in range, between representable values and out of range
+        return {values_[0], values_[1], 0.0, 0.055, -5.5, 3.14159,
+                -1e6, 1e6, -1000.5, 1000.5, -10.01, 10.01};
+    }
+
+protected:
+    const size_t num_ = 1.5*kNumTuplesPerBlock;
+    std::vector<double> values_;
+};
+
+TEST_P(TypedColumnTest, Scan){
+    TypedColumn column(MakeEncoder(), num_);
+    column.BulkLoadArray(values_.data(), num_);
+    for(size_t i = 0; i < num_; i += 997){
+        EXPECT_DOUBLE_EQ(values_[i], column.GetValue(i));
+    }
+
+    BitVector* bitvector = new BitVector(num_);
+    for(double literal : Literals()){
+        for(Comparator comparator : kComparators){
+            column.Scan(comparator, literal, bitvector);
+            for(size_t i = 0; i < num_; i++){
+                EXPECT_EQ(Compare(values_[i], comparator, literal), bitvector->GetBit(i))
+                    << "literal " << literal << " comparator " << comparator;
+            }
+        }
+    }
+    delete bitvector;
+}
+
+TEST_P(TypedColumnTest, ScanBetween){
+    TypedColumn column(MakeEncoder(), num_);
+    column.BulkLoadArray(values_.data(), num_);
+
+    BitVector* bitvector = new BitVector(num_);
+    std::vector<double> literals = Literals();
+    for(size_t k = 0; k + 1 < literals.size(); k++){
+        double lo = literals[k];
+        double hi = literals[k + 1];
+        column.ScanBetween(Comparator::kGreater, lo, Comparator::kLessEqual, hi, bitvector);
+        for(size_t i = 0; i < num_; i++){
+            EXPECT_EQ(values_[i] > lo && values_[i] <= hi, bitvector->GetBit(i))
+                << "range (" << lo << ", " << hi << "]";
+        }
+    }
+    delete bitvector;
+}
+
+TEST_P(TypedColumnTest, GetPredicate){
+    TypedColumn column(MakeEncoder(), num_);
+    column.BulkLoadArray(values_.data(), num_);
+
+    BitVector* bitvector = new BitVector(num_);
+    std::vector<ColumnPredicate> predicates = {
+        column.GetPredicate(Comparator::kGreaterEqual, -0.055),
+        column.GetPredicate(Comparator::kInequal, values_[0]),
+        column.GetPredicate(Comparator::kLess, 5.5)};
+    Column::ScanConjunction(predicates, bitvector);
+    for(size_t i = 0; i < num_; i++){
+        EXPECT_EQ(values_[i] >= -0.055 && values_[i] != values_[0] && values_[i] < 5.5,
+                bitvector->GetBit(i));
+    }
+    delete bitvector;
+}
+
+INSTANTIATE_TEST_CASE_P(ValueTypes, TypedColumnTest,
+        ::testing::Values(ValueType::kInteger, ValueType::kDecimal, ValueType::kFloat));
+
+}   // namespace
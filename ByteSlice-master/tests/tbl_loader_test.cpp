@@ -0,0 +1,131 @@
+/*******************************************************************************
+ * Copyright (c) 2015
+ * The Hong Kong Polytechnic University, Database Group
+ *
+ * Author: Ziqiang Feng (cszqfeng AT comp.polyu.edu.hk)
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+
+#include    <cstdio>
+#include    <cstdlib>
+#include    <ctime>
+#include    <fstream>
+#include    <string>
+#include    <vector>
+#include    <unistd.h>
+
+#include    "gtest/gtest.h"
+
+#include 	"src/tbl_loader.h"
+
+
+namespace byteslice{
+
+class TblLoaderTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        const char* modes[] = {"AIR", "FOB", "MAIL", "RAIL", "REG AIR", "SHIP", "TRUCK"};
+        std::srand(std::time(0));
+        filename_ = std::tmpnam(nullptr);
+        std::ofstream outfile(filename_, std::ofstream::out);
+        for(size_t i = 0; i < num_; i++){
+            keys_.push_back(std::rand() % 6000000 + 1);
+            cents_.push_back(std::rand() % 1000000 - 500000);
+            int year = 1992 + std::rand() % 7, month = 1 + std::rand() % 12, day = 1 + std::rand() % 28;
+            dates_.push_back((year - 1990) * 12 * 31 + (month - 1) * 31 + day);
+            modes_.push_back(modes[std::rand() % 7]);
+
+            char date[16];
+            snprintf(date, sizeof(date), "%04d-%02d-%02d", year, month, day);
+            //negative cents: "-0.05"
+            std::string sign = (cents_[i] < 0) ? "-" : "";
+            long abs_cents = std::labs(cents_[i]);
+            outfile << keys_[i] << "|7|" << sign << abs_cents / 100 << "." << (abs_cents % 100) / 10
+                << abs_cents % 10 << "|" << date << "|" << modes_[i] << "|comment, with spaces|";
+            if(i + 1 < num_){
+                outfile << "\n";   //no '\n' after the last line
+            }
+        }
+        outfile.close();
+    }
+
+    virtual void TearDown(){
+        std::remove(filename_.c_str());
+    }
+
+protected:
+    const size_t num_ = 200*1000;
+    std::string filename_;
+    std::vector<int64_t> keys_;
+    std::vector<int64_t> cents_;
+    std::vector<int64_t> dates_;
+    std::vector<std::string> modes_;
+    const std::vector<TblField> fields_ = {
+        {"key",  0, FieldType::kInteger, 0},
+        {"mode", 4, FieldType::kString,  0},
+        {"date", 3, FieldType::kDate,    0},
+        {"cent", 2, FieldType::kDecimal, 2}};
+};
+
+TEST_F(TblLoaderTest, Load){
+    TblLoader loader(fields_);
+    ASSERT_EQ(num_, loader.Load(filename_));
+    ASSERT_EQ(num_, loader.GetNumTuples());
+    EXPECT_EQ(7ULL, loader.GetDictionary(1)->size());
+    EXPECT_EQ(nullptr, loader.GetEncoder(1));
+    EXPECT_EQ(nullptr, loader.GetDictionary(0));
+    for(size_t i = 0; i < num_; i++){
+        EXPECT_EQ(keys_[i], loader.GetEncoder(0)->DecodeInteger(loader.GetColumn(0)->GetTuple(i)));
+        EXPECT_EQ(modes_[i], loader.GetDictionary(1)->Decode(loader.GetColumn(1)->GetTuple(i)));
+        EXPECT_EQ(dates_[i], loader.GetEncoder(2)->DecodeInteger(loader.GetColumn(2)->GetTuple(i)));
+        EXPECT_DOUBLE_EQ(cents_[i] / 100.0,
+                loader.GetEncoder(3)->DecodeReal(loader.GetColumn(3)->GetTuple(i)));
+    }
+
+    //literals translate on the loaded decimals
+    Comparator comparator;
+    WordUnit literal;
+    loader.GetEncoder(3)->TranslateReal(Comparator::kLess, -0.05, &comparator, &literal);
+    BitVector* bitvector = new BitVector(num_);
+    loader.GetColumn(3)->Scan(comparator, literal, bitvector);
+    for(size_t i = 0; i < num_; i++){
+        EXPECT_EQ(cents_[i] < -5, bitvector->GetBit(i));
+    }
+    delete bitvector;
+}
+
+TEST_F(TblLoaderTest, Write){
+    TblLoader loader(fields_);
+    loader.Load(filename_);
+    char directory[] = "/tmp/tbl_loader_testXXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directory));
+    loader.Write(directory);
+
+    std::ifstream schema(std::string(directory) + "/schema.txt");
+    std::string name, type;
+    size_t bit_width, num;
+    schema >> name >> type >> bit_width >> num;
+    EXPECT_EQ("key", name);
+    EXPECT_EQ("Integer", type);
+    EXPECT_EQ(loader.GetColumn(0)->GetBitWidth(), bit_width);
+    EXPECT_EQ(num_, num);
+    schema.close();
+
+    for(size_t f = 0; f < fields_.size(); f++){
+        const Column* column = loader.GetColumn(f);
+        std::string filename = std::string(directory) + "/" + fields_[f].name + ".col";
+        Column* copy = Column::MapFile(filename);
+        ASSERT_EQ(num_, copy->GetNumTuples());
+        for(size_t i = 0; i < num_; i++){
+            EXPECT_EQ(column->GetTuple(i), copy->GetTuple(i));
+        }
+        delete copy;
+        std::remove(filename.c_str());
+    }
+    std::remove((std::string(directory) + "/dict_mode.txt").c_str());
+    std::remove((std::string(directory) + "/schema.txt").c_str());
+    rmdir(directory);
+}
+
+}   // namespace
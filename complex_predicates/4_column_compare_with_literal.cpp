@@ -10,6 +10,7 @@
 
 #include "types_simd.h" 
 #include "avx-utility.h" 
+#include "adaptive_pruning.h"
 
 #define DEBUG_EN
 
@@ -66,6 +67,10 @@ void four_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -166,7 +171,7 @@ void four_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -174,6 +179,24 @@ void four_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif
 			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
@@ -341,8 +364,11 @@ void four_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
                 }						   
 			}
 
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -429,6 +455,10 @@ void four_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -529,7 +559,7 @@ void four_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -537,6 +567,24 @@ void four_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
 			{
@@ -703,8 +751,11 @@ void four_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
                 }						   
 			}
 
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -791,6 +842,10 @@ void four_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -891,7 +946,7 @@ void four_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -899,6 +954,24 @@ void four_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif
 			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
@@ -1066,8 +1139,11 @@ void four_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
                 }						   
 			}
 
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -1154,6 +1230,10 @@ void four_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -1254,7 +1334,7 @@ void four_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -1262,6 +1342,24 @@ void four_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif
 			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
@@ -1429,8 +1527,11 @@ void four_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
                 }						   
 			}
 
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -1518,6 +1619,10 @@ void four_columns_c_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -1618,7 +1723,7 @@ void four_columns_c_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -1626,6 +1731,24 @@ void four_columns_c_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
 			{
@@ -1792,8 +1915,11 @@ void four_columns_c_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
                 }						   
 			}
 
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -1881,6 +2007,10 @@ void four_columns_c_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -1981,7 +2111,7 @@ void four_columns_c_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -1989,6 +2119,24 @@ void four_columns_c_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif
 			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
@@ -2155,8 +2303,11 @@ void four_columns_c_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
                     }			
                 }						   
 			}
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -2244,6 +2395,10 @@ void four_columns_c_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -2344,7 +2499,7 @@ void four_columns_c_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -2352,6 +2507,24 @@ void four_columns_c_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
 			{
@@ -2517,8 +2690,11 @@ void four_columns_c_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
                     }			
                 }						   
 			}
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
@@ -2606,6 +2782,10 @@ void four_columns_c_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 		 ByteUnit byte           = FLIP(static_cast<ByteUnit>(literal_4 >> 8*(kNumBytesPerCode_4 - 1 - byte_id)));
          mask_literal_4[byte_id] = avx_set1<ByteUnit>(byte);
     } 		
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
     //for every NUM_WORD_BITS (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < len; offset += NUM_WORD_BITS, bv_word_id++)
 	{
@@ -2706,7 +2886,7 @@ void four_columns_c_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
                                                   agg_success,
                                                   agg_fail); 
 												  
-#ifdef PRUNING_ENABLE
+#if defined(PRUNING_ENABLE)
           //refine stage.		  
 		  if (!avx_iszero(agg_equal))
 		  {      
@@ -2714,6 +2894,24 @@ void four_columns_c_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
             m_equal_2 = avx_and(m_equal_2, agg_equal);
             m_equal_3 = avx_and(m_equal_3, agg_equal);
             m_equal_4 = avx_and(m_equal_4, agg_equal);
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+          //refine stage: pruned only while pruning pays off.
+		  bool refine = true;
+		  if (pruning.enabled)
+		  {
+		    refine = !avx_iszero(agg_equal);
+		    if (refine)
+		    {
+              m_equal_1 = avx_and(m_equal_1, agg_equal);
+              m_equal_2 = avx_and(m_equal_2, agg_equal);
+              m_equal_3 = avx_and(m_equal_3, agg_equal);
+              m_equal_4 = avx_and(m_equal_4, agg_equal);
+		    }
+		    else
+		      pruning.hits += !avx_iszero(avx_or(avx_or(m_equal_1, m_equal_2), avx_or(m_equal_3, m_equal_4)));
+		  }
+		  if (refine)
+		  {
 #endif			
 	        if ( (kNumBytesPerCode_1 > 1) && !avx_iszero( m_equal_1) ) //for the remaining segments of predicate 1.
 			{
@@ -2879,8 +3077,11 @@ void four_columns_c_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
                     }			
                 }						   
 			}
-#ifdef PRUNING_ENABLE			
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
 		  }
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+		  adaptive_pruning_next_segment(pruning);
 #endif		  
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
             //AvxUnit m_result         = avx_and(m_less_2, m_greater_1);
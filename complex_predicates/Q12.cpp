@@ -38,6 +38,7 @@
 #include "memory_tool.h"
 #include "rand_tool.h"
 #include "perf_counters.h"
+#include "n_column_compare_with_literal.h"
 #include "3_column_compare_with_literal.h" 
 
 
@@ -92,7 +93,8 @@ void print256_num_neg(AvxUnit var)
 #define PREDICATE_TYPE Bitwise::kAnd
 	 
 	 
-void Q12_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len, 
+template <bool PREFETCH, bool STREAM>
+void Q12_cmp_with_literal(WordUnit* bitmap, WordUnit len, 
                                   ByteUnit** data_1, uint32_t literal_1, size_t kNumBytesPerCode_1, size_t kNumPaddingBits_1,
 								  ByteUnit** data_2, uint32_t literal_2, size_t kNumBytesPerCode_2, size_t kNumPaddingBits_2,
 								  ByteUnit** data_3, uint32_t literal_3, size_t kNumBytesPerCode_3, size_t kNumPaddingBits_3,
@@ -180,10 +182,12 @@ void Q12_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 			
            // bool move_to_next_segment = true;
 
-            _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_4[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            if (PREFETCH) {
+                _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_4[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            }
 
 			AvxUnit v_data_1 =  avx_load( (void *)(data_1[0]+offset+i));
 			AvxUnit v_data_2 =  avx_load( (void *)(data_2[0]+offset+i));
@@ -373,7 +377,10 @@ void Q12_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
             bitvector_word |= (static_cast<WordUnit>(mmask) << (i));
         }
         WordUnit x          = bitvector_word;
-	    _mm_stream_si64((__int64*) &bitmap[bv_word_id], x); //bitmap[bv_word_id]  = x; //
+        if (STREAM)
+            _mm_stream_si64((__int64*) &bitmap[bv_word_id], x);
+        else
+            bitmap[bv_word_id] = x;
 
     }
 } 
@@ -382,6 +389,13 @@ void Q12_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 
 
 
+//the variants of the kernel, indexed by ExecutionModel.
+typedef decltype(&Q12_cmp_with_literal<false, false>) Q12_kernel_t;
+static const Q12_kernel_t Q12_kernels[4] = {
+    Q12_cmp_with_literal<false, false>, Q12_cmp_with_literal<false, true>,
+    Q12_cmp_with_literal<true,  false>, Q12_cmp_with_literal<true,  true>
+};
+
 struct Monitor_Event inst_Monitor_Event = {
 	{
 		{0,0},
@@ -414,7 +428,6 @@ struct Monitor_Event inst_Monitor_Event = {
 
 
 typedef struct {
-	pthread_t id;
 
 	int thread;
 	int threads;
@@ -422,6 +435,7 @@ typedef struct {
 	bool huge_table_enable;
 	uint32_t p_s_model_start;
 	uint32_t p_s_model_end;
+	ExecutionModel model;      //variant of the kernel, picked once in main.
  	
     int       seed;
 	uint64_t *times[3];
@@ -436,17 +450,25 @@ typedef struct {
     float    T3_selevitity;
 	
     uint64_t T1_len;     //size of table T1 for the current thread.
+    uint64_t T1_start;   //first code of table T1 for the current thread.
+    shared_column_t *columns; //input columns, shared by all the threads.
+    WordUnit *bitmap;         //output bit vector of the whole table T1, shared by all the threads.
+    morsel_queue_t *morsels;  //morsels of table T1, scheduled with work stealing.
     uint64_t T2_len;     //size of table T2 for the current thread.
     uint64_t T3_len;     //size of table T2 for the current thread.	
 } info_t;
 
 
+//literals of the query.
+uint32_t literal_1   = 3;    //MAIL
+uint32_t literal_2   = 6;    //SHIP
+uint32_t literal_3   = 1488; //1994-1-1  
+uint32_t literal_4   = 1861; //1995-1-1  
+
 void *run(void *arg)
 {
 	info_t *d = (info_t*) arg;
 	
-	assert(pthread_equal(pthread_self(), d->id));
-	bind_thread(d->thread, d->threads);	
 
 	rand32_t *gen              = rand32_init(d->seed);
 	pthread_barrier_t *barrier = d->barrier;
@@ -475,10 +497,6 @@ void *run(void *arg)
     int kNumBytesPerCode_4       = (T4_bit_width+7)/8;
 	int kNumPaddingBits_4        = kNumBytesPerCode_4 * 8 - T4_bit_width;
 
-        uint32_t literal_1   = 3;    //MAIL
-	    uint32_t literal_2   = 6;    //SHIP
-        uint32_t literal_3   = 1488; //1994-1-1  
-        uint32_t literal_4   = 1861; //1995-1-1  
 		
 		
   ///////////////////////Generate the input output data..///////////////////////////////////////	
@@ -487,121 +505,13 @@ void *run(void *arg)
 	WordUnit *bitvector;                //ourput bit map for the original data. 
     uint64_t T1_len_aligned = ( ((T1_len + 63)>>6)<<6 ); //upper boundary to 64-byte alignment.
 	
-  ///////////////////////allocate space for input data and output bit vector///////////////////////////////////////	
-   original_1               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_1 == NULL) 
-   {
-         printf ( "input original_malloc 1 fails\n");
-         return NULL;
-   }
-   original_2               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_2 == NULL) 
-   {
-         printf ( "input original_malloc 2 fails\n");
-         return NULL;
-   }
-   original_3               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_3 == NULL) 
-   {
-         printf ( "input original_malloc 3 fails\n");
-         return NULL;
-   } 
-   original_4               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_4 == NULL) 
-   {
-         printf ( "input original_malloc 4 fails\n");
-         return NULL;
-   }      
-   //consider to use 2M huge table.
-   bitvector              = (WordUnit *) malloc_memory(T1_len_aligned/8, huge_table_enable);//use 4K page.	
-   if (bitvector == NULL) 
-   {
-         printf ( "output bitvector_malloc fails\n");
-         return NULL;
-   }
-
-   
-   for (i = 0; i < 4; i++) // malloc memory space for two codes. 
-   {
-      data_1[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit)*4, huge_table_enable);	  
-	  if (data_1[i] == NULL) {
-            printf ( "&data_1[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }
-      data_2[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_2[i] == NULL) {
-            printf ( "&data_2[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }		
-      data_3[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_3[i] == NULL) {
-            printf ( "&data_3[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }		
-      data_4[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_4[i] == NULL) {
-            printf ( "&data_4[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }				 
-   }   
-   
-    
+  ///////////////////////attach to the shared input columns and output bit vector///////////////////////
+   original_1               = d->columns[0].codes + d->T1_start;
+   original_2               = d->columns[1].codes + d->T1_start;
+   original_3               = d->columns[2].codes + d->T1_start;
+   original_4               = d->columns[3].codes + d->T1_start;
 
-//	  pthread_barrier_wait(barrier++); 
-	  FILE *fp_l_shipmode, *fp_l_commitdate, *fp_l_receiptdate, *fp_l_shipdate;//
-	  char str[128];
-	  uint32_t tmp;
-      
-  //1....................: output_l_shipmode.txt
-      if((fp_l_shipmode=fopen("../../lineitemWT/output_l_shipmode.txt","r"))==NULL) {
-        printf("cannot open output_l_shipmode.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipmode, "%d\n", &tmp) > 0) { 
-         original_1[i]       = tmp; //tmp_cons; //
-         SetTuple(data_1,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);			  
-	     i++;
-    }
-    fclose(fp_l_shipmode);
-  //2....................: output_l_commitdate.txt
-      if((fp_l_commitdate=fopen("../../lineitemWT/output_l_commitdate.txt","r"))==NULL) {
-        printf("cannot open output_l_commitdate.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_commitdate, "%d\n", &tmp) > 0) { 
-         original_2[i]       = tmp; //tmp_cons; //
-         SetTuple(data_2,  i, tmp,  kNumBytesPerCode_2, kNumPaddingBits_2);			  
-	     i++;
-    }
-    fclose(fp_l_commitdate);
-  //3....................: output_l_receiptdate.txt
-      if((fp_l_receiptdate=fopen("../../lineitemWT/output_l_receiptdate.txt","r"))==NULL) {
-        printf("cannot open output_l_receiptdate.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_receiptdate, "%d\n", &tmp) > 0) { 
-         original_3[i]       = tmp; //tmp_cons; //
-         SetTuple(data_3,  i, tmp,  kNumBytesPerCode_3, kNumPaddingBits_3);			  
-	     i++;
-    }
-    fclose(fp_l_receiptdate);
-	
- 
-  //4....................: output_l_shipdate.txt
-      if((fp_l_shipdate=fopen("../../lineitemWT/output_l_shipdate.txt","r"))==NULL) {
-        printf("cannot open output_l_shipdate.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipdate, "%d\n", &tmp) > 0) { 
-         original_4[i]       = tmp; //tmp_cons; //
-         SetTuple(data_4,  i, tmp,  kNumBytesPerCode_4, kNumPaddingBits_4);			  
-	     i++;
-    }
-    fclose(fp_l_shipdate);
+   bitvector               = d->bitmap + (d->T1_start >> 6); //this thread's range, first touched by it below.
 
 	
    for(i=0; i < T1_len_aligned/64; i++){
@@ -609,6 +519,8 @@ void *run(void *arg)
    }
 
 		
+   Q12_kernel_t kernel = Q12_kernels[d->model];
+
    ///////////////////////first barrier: make sure all threads have finished the initialization.///////////////////////
    //////////Otherwise, the writing operations from the above might increase the memory read/write operations./////////
    pthread_barrier_wait(barrier++);
@@ -626,12 +538,21 @@ void *run(void *arg)
 		uint64_t t1 = thread_time(); //
 	    //T1_len = 64;
 		
-       Q12_cmp_with_literal_P_S(bitvector, T1_len, 
+       //morsels of the whole table: its own ones first, then stolen from the other threads.
+       uint64_t morsel_start, morsel_len;
+       while (morsel_queue_next(d->morsels, d->thread, &morsel_start, &morsel_len))
+       {
+          slice_shared_column(&d->columns[0], morsel_start, data_1);
+          slice_shared_column(&d->columns[1], morsel_start, data_2);
+          slice_shared_column(&d->columns[2], morsel_start, data_3);
+          slice_shared_column(&d->columns[3], morsel_start, data_4);
+          kernel(d->bitmap + (morsel_start >> 6), morsel_len, 
                                 data_1, literal_1, kNumBytesPerCode_1, kNumPaddingBits_1,
                                 data_2, literal_2, kNumBytesPerCode_2, kNumPaddingBits_2,
                                 data_3, literal_3, kNumBytesPerCode_3, kNumPaddingBits_3,
                                 data_4, literal_4, kNumBytesPerCode_4, kNumPaddingBits_4
-       ); 
+       );
+       } 
 										   
 	  pthread_barrier_wait(barrier++);
 		 t1 = thread_time() - t1;
@@ -693,7 +614,7 @@ void *run(void *arg)
 	//free(compressed);
 	//free(decompressed);
 	//free(bitmap);
-	pthread_exit(NULL);
+	return NULL;
 }
 
 
@@ -706,7 +627,7 @@ void main(int argc, char **argv)
   uint32_t  T2_bit_width   = argc > 4 ? atoi(argv[4]) : 17;                 //default bit width for 2nd column
   uint32_t  T3_bit_width   = argc > 5 ? atoi(argv[5]) : 17;                 //default bit width for 2nd column
   uint32_t  prefetch_model = argc > 6 ? atoi(argv[6]) : 0;                  //default: enable prefetcher
-  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 0;                  //0:nP_nS, 1:nP_S, 2:P_ns, 3:P_S,   
+  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 4;                  //0:nP_nS, 1:nP_S, 2:P_nS, 3:P_S, 4:cost model
   uint32_t  p_s_model_end  = argc > 8 ? atoi(argv[8]) : 0;                  //4:pf_nP_nS, 1:pf_nP_S, 2:pf_P_ns, 3:pf_P_S,   
   float     T1_selevitity  = argc > 9 ?  atof(argv[9])  : 0.5; 
   float     T2_selevitity  = argc > 10 ? atof(argv[10]) : 0.5; 
@@ -715,7 +636,15 @@ void main(int argc, char **argv)
   if (prefetch_model != 0)  
     inst_Monitor_Event.prefetch_model = prefetch_model;
     
-  uint64_t tuples          = 60490115;//1000000000; //
+  //load every input column once; each thread scans its own range of the same copy.
+  shared_column_t columns[4];
+  load_shared_column(&columns[0], "../../lineitemWT/output_l_shipmode.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[1], "../../lineitemWT/output_l_commitdate.txt", 12, 1.0, huge_table_enable);
+  load_shared_column(&columns[2], "../../lineitemWT/output_l_receiptdate.txt", 12, 1.0, huge_table_enable);
+  load_shared_column(&columns[3], "../../lineitemWT/output_l_shipdate.txt", 12, 1.0, huge_table_enable);
+  uint64_t tuples          = columns[0].num;
+  for (int c = 1; c != 4; ++c)
+    if (columns[c].num < tuples) tuples = columns[c].num;
 
   printf("tuples = %d, thread number = %d, huge_table_enable = %d, T1_bit_width = %d, T2_bit_width = %d, T3_bit_width = %d, prefetch_model = %d\n", 
          tuples,       thread_num,         huge_table_enable,      T1_bit_width,      T2_bit_width,      T3_bit_width,      inst_Monitor_Event.prefetch_model); 
@@ -729,6 +658,36 @@ void main(int argc, char **argv)
   task_len.resize(thread_num);
   uint64_t size_for_each_thread = compute_task_len_for_each_thread(task_len, tuples, thread_num);
 
+  //the variant of the kernel: given, or picked by the cost model on the terms of the query.
+  const uint32_t shipmodes[] = {literal_1, literal_2};
+  ColumnPredicate terms[] = {
+    in_list_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      shipmodes, sizeof(shipmodes)/sizeof(shipmodes[0])),
+    column_predicate(columns[1].data, columns[1].kNumBytesPerCode, columns[1].kNumPaddingBits,
+                     Comparator::kLess, columns[2].data,
+                     columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits),
+    column_predicate(columns[3].data, columns[3].kNumBytesPerCode, columns[3].kNumPaddingBits,
+                     Comparator::kLess, columns[1].data,
+                     columns[1].kNumBytesPerCode, columns[1].kNumPaddingBits),
+    literal_predicate(columns[2].data, columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits,
+                      Comparator::kGreaterEqual, literal_3),
+    literal_predicate(columns[2].data, columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits,
+                      Comparator::kLess, literal_4)
+  };
+  ExecutionModel model = pick_execution_model(p_s_model_start, terms, sizeof(terms)/sizeof(terms[0]),
+                                              tuples, size_for_each_thread, thread_num);
+
+  uint64_t T1_start = 0;
+
+  //output bit vector of the whole table, and its morsels dealt to the threads.
+  WordUnit *bitmap         = (WordUnit *) malloc_memory(((tuples + 63) >> 6) << 3, huge_table_enable);
+  if (bitmap == NULL)
+  {
+      printf ( "output bitvector_malloc fails\n");
+      return;
+  }
+  morsel_queue_t *morsels  = morsel_queue_create(tuples, MORSEL_LEN, thread_num);
+
 
     //initialize 20 barriers to sync between threads.
 	int b, barrier_num = 20;
@@ -741,23 +700,14 @@ void main(int argc, char **argv)
 	uint64_t times[3][thread_num];
 	size_t set_bits[thread_num];
 	
-	//for affinity setting.
-    pthread_t tid[thread_num];
-    pthread_attr_t attr;
-    cpu_set_t set; //cpu_set_t *set = (cpu_set_t *) malloc (sizeof (cpu_set_t)); //
-    pthread_attr_init(&attr);
+	//the workers are started, and pinned with get_cpu_id, once per process.
+    worker_pool_t *pool = worker_pool_global(thread_num);
+    assert(worker_pool_size(pool) == thread_num);
 		
 	//printf("HHHHHHHHHHHHHHHHHtest 1\n"); //OK
 	 
 	for (t = 0 ; t != thread_num ; ++t) 
 	{
-	    //for affinity setting.		
-        int cpu_idx = get_cpu_id(t);
-        //DEBUGMSG(1, "Assigning thread-%d to CPU-%d\n", i, cpu_idx);
-        CPU_ZERO(&set);
-        CPU_SET(cpu_idx, &set);
-        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
-
         info[t].seed              = rand();
 		info[t].huge_table_enable = huge_table_enable;
 		info[t].T1_bit_width      = T1_bit_width;
@@ -766,6 +716,7 @@ void main(int argc, char **argv)
 		
 		info[t].p_s_model_start   = p_s_model_start;
 		info[t].p_s_model_end     = p_s_model_end;
+		info[t].model             = model;
 		
 		info[t].T1_selevitity     = T1_selevitity;
 		info[t].T2_selevitity     = T2_selevitity;
@@ -779,14 +730,23 @@ void main(int argc, char **argv)
 		info[t].times[1] = times[1];
 		info[t].times[2] = times[2];
 		
+		info[t].columns         = columns;
+		info[t].bitmap          = bitmap;
+		info[t].morsels         = morsels;
+		info[t].T1_start        = T1_start;
 		info[t].T1_len          = task_len[t]; //same for all the threads (64*), except the last one 
+		T1_start               += task_len[t];
 		//printf("task_len[%d] = %d\n", t, task_len[t]);
-		pthread_create(&info[t].id, &attr, run, (void*) &info[t]); //&info[t].id, NULL
 	}
 	
-   //finish the execution of all threads......	
-	for (t = 0 ; t != thread_num ; ++t)
-		pthread_join(info[t].id, NULL);
+   //run the query on all the workers, and wait for them.
+	worker_pool_run(pool, run, info, sizeof(info_t));
+	printf("morsels stolen: %llu\n", (unsigned long long) morsel_queue_steals(morsels));
+
+	for (int c = 0; c != 4; ++c)
+		free_shared_column(&columns[c]);
+	free_memory(bitmap, huge_table_enable);
+	morsel_queue_destroy(morsels);
 	
 	
 	
@@ -40,6 +40,7 @@
 #include "memory_tool.h"
 #include "rand_tool.h"
 #include "perf_counters.h"
+#include "n_column_compare_with_literal.h"
 #include "3_column_compare_with_literal.h" 
 
 
@@ -65,7 +66,8 @@ typedef long long si64;
 #define PREDICATE_TYPE Bitwise::kAnd
 	 
 	 
-void Q15_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len, 
+template <bool PREFETCH, bool STREAM>
+void Q15_cmp_with_literal(WordUnit* bitmap, WordUnit len, 
                                   ByteUnit** data_1, uint32_t literal_1, size_t kNumBytesPerCode_1, size_t kNumPaddingBits_1,
 								  uint32_t literal_2
 								  ) 
@@ -112,7 +114,9 @@ void Q15_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 			
            // bool move_to_next_segment = true;
 
-           _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), 0);
+           if (PREFETCH) {
+               _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), 0);
+           }
 			
 	        ////////////////////////approximate stage: for the first byte./////////////////////////////////
             computeKernelWithMask_FIRST<FIRST_COMPARISON_TYPE>(avx_load( (void *)(data_1[0]+offset+i)),
@@ -200,7 +204,10 @@ void Q15_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
             bitvector_word |= (static_cast<WordUnit>(mmask) << (i));
         }
         WordUnit x          = bitvector_word;
-	    _mm_stream_si64((__int64*) &bitmap[bv_word_id], x); //bitmap[bv_word_id]  = x; //
+        if (STREAM)
+            _mm_stream_si64((__int64*) &bitmap[bv_word_id], x);
+        else
+            bitmap[bv_word_id] = x;
 
     }
 } 
@@ -209,6 +216,13 @@ void Q15_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 
 
 
+//the variants of the kernel, indexed by ExecutionModel.
+typedef decltype(&Q15_cmp_with_literal<false, false>) Q15_kernel_t;
+static const Q15_kernel_t Q15_kernels[4] = {
+    Q15_cmp_with_literal<false, false>, Q15_cmp_with_literal<false, true>,
+    Q15_cmp_with_literal<true,  false>, Q15_cmp_with_literal<true,  true>
+};
+
 struct Monitor_Event inst_Monitor_Event = {
 	{
 		{0,0},
@@ -241,7 +255,6 @@ struct Monitor_Event inst_Monitor_Event = {
 
 
 typedef struct {
-	pthread_t id;
 
 	int thread;
 	int threads;
@@ -249,6 +262,7 @@ typedef struct {
 	bool huge_table_enable;
 	uint32_t p_s_model_start;
 	uint32_t p_s_model_end;
+	ExecutionModel model;      //variant of the kernel, picked once in main.
  	
     int       seed;
 	uint64_t *times[3];
@@ -263,17 +277,23 @@ typedef struct {
     float    T3_selevitity;
 	
     uint64_t T1_len;     //size of table T1 for the current thread.
+    uint64_t T1_start;   //first code of table T1 for the current thread.
+    shared_column_t *columns; //input columns, shared by all the threads.
+    WordUnit *bitmap;         //output bit vector of the whole table T1, shared by all the threads.
+    morsel_queue_t *morsels;  //morsels of table T1, scheduled with work stealing.
     uint64_t T2_len;     //size of table T2 for the current thread.
     uint64_t T3_len;     //size of table T2 for the current thread.	
 } info_t;
 
 
+//literals of the query.
+uint32_t literal_1   = 2233;//1996-1-1
+uint32_t literal_2   = 2326;//1996-4-1
+
 void *run(void *arg)
 {
 	info_t *d = (info_t*) arg;
 	
-	assert(pthread_equal(pthread_self(), d->id));
-	bind_thread(d->thread, d->threads);	
 
 	rand32_t *gen              = rand32_init(d->seed);
 	pthread_barrier_t *barrier = d->barrier;
@@ -295,8 +315,6 @@ void *run(void *arg)
     int kNumBytesPerCode_1       = (T1_bit_width+7)/8;
 	int kNumPaddingBits_1        = kNumBytesPerCode_1 * 8 - T1_bit_width;
 
-        uint32_t literal_1   = 2233;//1996-1-1
-	    uint32_t literal_2   = 2326;//1996-4-1
 	
   ///////////////////////Generate the input output data..///////////////////////////////////////	
     uint32_t *original_1;  // input original data.  
@@ -304,47 +322,10 @@ void *run(void *arg)
 	WordUnit *bitvector;                //ourput bit map for the original data. 
     uint64_t T1_len_aligned = ( ((T1_len + 63)>>6)<<6 ); //upper boundary to 64-byte alignment.
 	
-  ///////////////////////allocate space for input data and output bit vector///////////////////////////////////////	
-   original_1               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_1 == NULL) 
-   {
-         printf ( "input original_malloc 1 fails\n");
-         return NULL;
-   }
-   //consider to use 2M huge table.
-   bitvector              = (WordUnit *) malloc_memory(T1_len_aligned/8, huge_table_enable);//use 4K page.	
-   if (bitvector == NULL) 
-   {
-         printf ( "output bitvector_malloc fails\n");
-         return NULL;
-   }
-   for (i = 0; i < 4; i++) // malloc memory space for two codes. 
-   {
-      data_1[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit)*4, huge_table_enable);	  
-	  if (data_1[i] == NULL) {
-            printf ( "&data_1[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }
-}
-   //  printf("before set tuple.\n"); 
-
-//	  pthread_barrier_wait(barrier++);
-	  FILE *fp_l_shipdate;//
-	  char str[128];
-	  uint32_t tmp;
-
-  //1....................: output_l_shipdate.txt
-      if((fp_l_shipdate=fopen("../../lineitemWT/output_l_shipdate.txt","r"))==NULL) {
-        printf("cannot open output_l_shipdate.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipdate, "%d\n", &tmp) > 0) { 
-         original_1[i]       = tmp; //tmp_cons; //
-         SetTuple(data_1,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_l_shipdate);
+  ///////////////////////attach to the shared input columns and output bit vector///////////////////////
+   original_1               = d->columns[0].codes + d->T1_start;
+
+   bitvector               = d->bitmap + (d->T1_start >> 6); //this thread's range, first touched by it below.
 
   //  printf("after set data_.\n");  
 	
@@ -353,6 +334,8 @@ void *run(void *arg)
    }
 
 		
+   Q15_kernel_t kernel = Q15_kernels[d->model];
+
    ///////////////////////first barrier: make sure all threads have finished the initialization.///////////////////////
    //////////Otherwise, the writing operations from the above might increase the memory read/write operations./////////
    pthread_barrier_wait(barrier++);
@@ -369,10 +352,16 @@ void *run(void *arg)
 	  pthread_barrier_wait(barrier++);
 		uint64_t t1 = thread_time(); //
 	
-                    Q15_cmp_with_literal_P_S(bitvector, T1_len, 
+                    //morsels of the whole table: its own ones first, then stolen from the other threads.
+                    uint64_t morsel_start, morsel_len;
+                    while (morsel_queue_next(d->morsels, d->thread, &morsel_start, &morsel_len))
+                    {
+                       slice_shared_column(&d->columns[0], morsel_start, data_1);
+                       kernel(d->bitmap + (morsel_start >> 6), morsel_len, 
                                             data_1, literal_1, kNumBytesPerCode_1, kNumPaddingBits_1,
 								            literal_2
-								           ); 
+								           );
+                    } 
 										   
 	  pthread_barrier_wait(barrier++);
 		 t1 = thread_time() - t1;
@@ -422,7 +411,7 @@ void *run(void *arg)
 	//free(compressed);
 	//free(decompressed);
 	//free(bitmap);
-	pthread_exit(NULL);
+	return NULL;
 }
 
 
@@ -435,7 +424,7 @@ int main(int argc, char **argv)
   uint32_t  T2_bit_width   = argc > 4 ? atoi(argv[4]) : 17;                 //default bit width for 2nd column
   uint32_t  T3_bit_width   = argc > 5 ? atoi(argv[5]) : 17;                 //default bit width for 2nd column
   uint32_t  prefetch_model = argc > 6 ? atoi(argv[6]) : 0;                  //default: enable prefetcher
-  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 0;                  //0:nP_nS, 1:nP_S, 2:P_ns, 3:P_S,   
+  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 4;                  //0:nP_nS, 1:nP_S, 2:P_nS, 3:P_S, 4:cost model
   uint32_t  p_s_model_end  = argc > 8 ? atoi(argv[8]) : 0;                  //4:pf_nP_nS, 1:pf_nP_S, 2:pf_P_ns, 3:pf_P_S,   
   float     T1_selevitity  = argc > 9 ?  atof(argv[9])  : 0.5; 
   float     T2_selevitity  = argc > 10 ? atof(argv[10]) : 0.5; 
@@ -444,7 +433,10 @@ int main(int argc, char **argv)
   if (prefetch_model != 0)  
     inst_Monitor_Event.prefetch_model = prefetch_model;
     
-  uint64_t tuples          = 60490115;//1000000000; //
+  //load every input column once; each thread scans its own range of the same copy.
+  shared_column_t columns[1];
+  load_shared_column(&columns[0], "../../lineitemWT/output_l_shipdate.txt", 12, 1.0, huge_table_enable);
+  uint64_t tuples          = columns[0].num;
 
   printf("tuples = %d, thread number = %d, huge_table_enable = %d, T1_bit_width = %d, T2_bit_width = %d, T3_bit_width = %d, prefetch_model = %d\n", 
          tuples,       thread_num,         huge_table_enable,      T1_bit_width,      T2_bit_width,      T3_bit_width,      inst_Monitor_Event.prefetch_model); 
@@ -458,6 +450,27 @@ int main(int argc, char **argv)
   task_len.resize(thread_num);
   uint64_t size_for_each_thread = compute_task_len_for_each_thread(task_len, tuples, thread_num);
 
+  //the variant of the kernel: given, or picked by the cost model on the terms of the query.
+  ColumnPredicate terms[] = {
+    literal_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      Comparator::kGreater, literal_1),
+    literal_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      Comparator::kLess, literal_2)
+  };
+  ExecutionModel model = pick_execution_model(p_s_model_start, terms, sizeof(terms)/sizeof(terms[0]),
+                                              tuples, size_for_each_thread, thread_num);
+
+  uint64_t T1_start = 0;
+
+  //output bit vector of the whole table, and its morsels dealt to the threads.
+  WordUnit *bitmap         = (WordUnit *) malloc_memory(((tuples + 63) >> 6) << 3, huge_table_enable);
+  if (bitmap == NULL)
+  {
+      printf ( "output bitvector_malloc fails\n");
+      return;
+  }
+  morsel_queue_t *morsels  = morsel_queue_create(tuples, MORSEL_LEN, thread_num);
+
 
     //initialize 20 barriers to sync between threads.
 	int b, barrier_num = 20;
@@ -470,23 +483,14 @@ int main(int argc, char **argv)
 	uint64_t times[3][thread_num];
 	size_t set_bits[thread_num];
 	
-	//for affinity setting.
-    pthread_t tid[thread_num];
-    pthread_attr_t attr;
-    cpu_set_t set; //cpu_set_t *set = (cpu_set_t *) malloc (sizeof (cpu_set_t)); //
-    pthread_attr_init(&attr);
+	//the workers are started, and pinned with get_cpu_id, once per process.
+    worker_pool_t *pool = worker_pool_global(thread_num);
+    assert(worker_pool_size(pool) == thread_num);
 		
 	//printf("HHHHHHHHHHHHHHHHHtest 1\n"); //OK
 	 
 	for (t = 0 ; t != thread_num ; ++t) 
 	{
-	    //for affinity setting.		
-        int cpu_idx = get_cpu_id(t);
-        //DEBUGMSG(1, "Assigning thread-%d to CPU-%d\n", i, cpu_idx);
-        CPU_ZERO(&set);
-        CPU_SET(cpu_idx, &set);
-        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
-
         info[t].seed              = rand();
 		info[t].huge_table_enable = huge_table_enable;
 		info[t].T1_bit_width      = T1_bit_width;
@@ -495,6 +499,7 @@ int main(int argc, char **argv)
 		
 		info[t].p_s_model_start   = p_s_model_start;
 		info[t].p_s_model_end     = p_s_model_end;
+		info[t].model             = model;
 		
 		info[t].T1_selevitity     = T1_selevitity;
 		info[t].T2_selevitity     = T2_selevitity;
@@ -508,14 +513,23 @@ int main(int argc, char **argv)
 		info[t].times[1] = times[1];
 		info[t].times[2] = times[2];
 		
+		info[t].columns         = columns;
+		info[t].bitmap          = bitmap;
+		info[t].morsels         = morsels;
+		info[t].T1_start        = T1_start;
 		info[t].T1_len          = task_len[t]; //same for all the threads (64*), except the last one 
+		T1_start               += task_len[t];
 		//printf("task_len[%d] = %d\n", t, task_len[t]);
-		pthread_create(&info[t].id, &attr, run, (void*) &info[t]); //&info[t].id, NULL
 	}
 	
-   //finish the execution of all threads......	
-	for (t = 0 ; t != thread_num ; ++t)
-		pthread_join(info[t].id, NULL);
+   //run the query on all the workers, and wait for them.
+	worker_pool_run(pool, run, info, sizeof(info_t));
+	printf("morsels stolen: %llu\n", (unsigned long long) morsel_queue_steals(morsels));
+
+	for (int c = 0; c != 1; ++c)
+		free_shared_column(&columns[c]);
+	free_memory(bitmap, huge_table_enable);
+	morsel_queue_destroy(morsels);
 	
 	
 	
@@ -38,6 +38,7 @@
 #include "memory_tool.h"
 #include "rand_tool.h"
 #include "perf_counters.h"
+#include "n_column_compare_with_literal.h"
 #include "3_column_compare_with_literal.h" 
 
 
@@ -120,7 +121,8 @@ typedef long long si64;
         uint32_t literal_6     = 2;      //l_shipmode: DELIVER IN PERSON
 	 
 	 
-void Q19_cmp_with_literal_P_S(WordUnit* bitmap,  WordUnit len, 
+template <bool PREFETCH, bool STREAM>
+void Q19_cmp_with_literal(WordUnit* bitmap,  WordUnit len, 
                               ByteUnit** data_1, ByteUnit** data_2, ByteUnit** data_3, 
 							  ByteUnit** data_4, ByteUnit** data_5, ByteUnit** data_6
                              ) 
@@ -179,12 +181,14 @@ void Q19_cmp_with_literal_P_S(WordUnit* bitmap,  WordUnit len,
 			AvxUnit tmpA, tmpB;
            // bool move_to_next_segment = true;
 
-            _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_4[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_5[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_6[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            if (PREFETCH) {
+                _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_4[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_5[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_6[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            }
 			
 	        ////////////////////////First column: p_brand = ‘[BRAND1]’./////////////////////////////////
 			AvxUnit       m_less_1_1,    m_less_1_2,    m_less_1_3,
@@ -705,7 +709,10 @@ void Q19_cmp_with_literal_P_S(WordUnit* bitmap,  WordUnit len,
             bitvector_word |= (static_cast<WordUnit>(mmask) << (i));
         }
         WordUnit x          = bitvector_word;
-	    _mm_stream_si64((__int64*) &bitmap[bv_word_id], x); //bitmap[bv_word_id]  = x; //
+        if (STREAM)
+            _mm_stream_si64((__int64*) &bitmap[bv_word_id], x);
+        else
+            bitmap[bv_word_id] = x;
 
     }
 } 
@@ -714,6 +721,13 @@ void Q19_cmp_with_literal_P_S(WordUnit* bitmap,  WordUnit len,
 
 
 
+//the variants of the kernel, indexed by ExecutionModel.
+typedef decltype(&Q19_cmp_with_literal<false, false>) Q19_kernel_t;
+static const Q19_kernel_t Q19_kernels[4] = {
+    Q19_cmp_with_literal<false, false>, Q19_cmp_with_literal<false, true>,
+    Q19_cmp_with_literal<true,  false>, Q19_cmp_with_literal<true,  true>
+};
+
 struct Monitor_Event inst_Monitor_Event = {
 	{
 		{0,0},
@@ -746,7 +760,6 @@ struct Monitor_Event inst_Monitor_Event = {
 
 
 typedef struct {
-	pthread_t id;
 
 	int thread;
 	int threads;
@@ -754,6 +767,7 @@ typedef struct {
 	bool huge_table_enable;
 	uint32_t p_s_model_start;
 	uint32_t p_s_model_end;
+	ExecutionModel model;      //variant of the kernel, picked once in main.
  	
     int       seed;
 	uint64_t *times[3];
@@ -768,6 +782,10 @@ typedef struct {
     float    T3_selevitity;
 	
     uint64_t T1_len;     //size of table T1 for the current thread.
+    uint64_t T1_start;   //first code of table T1 for the current thread.
+    shared_column_t *columns; //input columns, shared by all the threads.
+    WordUnit *bitmap;         //output bit vector of the whole table T1, shared by all the threads.
+    morsel_queue_t *morsels;  //morsels of table T1, scheduled with work stealing.
     uint64_t T2_len;     //size of table T2 for the current thread.
     uint64_t T3_len;     //size of table T2 for the current thread.	
 } info_t;
@@ -777,8 +795,6 @@ void *run(void *arg)
 {
 	info_t *d = (info_t*) arg;
 	
-	assert(pthread_equal(pthread_self(), d->id));
-	bind_thread(d->thread, d->threads);	
 
 	rand32_t *gen              = rand32_init(d->seed);
 	pthread_barrier_t *barrier = d->barrier;
@@ -812,180 +828,15 @@ void *run(void *arg)
 	WordUnit *bitvector;                //ourput bit map for the original data. 
     uint64_t T1_len_aligned = ( ((T1_len + 63)>>6)<<6 ); //upper boundary to 64-byte alignment.
 	
-  ///////////////////////allocate space for input data and output bit vector///////////////////////////////////////	
-   original_1               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_1 == NULL) 
-   {
-         printf ( "input original_malloc 1 fails\n");
-         return NULL;
-   }
-   original_2               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_2 == NULL) 
-   {
-         printf ( "input original_malloc 2 fails\n");
-         return NULL;
-   }
-   original_3               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_3 == NULL) 
-   {
-         printf ( "input original_malloc 3 fails\n");
-         return NULL;
-   } 
-   original_4               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_4 == NULL) 
-   {
-         printf ( "input original_malloc 1 fails\n");
-         return NULL;
-   }
-   original_5               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_5 == NULL) 
-   {
-         printf ( "input original_malloc 2 fails\n");
-         return NULL;
-   }
-   original_6               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_6 == NULL) 
-   {
-         printf ( "input original_malloc 3 fails\n");
-         return NULL;
-   }    
-   
-   //consider to use 2M huge table.
-   bitvector              = (WordUnit *) malloc_memory(T1_len_aligned/8, huge_table_enable);//use 4K page.	
-   if (bitvector == NULL) 
-   {
-         printf ( "output bitvector_malloc fails\n");
-         return NULL;
-   }
+  ///////////////////////attach to the shared input columns and output bit vector///////////////////////
+   original_1               = d->columns[0].codes + d->T1_start;
+   original_2               = d->columns[1].codes + d->T1_start;
+   original_3               = d->columns[2].codes + d->T1_start;
+   original_4               = d->columns[3].codes + d->T1_start;
+   original_5               = d->columns[4].codes + d->T1_start;
+   original_6               = d->columns[5].codes + d->T1_start;
 
-   
-   for (i = 0; i < 1; i++) // malloc memory space for two codes. 
-   {
-      data_1[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit)*4, huge_table_enable);	  
-	  if (data_1[i] == NULL) {
-            printf ( "&data_1[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }
-      data_2[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_2[i] == NULL) {
-            printf ( "&data_2[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }		
-      data_3[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_3[i] == NULL) {
-            printf ( "&data_3[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }	
-      data_4[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit)*4, huge_table_enable);	  
-	  if (data_4[i] == NULL) {
-            printf ( "&data_4[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }
-      data_5[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_5[i] == NULL) {
-            printf ( "&data_5[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }		
-      data_6[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_6[i] == NULL) {
-            printf ( "&data_6[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }				 
-   }   
-   
-   
-   
-//	  pthread_barrier_wait(barrier++);
-	  FILE *fp_p_brand, *fp_p_container, *fp_l_quantity;//
-	  char str[128];
-	  uint32_t tmp;
-      float    tmp_f;
-  //1....................: output_p_brand.txt
-      if((fp_p_brand=fopen("../../lineitemWT/output_p_brand.txt","r"))==NULL) {
-        printf("cannot open output_p_brand.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_p_brand, "%d\n", &tmp) > 0) { 
-		 if (i == T1_len) break;
-         original_1[i]       = tmp; //tmp_cons; //
-         SetTuple(data_1,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_p_brand);
-	  
-	   
-  //2....................: p_container.txt
-      if((fp_p_container=fopen("../../lineitemWT/output_p_container.txt","r"))==NULL) {
-        printf("cannot open output_p_container.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_p_container, "%d\n", &tmp) > 0) { 
-		 if (i == T1_len) break;
-         original_2[i]       = tmp; //tmp_cons; //
-         SetTuple(data_2,  i, tmp,  kNumBytesPerCode_2, kNumPaddingBits_2);		  
-	     i++;
-      }
-      fclose(fp_p_container);
-	  
-	  
-  //3....................: l_quantity.txt
-      if((fp_l_quantity=fopen("../../lineitemWT/l_quantity.txt","r"))==NULL) {
-        printf("cannot open l_quantity.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_quantity, "%f\n", &tmp_f) > 0) { 
-		 if (i == T1_len) break;
-		 tmp = (uint32_t) tmp_f;
-         //if (i < 10) printf("tmp = %d\n", tmp);		 
-         original_3[i]       = tmp; //tmp_cons; //
-         SetTuple(data_3,  i, tmp,  kNumBytesPerCode_3, kNumPaddingBits_3);		  
-	     i++;
-      }
-      fclose(fp_l_quantity);
-
-
-   FILE *fp_p_size, *fp_l_shipmode, *fp_l_shipinstruct;//
-  //4....................: p_size.txt
-      if((fp_p_size=fopen("../../lineitemWT/p_size.txt","r"))==NULL) {
-        printf("cannot open p_size.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_p_size, "%d\n", &tmp) > 0) { 
-         original_4[i]       = tmp; //tmp_cons; //
-         SetTuple(data_4,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_p_size);
-
-  //5....................: output_l_shipmode.txt
-      if((fp_l_shipmode=fopen("../../lineitemWT/output_l_shipmode.txt","r"))==NULL) {
-        printf("cannot open output_l_shipmode.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipmode, "%d\n", &tmp) > 0) { 
-         original_5[i]       = tmp; //tmp_cons; //
-         SetTuple(data_5,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_l_shipmode); 
-
-  //6....................: output_l_shipinstruct.txt
-      if((fp_l_shipinstruct=fopen("../../lineitemWT/output_l_shipinstruct.txt","r"))==NULL) {
-        printf("cannot open output_l_shipinstruct.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipinstruct, "%d\n", &tmp) > 0) { 
-         original_6[i]       = tmp; //tmp_cons; //
-         SetTuple(data_6,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_l_shipinstruct); 
+   bitvector               = d->bitmap + (d->T1_start >> 6); //this thread's range, first touched by it below.
 
 
 	  
@@ -994,6 +845,8 @@ void *run(void *arg)
    }
 
 		
+   Q19_kernel_t kernel = Q19_kernels[d->model];
+
    ///////////////////////first barrier: make sure all threads have finished the initialization.///////////////////////
    //////////Otherwise, the writing operations from the above might increase the memory read/write operations./////////
    pthread_barrier_wait(barrier++);
@@ -1011,9 +864,20 @@ void *run(void *arg)
 		uint64_t t1 = thread_time(); //
 	    //T1_len = 64;
 		
-		Q19_cmp_with_literal_P_S(bitvector, T1_len, 
+		//morsels of the whole table: its own ones first, then stolen from the other threads.
+		uint64_t morsel_start, morsel_len;
+		while (morsel_queue_next(d->morsels, d->thread, &morsel_start, &morsel_len))
+		{
+		   slice_shared_column(&d->columns[0], morsel_start, data_1);
+		   slice_shared_column(&d->columns[1], morsel_start, data_2);
+		   slice_shared_column(&d->columns[2], morsel_start, data_3);
+		   slice_shared_column(&d->columns[3], morsel_start, data_4);
+		   slice_shared_column(&d->columns[4], morsel_start, data_5);
+		   slice_shared_column(&d->columns[5], morsel_start, data_6);
+		   kernel(d->bitmap + (morsel_start >> 6), morsel_len, 
 								data_1, data_2, data_3, data_4, data_5, data_6
-								); 
+								);
+		} 
 										   
 	  pthread_barrier_wait(barrier++);
 		 t1 = thread_time() - t1;
@@ -1090,7 +954,7 @@ void *run(void *arg)
 	//free(compressed);
 	//free(decompressed);
 	//free(bitmap);
-	pthread_exit(NULL);
+	return NULL;
 }
 
 
@@ -1103,7 +967,7 @@ void main(int argc, char **argv)
   uint32_t  T2_bit_width   = argc > 4 ? atoi(argv[4]) : 17;                 //default bit width for 2nd column
   uint32_t  T3_bit_width   = argc > 5 ? atoi(argv[5]) : 17;                 //default bit width for 2nd column
   uint32_t  prefetch_model = argc > 6 ? atoi(argv[6]) : 0;                  //default: enable prefetcher
-  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 0;                  //0:nP_nS, 1:nP_S, 2:P_ns, 3:P_S,   
+  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 4;                  //0:nP_nS, 1:nP_S, 2:P_nS, 3:P_S, 4:cost model
   uint32_t  p_s_model_end  = argc > 8 ? atoi(argv[8]) : 0;                  //4:pf_nP_nS, 1:pf_nP_S, 2:pf_P_ns, 3:pf_P_S,   
   float     T1_selevitity  = argc > 9 ?  atof(argv[9])  : 0.5; 
   float     T2_selevitity  = argc > 10 ? atof(argv[10]) : 0.5; 
@@ -1112,7 +976,17 @@ void main(int argc, char **argv)
   if (prefetch_model != 0)  
     inst_Monitor_Event.prefetch_model = prefetch_model;
     
-  uint64_t tuples          = 60490115;  //59987861;//1000000000; //
+  //load every input column once; each thread scans its own range of the same copy.
+  shared_column_t columns[6];
+  load_shared_column(&columns[0], "../../lineitemWT/output_p_brand.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[1], "../../lineitemWT/output_p_container.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[2], "../../lineitemWT/l_quantity.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[3], "../../lineitemWT/p_size.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[4], "../../lineitemWT/output_l_shipmode.txt", 8, 1.0, huge_table_enable);
+  load_shared_column(&columns[5], "../../lineitemWT/output_l_shipinstruct.txt", 8, 1.0, huge_table_enable);
+  uint64_t tuples          = columns[0].num;
+  for (int c = 1; c != 6; ++c)
+    if (columns[c].num < tuples) tuples = columns[c].num;
 
   printf("tuples = %d, thread number = %d, huge_table_enable = %d, T1_bit_width = %d, T2_bit_width = %d, T3_bit_width = %d, prefetch_model = %d\n", 
          tuples,       thread_num,         huge_table_enable,      T1_bit_width,      T2_bit_width,      T3_bit_width,      inst_Monitor_Event.prefetch_model); 
@@ -1126,6 +1000,46 @@ void main(int argc, char **argv)
   task_len.resize(thread_num);
   uint64_t size_for_each_thread = compute_task_len_for_each_thread(task_len, tuples, thread_num);
 
+  //the variant of the kernel: given, or picked by the cost model on the terms of the query.
+  //the three disjuncts relaxed to one conjunction that keeps all of them: the cost model
+  //takes conjunctions only.
+  const uint32_t brands[]     = {literal_1_1, literal_1_2, literal_1_3};
+  const uint32_t containers[] = {literal_2_1_1, literal_2_1_2, literal_2_1_3, literal_2_1_4,
+                                 literal_2_2_1, literal_2_2_2, literal_2_2_3, literal_2_2_4,
+                                 literal_2_3_1, literal_2_3_2, literal_2_3_3, literal_2_3_4};
+  const uint32_t shipmodes[]  = {literal_5_1, literal_5_2};
+  ColumnPredicate terms[] = {
+    in_list_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      brands, sizeof(brands)/sizeof(brands[0])),
+    in_list_predicate(columns[1].data, columns[1].kNumBytesPerCode, columns[1].kNumPaddingBits,
+                      containers, sizeof(containers)/sizeof(containers[0])),
+    literal_predicate(columns[2].data, columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits,
+                      Comparator::kGreaterEqual, literal_3_1_1),
+    literal_predicate(columns[2].data, columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits,
+                      Comparator::kLessEqual, literal_3_3_2),
+    literal_predicate(columns[3].data, columns[3].kNumBytesPerCode, columns[3].kNumPaddingBits,
+                      Comparator::kGreaterEqual, literal_4_1_1),
+    literal_predicate(columns[3].data, columns[3].kNumBytesPerCode, columns[3].kNumPaddingBits,
+                      Comparator::kLessEqual, literal_4_3_2),
+    in_list_predicate(columns[4].data, columns[4].kNumBytesPerCode, columns[4].kNumPaddingBits,
+                      shipmodes, sizeof(shipmodes)/sizeof(shipmodes[0])),
+    literal_predicate(columns[5].data, columns[5].kNumBytesPerCode, columns[5].kNumPaddingBits,
+                      Comparator::kEqual, literal_6)
+  };
+  ExecutionModel model = pick_execution_model(p_s_model_start, terms, sizeof(terms)/sizeof(terms[0]),
+                                              tuples, size_for_each_thread, thread_num);
+
+  uint64_t T1_start = 0;
+
+  //output bit vector of the whole table, and its morsels dealt to the threads.
+  WordUnit *bitmap         = (WordUnit *) malloc_memory(((tuples + 63) >> 6) << 3, huge_table_enable);
+  if (bitmap == NULL)
+  {
+      printf ( "output bitvector_malloc fails\n");
+      return;
+  }
+  morsel_queue_t *morsels  = morsel_queue_create(tuples, MORSEL_LEN, thread_num);
+
 
     //initialize 20 barriers to sync between threads.
 	int b, barrier_num = 20;
@@ -1138,23 +1052,14 @@ void main(int argc, char **argv)
 	uint64_t times[3][thread_num];
 	size_t set_bits[thread_num];
 	
-	//for affinity setting.
-    pthread_t tid[thread_num];
-    pthread_attr_t attr;
-    cpu_set_t set; //cpu_set_t *set = (cpu_set_t *) malloc (sizeof (cpu_set_t)); //
-    pthread_attr_init(&attr);
+	//the workers are started, and pinned with get_cpu_id, once per process.
+    worker_pool_t *pool = worker_pool_global(thread_num);
+    assert(worker_pool_size(pool) == thread_num);
 		
 	//printf("HHHHHHHHHHHHHHHHHtest 1\n"); //OK
 	 
 	for (t = 0 ; t != thread_num ; ++t) 
 	{
-	    //for affinity setting.		
-        int cpu_idx = get_cpu_id(t);
-        //DEBUGMSG(1, "Assigning thread-%d to CPU-%d\n", i, cpu_idx);
-        CPU_ZERO(&set);
-        CPU_SET(cpu_idx, &set);
-        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
-
         info[t].seed              = rand();
 		info[t].huge_table_enable = huge_table_enable;
 		info[t].T1_bit_width      = T1_bit_width;
@@ -1163,6 +1068,7 @@ void main(int argc, char **argv)
 		
 		info[t].p_s_model_start   = p_s_model_start;
 		info[t].p_s_model_end     = p_s_model_end;
+		info[t].model             = model;
 		
 		info[t].T1_selevitity     = T1_selevitity;
 		info[t].T2_selevitity     = T2_selevitity;
@@ -1176,15 +1082,23 @@ void main(int argc, char **argv)
 		info[t].times[1] = times[1];
 		info[t].times[2] = times[2];
 		
-		info[t].T1_len          = tuples;  //task_len[t]; //same for all the threads (64*), except the last one 
-		printf("task_len[%d] = %d\n", t, task_len[t]);
+		info[t].columns         = columns;
+		info[t].bitmap          = bitmap;
+		info[t].morsels         = morsels;
+		info[t].T1_start        = T1_start;
+		info[t].T1_len          = task_len[t]; //same for all the threads (64*), except the last one 
+		T1_start               += task_len[t];
 		
-		pthread_create(&info[t].id, &attr, run, (void*) &info[t]); //&info[t].id, NULL
 	}
 	
-   //finish the execution of all threads......	
-	for (t = 0 ; t != thread_num ; ++t)
-		pthread_join(info[t].id, NULL);
+   //run the query on all the workers, and wait for them.
+	worker_pool_run(pool, run, info, sizeof(info_t));
+	printf("morsels stolen: %llu\n", (unsigned long long) morsel_queue_steals(morsels));
+
+	for (int c = 0; c != 6; ++c)
+		free_shared_column(&columns[c]);
+	free_memory(bitmap, huge_table_enable);
+	morsel_queue_destroy(morsels);
 	
 	
 	
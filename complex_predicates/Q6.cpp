@@ -38,6 +38,7 @@
 #include "memory_tool.h"
 #include "rand_tool.h"
 #include "perf_counters.h"
+#include "n_column_compare_with_literal.h"
 #include "3_column_compare_with_literal.h" 
 
 
@@ -90,7 +91,8 @@ void print256_num_neg(AvxUnit var)
 #define PREDICATE_TYPE Bitwise::kAnd
 	 
 	 
-void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len, 
+template <bool PREFETCH, bool STREAM>
+void Q6_cmp_with_literal(WordUnit* bitmap, WordUnit len, 
                                   ByteUnit** data_1, uint32_t literal_1, size_t kNumBytesPerCode_1, size_t kNumPaddingBits_1,
 								  ByteUnit** data_2, uint32_t literal_2, size_t kNumBytesPerCode_2, size_t kNumPaddingBits_2,
 								  ByteUnit** data_3, uint32_t literal_3, size_t kNumBytesPerCode_3, size_t kNumPaddingBits_3,
@@ -164,119 +166,55 @@ void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
         //need several iteration of AVX scan
         for(size_t i=0; i < NUM_WORD_BITS; i += NUM_AVX_BITS/8) //generate 64-bit result. 
 		{  
-            AvxUnit m_less_1;
-            AvxUnit m_greater_1;
-            AvxUnit m_equal_1;
-			AvxUnit m_success_1;
-			AvxUnit m_fail_1;
-            AvxUnit m_less_2;
-            AvxUnit m_greater_2;
-            AvxUnit m_equal_2; 			
-			AvxUnit m_success_2;
-			AvxUnit m_fail_2;
-            AvxUnit m_less_3;
-            AvxUnit m_greater_3;
-            AvxUnit m_equal_3; 			
-			AvxUnit m_success_3;
-			AvxUnit m_fail_3;
-			
-            AvxUnit m_less_4;
-            AvxUnit m_greater_4;
-            AvxUnit m_equal_4; 			
-			AvxUnit m_success_4;
-			AvxUnit m_fail_4;
+            //shipdate: predicates 1 and 2 as one range, discount: predicates 3 and 4 as one range.
+            AvxUnit m_greater_1, m_equal_1, m_less_2, m_equal_2;
+            AvxUnit m_equal_12, m_success_12, m_fail_12;
+            AvxUnit m_greater_3, m_equal_3, m_less_4, m_equal_4;
+            AvxUnit m_equal_34, m_success_34, m_fail_34;
             AvxUnit m_less_5;
             AvxUnit m_greater_5;
             AvxUnit m_equal_5; 			
 			AvxUnit m_success_5;
 			AvxUnit m_fail_5;
-			
-			AvxUnit tmpA, tmpB;
-			
-           // bool move_to_next_segment = true;
 
-            _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
-            _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            if (PREFETCH) {
+                _mm_prefetch((char const*)(data_1[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_2[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+                _mm_prefetch((char const*)(data_3[0] + offset + i + PREFETCHING_DISTANCE), HINT_LEVEL);
+            }
 			
-	        ////////////////////////approximate stage: for the first byte./////////////////////////////////
-            computeKernelWithMask_FIRST<FIRST_COMPARISON_TYPE>(avx_load( (void *)(data_1[0]+offset+i)),
+	        ////////////////////////approximate stage: for the first byte, one load per column./////////////////////////////////
+            computeBetweenKernelWithMask_FIRST<FIRST_COMPARISON_TYPE, SECOND_COMPARISON_TYPE>(avx_load( (void *)(data_1[0]+offset+i)),
                                                           mask_literal_1[0],
-                                                          m_less_1,
+                                                          mask_literal_2[0],
                                                           m_greater_1,
                                                           m_equal_1,
-                                                          m_success_1,
-                                                          m_fail_1);             		 
-#ifdef DEBUG_EN
-  printf("data_1: \n");
-  print256_num_neg( avx_load( (void *)(data_1[0]+offset+i)) );
-  printf("mask_literal_1: \n");
-  print256_num_neg( mask_literal_1[0]);
-  printf("m_greater_1: \n");
-  print256_num(  m_greater_1);
-  printf("m_less_1: \n");
-  print256_num(  m_less_1);
-  printf("m_equal_1: \n");
-  print256_num(  m_equal_1);
-#endif	
-            computeKernelWithMask_FIRST<SECOND_COMPARISON_TYPE>(avx_load( (void *)(data_1[0]+offset+i)),
-                                                          mask_literal_2[0],
                                                           m_less_2,
-                                                          m_greater_2,
                                                           m_equal_2,
-                                                          m_success_2,
-                                                          m_fail_2);    			
+                                                          m_equal_12,
+                                                          m_success_12,
+                                                          m_fail_12);
 #ifdef DEBUG_EN
   printf("data_1: \n");
   print256_num_neg( avx_load( (void *)(data_1[0]+offset+i)) );
-  printf("mask_literal_2: \n");
-  print256_num_neg( mask_literal_2[0]);
-  printf("m_greater_2: \n");
-  print256_num(  m_greater_2);
-  printf("m_less_2: \n");
-  print256_num( m_less_2);
-  printf("m_equal_2: \n");
-  print256_num( m_equal_2);
+  printf("m_equal_12: \n");
+  print256_num(  m_equal_12);
 #endif	
-														  
-            computeKernelWithMask_LAST<THIRD_COMPARISON_TYPE>(avx_load( (void *)(data_2[0]+offset+i)),
+            computeBetweenKernelWithMask_LAST<THIRD_COMPARISON_TYPE, FOURTH_COMPARISON_TYPE>(avx_load( (void *)(data_2[0]+offset+i)),
                                                           mask_literal_3[0],
-                                                          m_less_3,
+                                                          mask_literal_4[0],
                                                           m_greater_3,
                                                           m_equal_3,
-                                                          m_success_3,
-                                                          m_fail_3);    			
-#ifdef DEBUG_EN
-  printf("data_2: \n");
-  print256_num_neg( avx_load( (void *)(data_2[0]+offset+i)) );
-  printf("mask_literal_3: \n");
-  print256_num_neg( mask_literal_3[0]);
-  printf("m_greater_3: \n");
-  print256_num( m_greater_3);
-  printf("m_less_3: \n");
-  print256_num( m_less_3);
-  printf("m_equal_3: \n");
-  print256_num( m_equal_3);
-#endif	
-
-            computeKernelWithMask_LAST<FOURTH_COMPARISON_TYPE>(avx_load( (void *)(data_2[0]+offset+i)),
-                                                          mask_literal_4[0],
                                                           m_less_4,
-                                                          m_greater_4,
                                                           m_equal_4,
-                                                          m_success_4,
-                                                          m_fail_4);   
+                                                          m_equal_34,
+                                                          m_success_34,
+                                                          m_fail_34);
 #ifdef DEBUG_EN
   printf("data_2: \n");
   print256_num_neg( avx_load( (void *)(data_2[0]+offset+i)) );
-  printf("mask_literal_4: \n");
-  print256_num_neg( mask_literal_4[0]);
-  printf("m_greater_4: \n");
-  print256_num( m_greater_4);
-  printf("m_less_4: \n");
-  print256_num( m_less_4);
-  printf("m_equal_4: \n");
-  print256_num( m_equal_4);
+  printf("m_success_34: \n");
+  print256_num(  m_success_34);
 #endif	
             computeKernelWithMask_LAST<FIFTH_COMPARISON_TYPE>(avx_load( (void *)(data_3[0]+offset+i)),
                                                           mask_literal_5[0],
@@ -288,57 +226,29 @@ void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 #ifdef DEBUG_EN
   printf("data_3: \n");
   print256_num_neg( avx_load( (void *)(data_3[0]+offset+i)) );
-  printf("mask_literal_5: \n");
-  print256_num_neg( mask_literal_5[0]);
-  printf("m_greater_5: \n");
-  print256_num( m_greater_5);
   printf("m_less_5: \n");
   print256_num( m_less_5);
-  printf("m_equal_5: \n");
-  print256_num( m_equal_5);
 #endif	            
-            			
-														  
-          //aggregating the information from all the columns.//// 
+
           //aggregating the information from all the columns.//// 
-			  AvxUnit agg_equal,   agg_equal_a,   agg_equal_b,   agg_equal_c;
-			  AvxUnit agg_success, agg_success_a, agg_success_b, agg_success_c;
-			  AvxUnit agg_fail,    agg_fail_a,    agg_fail_b,    agg_fail_c;		  
-              computeForEarlyStop<PREDICATE_TYPE>(m_equal_1,
-                                                  m_success_1,
-                                                  m_fail_1,
-                                                  m_equal_2,
-                                                  m_success_2,
-                                                  m_fail_2,
+			  AvxUnit agg_equal,   agg_equal_a;
+			  AvxUnit agg_success, agg_success_a;
+			  AvxUnit agg_fail,    agg_fail_a;
+              computeForEarlyStop<PREDICATE_TYPE>(m_equal_12,
+                                                  m_success_12,
+                                                  m_fail_12,
+                                                  m_equal_34,
+                                                  m_success_34,
+                                                  m_fail_34,
                                                   agg_equal_a,
                                                   agg_success_a,
                                                   agg_fail_a); 
-              computeForEarlyStop<PREDICATE_TYPE>(m_equal_3,
-                                                  m_success_3,
-                                                  m_fail_3,
-                                                  m_equal_4,
-                                                  m_success_4,
-                                                  m_fail_4,
-                                                  agg_equal_b,
-                                                  agg_success_b,
-                                                  agg_fail_b); 
-												   
               computeForEarlyStop<PREDICATE_TYPE>(agg_equal_a,
                                                   agg_success_a,
                                                   agg_fail_a,
                                                   m_equal_5,
                                                   m_success_5,
                                                   m_fail_5,
-                                                  agg_equal_c,
-                                                  agg_success_c,
-                                                  agg_fail_c); 
-												  
-              computeForEarlyStop<PREDICATE_TYPE>(agg_equal_c,
-                                                  agg_success_c,
-                                                  agg_fail_c,
-                                                  agg_equal_b,
-                                                  agg_success_b,
-                                                  agg_fail_b,
                                                   agg_equal,
                                                   agg_success,
                                                   agg_fail); 
@@ -346,75 +256,41 @@ void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
   printf("agg_equal: \n");
   print256_num(agg_equal);
 #endif	
-          //refine stage.		  
-		  if (!avx_iszero(agg_equal))
+          //refine stage: the second byte slice of shipdate is loaded once for both bounds.
+		  if ( (kNumBytesPerCode_1 > 1) && (!avx_iszero(agg_equal)) )
 		  {      
-            m_equal_1 = avx_and(m_equal_1, agg_equal);
-            m_equal_2 = avx_and(m_equal_2, agg_equal);
-
-	        if ( (kNumBytesPerCode_1 > 1) && ((!avx_iszero( m_equal_1)) || (!avx_iszero( m_equal_2))) ) //for the remaining segments of predicate 1.
-			{
-				ByteUnit *addr_tmp   = data_1[1] + offset + i;
-                tmpA                 =  avx_load( (void *)addr_tmp ); //_mm256_loadu_si256( reinterpret_cast<__m256i*>(addr_tmp) ); //data_1[1]+offset+i
-                tmpB                 =  mask_literal_1[1];
-                computeKernelWithMask<FIRST_COMPARISON_TYPE>(tmpA,
-                                                             tmpB,
-                                                             m_less_1,
-                                                             m_greater_1,
-                                                             m_equal_1,
-                                                             m_success_1,
-                                                             m_fail_1);
-
-                tmpB                 =  mask_literal_2[1];
-               computeKernelWithMask<SECOND_COMPARISON_TYPE>(tmpA,
-                                                             tmpB,
-                                                             m_less_2,
-                                                             m_greater_2,
-                                                             m_equal_2,
-                                                             m_success_2,
-                                                             m_fail_2);
-			}
+            m_equal_12 = avx_and(m_equal_12, agg_equal);
+            computeBetweenKernelWithMask<FIRST_COMPARISON_TYPE, SECOND_COMPARISON_TYPE>(avx_load( (void *)(data_1[1]+offset+i)),
+                                                          mask_literal_1[1],
+                                                          mask_literal_2[1],
+                                                          m_greater_1,
+                                                          m_equal_1,
+                                                          m_less_2,
+                                                          m_equal_2,
+                                                          m_equal_12,
+                                                          m_success_12,
+                                                          m_fail_12);
 		  }
 		   
             /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
-			   AvxUnit m_result_1, m_result_2, m_result_3, m_result_4, m_result_5, m_result_tmp, m_result_tmp_1, m_result_tmp_2, m_result;
-
-               computeMask_one_predicate<FIRST_COMPARISON_TYPE>(
-							     m_equal_1,
-                                 m_greater_1,
-                                 m_less_1,
-			                     m_result_1 );
-               computeMask_one_predicate<SECOND_COMPARISON_TYPE>(
-							     m_equal_2,
-                                 m_greater_2,
+			   AvxUnit m_result_12, m_result_5, m_result_tmp, m_result;
+
+               computeMask_between<FIRST_COMPARISON_TYPE, SECOND_COMPARISON_TYPE>(
+							     m_greater_1,
+                                 m_equal_1,
                                  m_less_2,
-			                     m_result_2 );	
-               computeMask_one_predicate<THIRD_COMPARISON_TYPE>(
-							     m_equal_3,
-                                 m_greater_3,
-                                 m_less_3,
-			                     m_result_3 );	
-               computeMask_one_predicate<FOURTH_COMPARISON_TYPE>(
-							     m_equal_4,
-                                 m_greater_4,
-                                 m_less_4,
-			                     m_result_4 );		
+                                 m_equal_2,
+			                     m_result_12 );
                computeMask_one_predicate<FIFTH_COMPARISON_TYPE>(
 							     m_equal_5,
                                  m_greater_5,
                                  m_less_5,
 			                     m_result_5 );									 
-               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_1,
-                                                            m_result_2,
+               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_12,
+                                                            m_success_34,
 							                                m_result_tmp);
-               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_3,
-                                                            m_result_4,
-							                                m_result_tmp_1);
-               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_5,
-							                                m_result_tmp,
-															m_result_tmp_2);															
-               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_tmp_2,
-                                                            m_result_tmp_1,
+               computeConjunctivePredicates<PREDICATE_TYPE>(m_result_tmp,
+                                                            m_result_5,
 							                                m_result);
 		
             uint32_t mmask = _mm256_movemask_epi8(m_result);
@@ -423,7 +299,10 @@ void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
             bitvector_word |= (static_cast<WordUnit>(mmask) << (i));
         }
         WordUnit x          = bitvector_word;
-	    _mm_stream_si64((__int64*) &bitmap[bv_word_id], x); //bitmap[bv_word_id]  = x; //
+        if (STREAM)
+            _mm_stream_si64((__int64*) &bitmap[bv_word_id], x);
+        else
+            bitmap[bv_word_id] = x;
 
     }
 } 
@@ -432,6 +311,13 @@ void Q6_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
 
 
 
+//the variants of the kernel, indexed by ExecutionModel.
+typedef decltype(&Q6_cmp_with_literal<false, false>) Q6_kernel_t;
+static const Q6_kernel_t Q6_kernels[4] = {
+    Q6_cmp_with_literal<false, false>, Q6_cmp_with_literal<false, true>,
+    Q6_cmp_with_literal<true,  false>, Q6_cmp_with_literal<true,  true>
+};
+
 struct Monitor_Event inst_Monitor_Event = {
 	{
 		{0,0},
@@ -464,7 +350,6 @@ struct Monitor_Event inst_Monitor_Event = {
 
 
 typedef struct {
-	pthread_t id;
 
 	int thread;
 	int threads;
@@ -472,6 +357,7 @@ typedef struct {
 	bool huge_table_enable;
 	uint32_t p_s_model_start;
 	uint32_t p_s_model_end;
+	ExecutionModel model;      //variant of the kernel, picked once in main.
  	
     int       seed;
 	uint64_t *times[3];
@@ -486,17 +372,26 @@ typedef struct {
     float    T3_selevitity;
 	
     uint64_t T1_len;     //size of table T1 for the current thread.
+    uint64_t T1_start;   //first code of table T1 for the current thread.
+    shared_column_t *columns; //input columns, shared by all the threads.
+    WordUnit *bitmap;         //output bit vector of the whole table T1, shared by all the threads.
+    morsel_queue_t *morsels;  //morsels of table T1, scheduled with work stealing.
     uint64_t T2_len;     //size of table T2 for the current thread.
     uint64_t T3_len;     //size of table T2 for the current thread.	
 } info_t;
 
 
+//literals of the query.
+uint32_t literal_1   = 1488; //1994-1-1  
+uint32_t literal_2   = 1860; //1995-1-1
+uint32_t literal_3   = 5;    //discount:0.05
+uint32_t literal_4   = 7;    //discount:0.07
+uint32_t literal_5   = 24;   //quatity:24
+
 void *run(void *arg)
 {
 	info_t *d = (info_t*) arg;
 	
-	assert(pthread_equal(pthread_self(), d->id));
-	bind_thread(d->thread, d->threads);	
 
 	rand32_t *gen              = rand32_init(d->seed);
 	pthread_barrier_t *barrier = d->barrier;
@@ -522,11 +417,6 @@ void *run(void *arg)
     int kNumBytesPerCode_3       = (T3_bit_width+7)/8;
 	int kNumPaddingBits_3        = kNumBytesPerCode_3 * 8 - T3_bit_width;
 
-        uint32_t literal_1   = 1488; //1994-1-1  
-	    uint32_t literal_2   = 1860; //1995-1-1
-        uint32_t literal_3   = 5;    //discount:0.05
-        uint32_t literal_4   = 7;    //discount:0.07
-        uint32_t literal_5   = 24;   //quatity:24
 		
 		
   ///////////////////////Generate the input output data..///////////////////////////////////////	
@@ -535,109 +425,12 @@ void *run(void *arg)
 	WordUnit *bitvector;                //ourput bit map for the original data. 
     uint64_t T1_len_aligned = ( ((T1_len + 63)>>6)<<6 ); //upper boundary to 64-byte alignment.
 	
-  ///////////////////////allocate space for input data and output bit vector///////////////////////////////////////	
-   original_1               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_1 == NULL) 
-   {
-         printf ( "input original_malloc 1 fails\n");
-         return NULL;
-   }
-   original_2               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_2 == NULL) 
-   {
-         printf ( "input original_malloc 2 fails\n");
-         return NULL;
-   }
-   original_3               = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
-   if (original_3 == NULL) 
-   {
-         printf ( "input original_malloc 3 fails\n");
-         return NULL;
-   }   
-   //consider to use 2M huge table.
-   bitvector              = (WordUnit *) malloc_memory(T1_len_aligned/8, huge_table_enable);//use 4K page.	
-   if (bitvector == NULL) 
-   {
-         printf ( "output bitvector_malloc fails\n");
-         return NULL;
-   }
+  ///////////////////////attach to the shared input columns and output bit vector///////////////////////
+   original_1               = d->columns[0].codes + d->T1_start;
+   original_2               = d->columns[1].codes + d->T1_start;
+   original_3               = d->columns[2].codes + d->T1_start;
 
-   
-   for (i = 0; i < 4; i++) // malloc memory space for two codes. 
-   {
-      data_1[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit)*4, huge_table_enable);	  
-	  if (data_1[i] == NULL) {
-            printf ( "&data_1[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }
-      data_2[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_2[i] == NULL) {
-            printf ( "&data_2[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }		
-      data_3[i]      = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);	  
-	  if (data_3[i] == NULL) {
-            printf ( "&data_3[%d]_malloc for two column fails\n", i);
-            return NULL;
-         }				 
-   }   
-   
-   
-   
-//	  pthread_barrier_wait(barrier++);
-	  FILE *fp_l_shipdate, *fp_l_discount, *fp_l_quantity;//
-	  char str[128];
-	  uint32_t tmp;
-      float    tmp_f;
-  //1....................: output_l_shipdate.txt
-      if((fp_l_shipdate=fopen("../../lineitemWT/output_l_shipdate.txt","r"))==NULL) {
-        printf("cannot open output_l_shipdate.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_shipdate, "%d\n", &tmp) > 0) { 
-         original_1[i]       = tmp; //tmp_cons; //
-         SetTuple(data_1,  i, tmp,  kNumBytesPerCode_1, kNumPaddingBits_1);		  
-	     i++;
-      }
-      fclose(fp_l_shipdate);
-  //2....................: l_discount.txt
-      if((fp_l_discount=fopen("../../lineitemWT/l_discount.txt","r"))==NULL) {
-        printf("cannot open l_discount.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_discount, "%f\n", &tmp_f) > 0) { 
-	     if ( (tmp_f < 0.0) || (tmp_f > 1.0))
-		 {  
-			printf("l_discount ERROR::::::::tmp_f = %f\n", tmp_f); 
-        	break;
-		 }
-		 tmp = (uint32_t) (tmp_f*100.0);
-         original_2[i]       = tmp; //tmp_cons; //
-         SetTuple(data_2,  i, tmp,  kNumBytesPerCode_2, kNumPaddingBits_2);		  
-	     i++;
-      }
-      fclose(fp_l_discount);
-  //3....................: l_quantity.txt
-      if((fp_l_quantity=fopen("../../lineitemWT/l_quantity.txt","r"))==NULL) {
-        printf("cannot open l_quantity.txt/n");
-        exit(1);
-      }
-	  i = 0;
-      while(fscanf(fp_l_quantity, "%f\n", &tmp_f) > 0) { 
-	     if ( (tmp_f < 0.0) || (tmp_f > 128.0))
-		 {  
-			printf("l_quantity ERROR::::::::tmp_f = %f\n", tmp_f); 
-        	break;
-		 }
-		 tmp = (uint32_t) tmp_f;
-         //if (i < 10) printf("tmp = %d\n", tmp);		 
-         original_3[i]       = tmp; //tmp_cons; //
-         SetTuple(data_3,  i, tmp,  kNumBytesPerCode_3, kNumPaddingBits_3);		  
-	     i++;
-      }
-      fclose(fp_l_quantity);
+   bitvector               = d->bitmap + (d->T1_start >> 6); //this thread's range, first touched by it below.
 
 
 
@@ -648,6 +441,8 @@ void *run(void *arg)
    }
 
 		
+   Q6_kernel_t kernel = Q6_kernels[d->model];
+
    ///////////////////////first barrier: make sure all threads have finished the initialization.///////////////////////
    //////////Otherwise, the writing operations from the above might increase the memory read/write operations./////////
    pthread_barrier_wait(barrier++);
@@ -665,13 +460,21 @@ void *run(void *arg)
 		uint64_t t1 = thread_time(); //
 	    //T1_len = 64;
 		
-                    Q6_cmp_with_literal_P_S(bitvector, T1_len, 
+                    //morsels of the whole table: its own ones first, then stolen from the other threads.
+                    uint64_t morsel_start, morsel_len;
+                    while (morsel_queue_next(d->morsels, d->thread, &morsel_start, &morsel_len))
+                    {
+                       slice_shared_column(&d->columns[0], morsel_start, data_1);
+                       slice_shared_column(&d->columns[1], morsel_start, data_2);
+                       slice_shared_column(&d->columns[2], morsel_start, data_3);
+                       kernel(d->bitmap + (morsel_start >> 6), morsel_len, 
                                             data_1, literal_1, kNumBytesPerCode_1, kNumPaddingBits_1,
 								            data_2, literal_2, kNumBytesPerCode_2, kNumPaddingBits_2,
                                             data_3, literal_3, kNumBytesPerCode_3, kNumPaddingBits_3,
 											        literal_4, 
 													literal_5
-								           ); 
+								           );
+                    } 
 										   
 	  pthread_barrier_wait(barrier++);
 		 t1 = thread_time() - t1;
@@ -730,7 +533,7 @@ void *run(void *arg)
 	//free(compressed);
 	//free(decompressed);
 	//free(bitmap);
-	pthread_exit(NULL);
+	return NULL;
 }
 
 
@@ -743,7 +546,7 @@ void main(int argc, char **argv)
   uint32_t  T2_bit_width   = argc > 4 ? atoi(argv[4]) : 17;                 //default bit width for 2nd column
   uint32_t  T3_bit_width   = argc > 5 ? atoi(argv[5]) : 17;                 //default bit width for 2nd column
   uint32_t  prefetch_model = argc > 6 ? atoi(argv[6]) : 0;                  //default: enable prefetcher
-  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 0;                  //0:nP_nS, 1:nP_S, 2:P_ns, 3:P_S,   
+  uint32_t  p_s_model_start= argc > 7 ? atoi(argv[7]) : 4;                  //0:nP_nS, 1:nP_S, 2:P_nS, 3:P_S, 4:cost model
   uint32_t  p_s_model_end  = argc > 8 ? atoi(argv[8]) : 0;                  //4:pf_nP_nS, 1:pf_nP_S, 2:pf_P_ns, 3:pf_P_S,   
   float     T1_selevitity  = argc > 9 ?  atof(argv[9])  : 0.5; 
   float     T2_selevitity  = argc > 10 ? atof(argv[10]) : 0.5; 
@@ -752,7 +555,14 @@ void main(int argc, char **argv)
   if (prefetch_model != 0)  
     inst_Monitor_Event.prefetch_model = prefetch_model;
     
-  uint64_t tuples          = 60490115;//1000000000; //
+  //load every input column once; each thread scans its own range of the same copy.
+  shared_column_t columns[3];
+  load_shared_column(&columns[0], "../../lineitemWT/output_l_shipdate.txt", 12, 1.0, huge_table_enable);
+  load_shared_column(&columns[1], "../../lineitemWT/l_discount.txt", 8, 100.0, huge_table_enable);
+  load_shared_column(&columns[2], "../../lineitemWT/l_quantity.txt", 8, 1.0, huge_table_enable);
+  uint64_t tuples          = columns[0].num;
+  for (int c = 1; c != 3; ++c)
+    if (columns[c].num < tuples) tuples = columns[c].num;
 
   printf("tuples = %d, thread number = %d, huge_table_enable = %d, T1_bit_width = %d, T2_bit_width = %d, T3_bit_width = %d, prefetch_model = %d\n", 
          tuples,       thread_num,         huge_table_enable,      T1_bit_width,      T2_bit_width,      T3_bit_width,      inst_Monitor_Event.prefetch_model); 
@@ -766,6 +576,33 @@ void main(int argc, char **argv)
   task_len.resize(thread_num);
   uint64_t size_for_each_thread = compute_task_len_for_each_thread(task_len, tuples, thread_num);
 
+  //the variant of the kernel: given, or picked by the cost model on the terms of the query.
+  ColumnPredicate terms[] = {
+    literal_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      Comparator::kGreaterEqual, literal_1),
+    literal_predicate(columns[0].data, columns[0].kNumBytesPerCode, columns[0].kNumPaddingBits,
+                      Comparator::kLess, literal_2),
+    literal_predicate(columns[1].data, columns[1].kNumBytesPerCode, columns[1].kNumPaddingBits,
+                      Comparator::kGreaterEqual, literal_3),
+    literal_predicate(columns[1].data, columns[1].kNumBytesPerCode, columns[1].kNumPaddingBits,
+                      Comparator::kLessEqual, literal_4),
+    literal_predicate(columns[2].data, columns[2].kNumBytesPerCode, columns[2].kNumPaddingBits,
+                      Comparator::kLess, literal_5)
+  };
+  ExecutionModel model = pick_execution_model(p_s_model_start, terms, sizeof(terms)/sizeof(terms[0]),
+                                              tuples, size_for_each_thread, thread_num);
+
+  uint64_t T1_start = 0;
+
+  //output bit vector of the whole table, and its morsels dealt to the threads.
+  WordUnit *bitmap         = (WordUnit *) malloc_memory(((tuples + 63) >> 6) << 3, huge_table_enable);
+  if (bitmap == NULL)
+  {
+      printf ( "output bitvector_malloc fails\n");
+      return;
+  }
+  morsel_queue_t *morsels  = morsel_queue_create(tuples, MORSEL_LEN, thread_num);
+
 
     //initialize 20 barriers to sync between threads.
 	int b, barrier_num = 20;
@@ -778,23 +615,14 @@ void main(int argc, char **argv)
 	uint64_t times[3][thread_num];
 	size_t set_bits[thread_num];
 	
-	//for affinity setting.
-    pthread_t tid[thread_num];
-    pthread_attr_t attr;
-    cpu_set_t set; //cpu_set_t *set = (cpu_set_t *) malloc (sizeof (cpu_set_t)); //
-    pthread_attr_init(&attr);
+	//the workers are started, and pinned with get_cpu_id, once per process.
+    worker_pool_t *pool = worker_pool_global(thread_num);
+    assert(worker_pool_size(pool) == thread_num);
 		
 	//printf("HHHHHHHHHHHHHHHHHtest 1\n"); //OK
 	 
 	for (t = 0 ; t != thread_num ; ++t) 
 	{
-	    //for affinity setting.		
-        int cpu_idx = get_cpu_id(t);
-        //DEBUGMSG(1, "Assigning thread-%d to CPU-%d\n", i, cpu_idx);
-        CPU_ZERO(&set);
-        CPU_SET(cpu_idx, &set);
-        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
-
         info[t].seed              = rand();
 		info[t].huge_table_enable = huge_table_enable;
 		info[t].T1_bit_width      = T1_bit_width;
@@ -803,6 +631,7 @@ void main(int argc, char **argv)
 		
 		info[t].p_s_model_start   = p_s_model_start;
 		info[t].p_s_model_end     = p_s_model_end;
+		info[t].model             = model;
 		
 		info[t].T1_selevitity     = T1_selevitity;
 		info[t].T2_selevitity     = T2_selevitity;
@@ -816,14 +645,23 @@ void main(int argc, char **argv)
 		info[t].times[1] = times[1];
 		info[t].times[2] = times[2];
 		
+		info[t].columns         = columns;
+		info[t].bitmap          = bitmap;
+		info[t].morsels         = morsels;
+		info[t].T1_start        = T1_start;
 		info[t].T1_len          = task_len[t]; //same for all the threads (64*), except the last one 
+		T1_start               += task_len[t];
 		//printf("task_len[%d] = %d\n", t, task_len[t]);
-		pthread_create(&info[t].id, &attr, run, (void*) &info[t]); //&info[t].id, NULL
 	}
 	
-   //finish the execution of all threads......	
-	for (t = 0 ; t != thread_num ; ++t)
-		pthread_join(info[t].id, NULL);
+   //run the query on all the workers, and wait for them.
+	worker_pool_run(pool, run, info, sizeof(info_t));
+	printf("morsels stolen: %llu\n", (unsigned long long) morsel_queue_steals(morsels));
+
+	for (int c = 0; c != 3; ++c)
+		free_shared_column(&columns[c]);
+	free_memory(bitmap, huge_table_enable);
+	morsel_queue_destroy(morsels);
 	
 	
 	
@@ -0,0 +1,61 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: run-time switch between the pruning and the non-pruning refine stage
+ * (see ADAPTIVE_PRUNING_ENABLE in config.h).
+ * Pruning skips the later byte slices when the aggregated masks of all the columns
+ * decide every code of the segment. It costs a branch per segment, which only pays
+ * off on skewed data. The scan starts with pruning and counts the segments where it
+ * saved a refine stage (some column was still undecided). A window with fewer than
+ * ADAPTIVE_PRUNING_MIN_HITS hits turns pruning off for ADAPTIVE_PRUNING_BACKOFF windows,
+ * then the next window probes pruning again.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef ADAPTIVE_PRUNING_H
+#define ADAPTIVE_PRUNING_H
+
+#include    <cstddef>
+
+#define ADAPTIVE_PRUNING_WINDOW   (256)  //segments (of 32 codes) per window.
+#define ADAPTIVE_PRUNING_MIN_HITS (8)    //hits per window to keep pruning.
+#define ADAPTIVE_PRUNING_BACKOFF  (16)   //windows without pruning before probing again.
+
+struct AdaptivePruning{
+    bool   enabled;      //pruning in the current window.
+    size_t segments;     //segments done in the current window.
+    size_t hits;         //segments whose refine stage was skipped by pruning.
+    size_t windows_off;  //windows left without pruning.
+};
+
+static inline void adaptive_pruning_init(AdaptivePruning &state)
+{
+    state.enabled     = true;
+    state.segments    = 0;
+    state.hits        = 0;
+    state.windows_off = 0;
+}
+
+//called once per segment, after its refine stage.
+static inline void adaptive_pruning_next_segment(AdaptivePruning &state)
+{
+    if(++state.segments < ADAPTIVE_PRUNING_WINDOW)
+        return;
+
+    state.segments = 0;
+    if(state.enabled){
+        if(state.hits < ADAPTIVE_PRUNING_MIN_HITS){
+            state.enabled     = false;
+            state.windows_off = ADAPTIVE_PRUNING_BACKOFF;
+        }
+        state.hits = 0;
+    }
+    else if(--state.windows_off == 0){
+        state.enabled = true;
+    }
+}
+
+#endif
@@ -344,6 +344,156 @@ inline void computeKernelWithMask(const AvxUnit &byteslice1,
         }
 } 
 
+//range (CMP_LO: kGreater/kGreaterEqual, CMP_HI: kLess/kLessEqual): both bounds are
+//compared with the same byte slice. A code stays equal (undecided) while it ties one
+//bound and has not failed the other one, so the range is decided as a single predicate.
+template <Comparator CMP_LO, Comparator CMP_HI>
+inline void computeBetweenKernelWithMask_FIRST(const AvxUnit &byteslice1,
+                                               const AvxUnit &byteslice_lo,
+                                               const AvxUnit &byteslice_hi,
+                                                     AvxUnit &mask_greater_lo,
+                                                     AvxUnit &mask_equal_lo,
+                                                     AvxUnit &mask_less_hi,
+                                                     AvxUnit &mask_equal_hi,
+                                                     AvxUnit &mask_equal,
+                                                     AvxUnit &mask_success,
+                                                     AvxUnit &mask_fail)
+{
+        mask_greater_lo  = avx_cmpgt<ByteUnit>(byteslice1, byteslice_lo);
+        mask_equal_lo    = avx_cmpeq<ByteUnit>(byteslice1, byteslice_lo);
+        mask_less_hi     = avx_cmplt<ByteUnit>(byteslice1, byteslice_hi);
+        mask_equal_hi    = avx_cmpeq<ByteUnit>(byteslice1, byteslice_hi);
+        mask_success     = avx_and(mask_greater_lo, mask_less_hi);
+        mask_fail        = avx_not(avx_and(avx_or(mask_greater_lo, mask_equal_lo), avx_or(mask_less_hi, mask_equal_hi)));
+        mask_equal       = avx_not(avx_or(mask_success, mask_fail));
+}
+
+//range on 1-byte codes: the first byte slice is also the last one, so it is decided.
+template <Comparator CMP_LO, Comparator CMP_HI>
+inline void computeBetweenKernelWithMask_LAST(const AvxUnit &byteslice1,
+                                              const AvxUnit &byteslice_lo,
+                                              const AvxUnit &byteslice_hi,
+                                                    AvxUnit &mask_greater_lo,
+                                                    AvxUnit &mask_equal_lo,
+                                                    AvxUnit &mask_less_hi,
+                                                    AvxUnit &mask_equal_hi,
+                                                    AvxUnit &mask_equal,
+                                                    AvxUnit &mask_success,
+                                                    AvxUnit &mask_fail)
+{
+        mask_greater_lo  = avx_cmpgt<ByteUnit>(byteslice1, byteslice_lo);
+        mask_equal_lo    = avx_cmpeq<ByteUnit>(byteslice1, byteslice_lo);
+        mask_less_hi     = avx_cmplt<ByteUnit>(byteslice1, byteslice_hi);
+        mask_equal_hi    = avx_cmpeq<ByteUnit>(byteslice1, byteslice_hi);
+        mask_success     = avx_and((CMP_LO == Comparator::kGreaterEqual) ? avx_or(mask_greater_lo, mask_equal_lo) : mask_greater_lo,
+                                   (CMP_HI == Comparator::kLessEqual)    ? avx_or(mask_less_hi, mask_equal_hi)    : mask_less_hi);
+        mask_fail        = avx_not(mask_success);
+        mask_equal       = avx_zero();
+}
+
+//mask_equal may have been pruned by the other predicates since the last byte slice.
+template <Comparator CMP_LO, Comparator CMP_HI>
+inline void computeBetweenKernelWithMask(const AvxUnit &byteslice1,
+                                         const AvxUnit &byteslice_lo,
+                                         const AvxUnit &byteslice_hi,
+                                               AvxUnit &mask_greater_lo,
+                                               AvxUnit &mask_equal_lo,
+                                               AvxUnit &mask_less_hi,
+                                               AvxUnit &mask_equal_hi,
+                                               AvxUnit &mask_equal,
+                                               AvxUnit &mask_success,
+                                               AvxUnit &mask_fail)
+{
+        mask_equal_lo    = avx_and(mask_equal_lo, mask_equal);
+        mask_equal_hi    = avx_and(mask_equal_hi, mask_equal);
+        mask_greater_lo  = avx_or(mask_greater_lo, avx_and(mask_equal_lo, avx_cmpgt<ByteUnit>(byteslice1, byteslice_lo)));
+        mask_less_hi     = avx_or(mask_less_hi,    avx_and(mask_equal_hi, avx_cmplt<ByteUnit>(byteslice1, byteslice_hi)));
+        mask_equal_lo    = avx_and(mask_equal_lo, avx_cmpeq<ByteUnit>(byteslice1, byteslice_lo));
+        mask_equal_hi    = avx_and(mask_equal_hi, avx_cmpeq<ByteUnit>(byteslice1, byteslice_hi));
+        mask_success     = avx_and(mask_greater_lo, mask_less_hi);
+        mask_fail        = avx_not(avx_and(avx_or(mask_greater_lo, mask_equal_lo), avx_or(mask_less_hi, mask_equal_hi)));
+        mask_equal       = avx_not(avx_or(mask_success, mask_fail));
+}
+
+//result of the range after the last byte slice.
+template <Comparator CMP_LO, Comparator CMP_HI>
+inline void computeMask_between(const AvxUnit &input_greater_lo,
+                                const AvxUnit &input_equal_lo,
+                                const AvxUnit &input_less_hi,
+                                const AvxUnit &input_equal_hi,
+                                      AvxUnit &output_mmask)
+{
+    AvxUnit mask_lo = (CMP_LO == Comparator::kGreaterEqual) ? avx_or(input_greater_lo, input_equal_lo) : input_greater_lo;
+    AvxUnit mask_hi = (CMP_HI == Comparator::kLessEqual)    ? avx_or(input_less_hi, input_equal_hi)    : input_less_hi;
+    output_mmask    = avx_and(mask_lo, mask_hi);
+}
+
+//IN-list: the byte slice is loaded once and compared with the byte of every literal.
+//mask_in_equal[l] keeps the codes still equal to literal l, mask_equal is their union.
+inline void computeInKernelWithMask_FIRST(const AvxUnit &byteslice1,
+                                          const AvxUnit *in_literal,
+                                          size_t num_literals,
+                                                AvxUnit *mask_in_equal,
+                                                AvxUnit &mask_equal,
+                                                AvxUnit &mask_success,
+                                                AvxUnit &mask_fail)
+{
+        mask_equal       = avx_zero();
+        for(size_t l = 0; l < num_literals; l++){
+            mask_in_equal[l] = avx_cmpeq<ByteUnit>(byteslice1, in_literal[l]);
+            mask_equal       = avx_or(mask_equal, mask_in_equal[l]);
+        }
+        mask_fail        = avx_not(mask_equal);
+        mask_success     = avx_zero();
+}
+
+//mask_equal may have been pruned by the other predicates since the last byte slice.
+inline void computeInKernelWithMask(const AvxUnit &byteslice1,
+                                    const AvxUnit *in_literal,
+                                    size_t num_literals,
+                                          AvxUnit *mask_in_equal,
+                                          AvxUnit &mask_equal,
+                                          AvxUnit &mask_success,
+                                          AvxUnit &mask_fail)
+{
+        AvxUnit mask_alive = mask_equal;
+        mask_equal       = avx_zero();
+        for(size_t l = 0; l < num_literals; l++){
+            mask_in_equal[l] = avx_and(mask_in_equal[l], avx_and(mask_alive, avx_cmpeq<ByteUnit>(byteslice1, in_literal[l])));
+            mask_equal       = avx_or(mask_equal, mask_in_equal[l]);
+        }
+        mask_fail        = avx_not(mask_equal);
+        mask_success     = avx_zero();
+}
+
+//test every byte of byteslice1 (not flipped) against a 256-bit bitmap of byte values.
+//row_lo[n] holds bit h for value (h << 4 | n) with h < 8, row_hi[n] for h >= 8;
+//both 16-byte rows are repeated in the two 128-bit lanes.
+inline AvxUnit avx_lookup_bitmap(const AvxUnit &byteslice1, const AvxUnit &row_lo, const AvxUnit &row_hi)
+{
+        const AvxUnit nibble = _mm256_set1_epi8(0x0f);
+        const AvxUnit bits   = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        AvxUnit lo  = _mm256_and_si256(byteslice1, nibble);
+        AvxUnit hi  = _mm256_and_si256(_mm256_srli_epi16(byteslice1, 4), nibble);
+        AvxUnit row = _mm256_blendv_epi8(_mm256_shuffle_epi8(row_lo, lo),
+                                         _mm256_shuffle_epi8(row_hi, lo),
+                                         _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+        AvxUnit bit = _mm256_shuffle_epi8(bits, hi);
+        return _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+}
+
+//byte j of the result is 0xff iff bit j of mmask is set (the inverse of _mm256_movemask_epi8).
+inline AvxUnit avx_mask_from_bits(uint32_t mmask)
+{
+        const AvxUnit bits   = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const AvxUnit spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        AvxUnit byte = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(mmask)), spread);
+        return _mm256_cmpeq_epi8(_mm256_and_si256(byte, bits), bits);
+}
+
 template <Bitwise OP>
 inline void computeForEarlyStop(const AvxUnit &input_equal_1,
                                 const AvxUnit &input_success_1,
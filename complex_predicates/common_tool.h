@@ -12,6 +12,8 @@
 
 #include "thread_tool.h"
 #include "file_tool.h"
+#include "worker_pool.h"
+#include "morsel_queue.h"
 
 
 #endif
\ No newline at end of file
@@ -1,3 +1,7 @@
 /*This file is used to configure the different execution models for predicate execution.*/
 
 //#define PRUNING_ENABLE
+
+//switch between pruning and non-pruning at run time, from the recent pruning hit rate
+//(see adaptive_pruning.h). PRUNING_ENABLE takes precedence.
+//#define ADAPTIVE_PRUNING_ENABLE
@@ -9,7 +9,8 @@
  *******************************************************************************/
 
 #include <stdio.h>  /* FILE, fopen */
-#include <stdlib.h> /* exit, perror */
+#include <stdlib.h> /* exit, perror, qsort, getenv */
+#include <string.h> /* strcmp */
 #include <unistd.h> /* sysconf */
 
 #include "cpu_mapping.h"
@@ -19,8 +20,20 @@
 static int inited = 0;
 static int max_cpus;
 static int node_mapping[MAX_NODES];
+static enum cpu_mapping_policy mapping_policy = CPU_MAPPING_SCATTER;
 
-/** 
+/* where a logical CPU sits, from /sys/devices/system/cpu */
+typedef struct {
+    int cpu;
+    int socket;      /* physical_package_id */
+    int l3;          /* first CPU sharing the L3 cache (negative if none) */
+    int core;        /* core_id, unique within a socket */
+    int smt;         /* position among the SMT siblings of the core */
+    int l3_rank;     /* position of the L3 domain within its socket */
+    int core_rank;   /* position of the core within its L3 domain */
+} cpu_info_t;
+
+/**
  * Initializes the cpu mapping from the file defined by CUSTOM_CPU_MAPPING.
  * The mapping used for our machine Intel L5520 is = "8 0 1 2 3 8 9 10 11".
  */
@@ -49,16 +62,187 @@ init_mappings_from_file()
     return 0;
 }
 
-/** 
- * Try custom cpu mapping file first, if does not exist then round-robin
- * initialization among available CPUs reported by the system. 
+/**
+ * Parses a cpu list such as "0-3,8,10-11" from the file into ids.
+ * Returns the number of ids, or 0 if the file cannot be read.
  */
-static void 
+static int
+read_cpu_list(const char *path, int *ids, int max_ids)
+{
+    FILE *fp = fopen(path, "r");
+    int num = 0, first, last, i;
+    char sep;
+    if (fp == NULL)
+        return 0;
+    while (fscanf(fp, "%d", &first) == 1) {
+        last = first;
+        sep  = fgetc(fp);
+        if (sep == '-') {
+            if (fscanf(fp, "%d", &last) != 1)
+                break;
+            sep = fgetc(fp);
+        }
+        for (i = first; i <= last && num < max_ids; i++)
+            ids[num++] = i;
+        if (sep != ',')
+            break;
+    }
+    fclose(fp);
+    return num;
+}
+
+static int
+read_int(const char *path, int default_value)
+{
+    FILE *fp = fopen(path, "r");
+    int value;
+    if (fp == NULL)
+        return default_value;
+    if (fscanf(fp, "%d", &value) != 1)
+        value = default_value;
+    fclose(fp);
+    return value;
+}
+
+/* first CPU sharing the L3 cache with cpu, or -1 if there is no L3 */
+static int
+read_l3_domain(int cpu)
+{
+    char path[128];
+    int index, ids[MAX_NODES];
+    for (index = 0; index < 16; index++) {
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+        int level = read_int(path, -1);
+        if (level < 0)
+            break;
+        if (level == 3) {
+            sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+            return (read_cpu_list(path, ids, MAX_NODES) > 0) ? ids[0] : -1;
+        }
+    }
+    return -1;
+}
+
+static int
+compare_ints(int *a, int *b, int n)
+{
+    int i;
+    for (i = 0; i < n; i++)
+        if (a[i] != b[i])
+            return (a[i] < b[i]) ? -1 : 1;
+    return 0;
+}
+
+static int
+compare_cpus(const void *x, const void *y)
+{
+    const cpu_info_t *a = (const cpu_info_t *) x;
+    const cpu_info_t *b = (const cpu_info_t *) y;
+    switch (mapping_policy) {
+    case CPU_MAPPING_COMPACT: {
+        int ka[5] = {a->socket, a->l3, a->core, a->smt, a->cpu};
+        int kb[5] = {b->socket, b->l3, b->core, b->smt, b->cpu};
+        return compare_ints(ka, kb, 5);
+    }
+    case CPU_MAPPING_PHYSICAL_FIRST: {
+        int ka[5] = {a->smt, a->socket, a->l3, a->core, a->cpu};
+        int kb[5] = {b->smt, b->socket, b->l3, b->core, b->cpu};
+        return compare_ints(ka, kb, 5);
+    }
+    default: {  /* CPU_MAPPING_SCATTER: n-th core of every domain, socket by socket */
+        int ka[5] = {a->smt, a->core_rank, a->l3_rank, a->socket, a->cpu};
+        int kb[5] = {b->smt, b->core_rank, b->l3_rank, b->socket, b->cpu};
+        return compare_ints(ka, kb, 5);
+    }
+    }
+}
+
+/**
+ * Derives the mapping from the topology of the online CPUs.
+ * Returns 0 if /sys/devices/system/cpu is not available.
+ */
+static int
+init_mappings_from_topology()
+{
+    static cpu_info_t cpus[MAX_NODES];
+    int ids[MAX_NODES], siblings[MAX_NODES];
+    char path[128];
+    int i, j, num, num_siblings;
+
+    num = read_cpu_list("/sys/devices/system/cpu/online", ids, MAX_NODES);
+    if (num == 0)
+        return 0;
+
+    for (i = 0; i < num; i++) {
+        cpu_info_t *c = &cpus[i];
+        c->cpu = ids[i];
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c->cpu);
+        c->socket = read_int(path, 0);
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/core_id", c->cpu);
+        c->core = read_int(path, c->cpu);
+        c->l3 = read_l3_domain(c->cpu);
+        if (c->l3 < 0)
+            c->l3 = -1 - c->socket;   /* no L3: one domain per socket */
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", c->cpu);
+        num_siblings = read_cpu_list(path, siblings, MAX_NODES);
+        c->smt = 0;
+        for (j = 0; j < num_siblings; j++)
+            if (siblings[j] < c->cpu)
+                c->smt++;
+    }
+
+    for (i = 0; i < num; i++) {
+        cpu_info_t *c = &cpus[i];
+        c->l3_rank   = 0;
+        c->core_rank = 0;
+        for (j = 0; j < num; j++) {
+            const cpu_info_t *o = &cpus[j];
+            /* o is the first CPU of a lower L3 domain of the same socket */
+            if (o->socket == c->socket && o->cpu == o->l3 && o->l3 < c->l3)
+                c->l3_rank++;
+            /* o is a lower core of the same L3 domain, on the same SMT position */
+            if (o->l3 == c->l3 && o->smt == c->smt
+                    && (o->core < c->core || (o->core == c->core && o->cpu < c->cpu)))
+                c->core_rank++;
+        }
+    }
+
+    qsort(cpus, num, sizeof(cpu_info_t), compare_cpus);
+    max_cpus = num;
+    for (i = 0; i < num; i++)
+        node_mapping[i] = cpus[i].cpu;
+    return 1;
+}
+
+static void
+init_policy_from_env()
+{
+    const char *name = getenv("CPU_MAPPING_POLICY");
+    if (name == NULL)
+        return;
+    if (strcmp(name, "compact") == 0)
+        mapping_policy = CPU_MAPPING_COMPACT;
+    else if (strcmp(name, "scatter") == 0)
+        mapping_policy = CPU_MAPPING_SCATTER;
+    else if (strcmp(name, "physical_first") == 0)
+        mapping_policy = CPU_MAPPING_PHYSICAL_FIRST;
+    else {
+        printf("unknown CPU_MAPPING_POLICY: %s\n", name);
+        exit(1);
+    }
+}
+
+/**
+ * Try custom cpu mapping file first, then the topology of the machine.
+ * If neither is available, round-robin initialization among available
+ * CPUs reported by the system.
+ */
+static void
 init_mappings()
 {
-    if( init_mappings_from_file() == 0 ) {
+    if( init_mappings_from_file() == 0 && init_mappings_from_topology() == 0 ) {
         int i;
-        
+
         max_cpus  = sysconf(_SC_NPROCESSORS_ONLN);
         for(i = 0; i < max_cpus; i++){
             node_mapping[i] = i;
@@ -68,13 +252,22 @@ init_mappings()
 
 /** @} */
 
+void
+set_cpu_mapping_policy(enum cpu_mapping_policy policy)
+{
+    mapping_policy = policy;
+    inited         = 2;     /* the environment no longer overrides the policy */
+    init_mappings();
+}
+
 /**
  * Returns SMT aware logical to physical CPU mapping for a given thread id.
  */
-int 
-get_cpu_id(int thread_id) 
+int
+get_cpu_id(int thread_id)
 {
     if(!inited){
+        init_policy_from_env();
         init_mappings();
         inited = 1;
     }
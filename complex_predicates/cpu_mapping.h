@@ -7,19 +7,42 @@
  * Description: Provides cpu mapping utility function.
  *******************************************************************************/
 
- 
+
 #ifndef CPU_MAPPING_H
 #define CPU_MAPPING_H
 
 
-/** 
+/**
  * if the custom cpu mapping file exists, logical to physical mappings are
- * initialized from that file, otherwise it will be round-robin 
+ * initialized from that file, otherwise they are derived from the topology
+ * in /sys/devices/system/cpu with the placement policy below
  */
 #ifndef CUSTOM_CPU_MAPPING
 #define CUSTOM_CPU_MAPPING "cpu-mapping.txt"
 #endif
 
+/**
+ * Order in which threads are placed on the CPUs:
+ * COMPACT:  fill one L3 domain (and socket) after the other, SMT siblings
+ *           next to each other.
+ * SCATTER:  spread over sockets and L3 domains round-robin, one thread per
+ *           physical core before any SMT sibling, so that bandwidth-bound
+ *           scans use all memory channels evenly. (default)
+ * PHYSICAL_FIRST: all physical cores socket by socket, then their SMT siblings.
+ * The environment variable CPU_MAPPING_POLICY ("compact", "scatter" or
+ * "physical_first") overrides the default.
+ */
+enum cpu_mapping_policy {
+    CPU_MAPPING_COMPACT,
+    CPU_MAPPING_SCATTER,
+    CPU_MAPPING_PHYSICAL_FIRST
+};
+
+/**
+ * Selects the policy for the following calls to get_cpu_id.
+ */
+void set_cpu_mapping_policy(enum cpu_mapping_policy policy);
+
 /**
  * Returns SMT aware logical to physical CPU mapping for a given thread id.
  */
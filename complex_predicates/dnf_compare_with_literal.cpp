@@ -0,0 +1,230 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: fused scan of a predicate in disjunctive normal form.
+ * For each batch of BATCH_SEGMENTS segments (of 32 codes), the byte slices are
+ * processed level by level:
+ *   1, the first byte slice of every predicate is compared,
+ *   2, the masks are aggregated inside each clause (computeForEarlyStop<kAnd>)
+ *      and then over the clauses (computeForEarlyStop<kOr>),
+ *   3, the next byte slices are only fetched for the codes which are still
+ *      undecided in both their clause and the whole DNF, i.e., no clause has
+ *      succeeded and not all the clauses have failed.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include	<cassert>
+#include    <cstdlib>
+#include    <cstring>
+
+#include "config.h"
+
+#include "types_simd.h"
+#include "avx-utility.h"
+#include "dnf_compare_with_literal.h"
+#include "predicate_kernel.h"
+
+#ifdef __INTEL_COMPILER
+typedef long si64;
+#else
+typedef long long si64;
+#endif
+
+//PREFETCH: software prefetching of the first byte slices (P/nP).
+//STREAM:   non-temporal store of the result bit vector (S/nS).
+//Every stage runs over a batch of BATCH_SEGMENTS segments (8 words), through
+//the batch kernels bound in prepare_predicate.
+template <bool PREFETCH, bool STREAM>
+static void dnf_cmp_with_literal(WordUnit* bitmap, WordUnit len,
+                                 const ConjunctiveClause* clauses, size_t num_clauses
+                                )
+{
+    assert(num_clauses > 0);
+    const size_t kNumSegmentsPerWord = NUM_WORD_BITS/(NUM_AVX_BITS/8);
+
+    size_t num_predicates = 0;
+    for(size_t c = 0; c < num_clauses; c++){
+        assert(clauses[c].num_predicates > 0);
+        num_predicates += clauses[c].num_predicates;
+    }
+
+    //predicates of all the clauses, clause c owns [clause_begin[c], clause_begin[c+1]).
+    PredicateContext ctx[num_predicates];
+    PredicateMasks   m[num_predicates][BATCH_SEGMENTS];
+    AvxUnit          m_decided[num_predicates][BATCH_SEGMENTS];   //results once all the byte slices are compared.
+    size_t           clause_begin[num_clauses + 1];
+    AvxUnit          clause_equal[num_clauses][BATCH_SEGMENTS];
+    AvxUnit          dnf_equal[BATCH_SEGMENTS];
+    AvxUnit          m_refine[BATCH_SEGMENTS];
+    AvxUnit          m_clause[BATCH_SEGMENTS];
+    AvxUnit          m_result[BATCH_SEGMENTS];
+    size_t           max_bytes_per_code = 0;
+
+    for(size_t c = 0, p = 0; c < num_clauses; c++){
+        clause_begin[c] = p;
+        for(size_t k = 0; k < clauses[c].num_predicates; k++, p++){
+            prepare_predicate(clauses[c].predicates[k], ctx[p]);
+            if(ctx[p].kNumBytesPerCode > max_bytes_per_code)
+                max_bytes_per_code = ctx[p].kNumBytesPerCode;
+        }
+    }
+    clause_begin[num_clauses] = num_predicates;
+    //masks per IN-list literal, only for the IN terms.
+    AvxUnit          in_equal[in_equal_size(ctx, num_predicates) + 1];
+    bind_in_equal(ctx, num_predicates, in_equal);
+
+    //for every batch of BATCH_SEGMENTS*32 tuples
+    for(size_t offset = 0, bv_word_id = 0; offset < len; )
+    {
+        size_t num_words    = (len - offset + NUM_WORD_BITS - 1)/NUM_WORD_BITS;
+        if(num_words > BATCH_SEGMENTS/kNumSegmentsPerWord)
+            num_words = BATCH_SEGMENTS/kNumSegmentsPerWord;
+        size_t num_segments = num_words*kNumSegmentsPerWord;
+
+        if(PREFETCH){
+            for(size_t p = 0; p < num_predicates; p++)
+                for(size_t s = 0; s < num_segments; s++)
+                    _mm_prefetch((char const*)(ctx[p].data[0] + offset + s*(NUM_AVX_BITS/8) + PREFETCHING_DISTANCE), HINT_LEVEL);
+        }
+
+	    ////////////////////////approximate stage: for the first byte./////////////////////////////////
+        for(size_t p = 0; p < num_predicates; p++){
+            ctx[p].first_batch(ctx[p], offset, num_segments, m[p]);
+        }
+
+        //refine stage: one more byte slice per round, until the whole DNF is decided.
+        for(size_t byte_id = 1; ; byte_id++)
+        {
+            for(size_t p = 0; p < num_predicates; p++){
+                if(byte_id == ctx[p].kNumBytesPerCode)
+                    ctx[p].result_batch(m[p], num_segments, m_decided[p], false);
+            }
+
+            bool undecided = false;
+            for(size_t s = 0; s < num_segments; s++){
+                AvxUnit dnf_success, dnf_fail;
+                for(size_t c = 0; c < num_clauses; c++){
+                    //aggregating the information inside the clause.////
+                    size_t  q = clause_begin[c];
+                    AvxUnit agg_equal, agg_success, agg_fail;
+                    predicate_state(ctx[q], m[q][s], m_decided[q][s], byte_id, agg_equal, agg_success, agg_fail);
+                    for(size_t p = q + 1; p < clause_begin[c+1]; p++){
+                        AvxUnit p_equal, p_success, p_fail;
+                        predicate_state(ctx[p], m[p][s], m_decided[p][s], byte_id, p_equal, p_success, p_fail);
+                        computeForEarlyStop<Bitwise::kAnd>(agg_equal,
+                                                           agg_success,
+                                                           agg_fail,
+                                                           p_equal,
+                                                           p_success,
+                                                           p_fail,
+                                                           agg_equal,
+                                                           agg_success,
+                                                           agg_fail);
+                    }
+                    clause_equal[c][s] = agg_equal;
+
+                    //aggregating the information over the clauses.////
+                    if(c == 0){
+                        dnf_equal[s] = agg_equal;
+                        dnf_success  = agg_success;
+                        dnf_fail     = agg_fail;
+                    }
+                    else{
+                        computeForEarlyStop<Bitwise::kOr>(dnf_equal[s],
+                                                          dnf_success,
+                                                          dnf_fail,
+                                                          agg_equal,
+                                                          agg_success,
+                                                          agg_fail,
+                                                          dnf_equal[s],
+                                                          dnf_success,
+                                                          dnf_fail);
+                    }
+                }
+                undecided = undecided || !avx_iszero(dnf_equal[s]);
+            }
+
+            if( (byte_id >= max_bytes_per_code) || !undecided )
+                break;
+
+            for(size_t c = 0; c < num_clauses; c++){
+                bool refine = false;
+                for(size_t s = 0; s < num_segments; s++){
+                    m_refine[s] = avx_and(clause_equal[c][s], dnf_equal[s]);
+                    refine      = refine || !avx_iszero(m_refine[s]);
+                }
+                if(!refine)
+                    continue;
+                for(size_t p = clause_begin[c]; p < clause_begin[c+1]; p++){
+                    if(byte_id < ctx[p].kNumBytesPerCode)
+                        ctx[p].next_byte_batch(ctx[p], byte_id, offset, num_segments, m[p], m_refine);
+                }
+            }
+        }
+
+        /////////////combine the result::::AND inside the clauses, then OR over the clauses.//////////////////////////////
+        for(size_t c = 0; c < num_clauses; c++){
+            for(size_t p = clause_begin[c]; p < clause_begin[c+1]; p++){
+                ctx[p].result_batch(m[p], num_segments, (c == 0) ? m_result : m_clause, p > clause_begin[c]);
+            }
+            if(c > 0){
+                for(size_t s = 0; s < num_segments; s++)
+                    computeConjunctivePredicates<Bitwise::kOr>(m_result[s], m_clause[s], m_result[s]);
+            }
+        }
+
+        for(size_t w = 0; w < num_words; w++, offset += NUM_WORD_BITS, bv_word_id++)
+        {
+            WordUnit bitvector_word = WordUnit(0);
+            for(size_t i = 0; i < kNumSegmentsPerWord; i++){
+                uint32_t mmask = _mm256_movemask_epi8(m_result[w*kNumSegmentsPerWord + i]);
+                bitvector_word |= (static_cast<WordUnit>(mmask) << (i*(NUM_AVX_BITS/8)));
+            }
+
+            //clear the codes beyond len in the last word.
+            if(offset + NUM_WORD_BITS > len){
+                bitvector_word &= (-1ULL >> (offset + NUM_WORD_BITS - len));
+            }
+
+            if(STREAM)
+                _mm_stream_si64((si64*) &bitmap[bv_word_id], bitvector_word);
+            else
+                bitmap[bv_word_id] = bitvector_word;
+        }
+    }
+
+    for(size_t p = 0; p < num_predicates; p++){
+        release_predicate(ctx[p]);
+    }
+}
+
+void dnf_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
+                                const ConjunctiveClause* clauses, size_t num_clauses
+                               )
+{
+    dnf_cmp_with_literal<false, false>(bitmap, len, clauses, num_clauses);
+}
+
+void dnf_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
+                               const ConjunctiveClause* clauses, size_t num_clauses
+                              )
+{
+    dnf_cmp_with_literal<false, true>(bitmap, len, clauses, num_clauses);
+}
+
+void dnf_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
+                               const ConjunctiveClause* clauses, size_t num_clauses
+                              )
+{
+    dnf_cmp_with_literal<true, false>(bitmap, len, clauses, num_clauses);
+}
+
+void dnf_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
+                              const ConjunctiveClause* clauses, size_t num_clauses
+                             )
+{
+    dnf_cmp_with_literal<true, true>(bitmap, len, clauses, num_clauses);
+}
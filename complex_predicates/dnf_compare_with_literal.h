@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: fused scan of a predicate in disjunctive normal form,
+ * i.e., (p11 AND p12 ...) OR (p21 AND ...) OR ..., such as TPC-H Q19.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef DNF_COMPARE_WITH_LITERAL_H
+#define DNF_COMPARE_WITH_LITERAL_H
+
+#include "types_simd.h"
+#include "n_column_compare_with_literal.h"
+
+//one conjunctive clause of the DNF.
+struct ConjunctiveClause{
+    const ColumnPredicate* predicates;
+    size_t                 num_predicates;
+};
+
+void dnf_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
+                                const ConjunctiveClause* clauses, size_t num_clauses
+                               );
+
+void dnf_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
+                               const ConjunctiveClause* clauses, size_t num_clauses
+                              );
+
+void dnf_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
+                               const ConjunctiveClause* clauses, size_t num_clauses
+                              );
+
+void dnf_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
+                              const ConjunctiveClause* clauses, size_t num_clauses
+                             );
+
+#endif
@@ -28,6 +28,8 @@
 
 #include "types_simd.h"
 #include "avx-utility.h"
+#include "file_tool.h"
+#include "memory_tool.h"
 
 
 bool GetBit_from_byte(ByteUnit *bitmap, size_t pos){
@@ -303,4 +305,68 @@ void SetTuple_4(ByteUnit** data_, size_t pos,
 }
 
 
+uint64_t load_shared_column(shared_column_t *column, const char *in_file, uint32_t bit_width,
+                            double scale, bool huge_table_enable)
+{
+    FILE *fp;
+    if ((fp = fopen(in_file, "r")) == NULL) {
+        printf("cannot open %s\n", in_file);
+        exit(1);
+    }
+    const uint64_t max_code = (1ULL << bit_width) - 1;
+    std::vector<uint32_t> codes;
+    double tmp_f;
+    while (fscanf(fp, "%lf\n", &tmp_f) > 0) {
+        double code = tmp_f * scale + 0.5;          //rounds to the nearest code (0.29*100 is 28.99...)
+        if ( (code < 0.0) || (code >= max_code + 1.0) )
+        {
+            printf("%s ERROR::::::::value = %f\n", in_file, tmp_f);
+            break;
+        }
+        codes.push_back((uint32_t) code);
+    }
+    fclose(fp);
+
+    uint64_t num         = codes.size();
+    uint64_t num_aligned = ( ((num + 63)>>6)<<6 ) + 64;   //kernels may read up to 64 codes past the end
+    column->num                = num;
+    column->bit_width          = bit_width;
+    column->kNumBytesPerCode   = (bit_width+7)/8;
+    column->kNumPaddingBits    = column->kNumBytesPerCode * 8 - bit_width;
+    column->huge_table_enable  = huge_table_enable;
+    column->codes              = (uint32_t *) malloc_memory(num_aligned*sizeof(uint32_t), false);
+    if (column->codes == NULL) {
+        printf("codes_malloc for %s fails\n", in_file);
+        exit(1);
+    }
+    memcpy(column->codes, codes.data(), num*sizeof(uint32_t));
+    for (int i = 0; i < 4; i++) //all 4 slices, as some kernels touch the unused ones
+    {
+        column->data[i] = (ByteUnit *) malloc_memory(num_aligned*sizeof(ByteUnit), huge_table_enable);
+        if (column->data[i] == NULL) {
+            printf("data[%d]_malloc for %s fails\n", i, in_file);
+            exit(1);
+        }
+        uint64_t used = (i < column->kNumBytesPerCode) ? num : 0;
+        memset(column->data[i] + used, 0, num_aligned - used);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (uint64_t i = 0; i < num; i++)
+        SetTuple(column->data, i, column->codes[i], column->kNumBytesPerCode, column->kNumPaddingBits);
 
+    return num;
+}
+
+void slice_shared_column(const shared_column_t *column, uint64_t start, ByteUnit **data)
+{
+    for (int i = 0; i < 4; i++)
+        data[i] = column->data[i] + start;
+}
+
+void free_shared_column(shared_column_t *column)
+{
+    free_memory(column->codes, false);
+    for (int i = 0; i < 4; i++)
+        free_memory(column->data[i], column->huge_table_enable);
+}
@@ -43,5 +43,27 @@ void SetTuple_4(ByteUnit** data_, size_t pos,
                 uint32_t value_3, int kNumBytesPerCode_3, int kNumPaddingBits_3, //third column
 				uint32_t value_4, int kNumBytesPerCode_4, int kNumPaddingBits_4
                );			   
+
+//A column of a lineitemWT text file, loaded once in main() and shared read-only
+//by all threads; each thread scans its own range [start, start + T1_len).
+typedef struct {
+    uint64_t  num;                //number of codes
+    uint32_t  bit_width;
+    int       kNumBytesPerCode;
+    int       kNumPaddingBits;
+    uint32_t *codes;              //the codes, to verify the bit vectors
+    ByteUnit *data[4];            //byte slices
+    bool      huge_table_enable;
+} shared_column_t;
+
+//one value per line, multiplied by scale and rounded (e.g., scale 100 for l_discount)
+uint64_t load_shared_column(shared_column_t *column, const char *in_file, uint32_t bit_width,
+                            double scale, bool huge_table_enable);
+
+//data[i] points to the i-th byte slice of column from code start (a multiple of 64) on
+void slice_shared_column(const shared_column_t *column, uint64_t start, ByteUnit **data);
+
+void free_shared_column(shared_column_t *column);
+
 #endif
 
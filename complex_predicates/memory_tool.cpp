@@ -14,9 +14,16 @@
 #include <sys/mman.h> 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
   
 #include "huge_page.h"
 
+#define BANDWIDTH_BUFFER_SIZE (64*1024*1024) //per thread, well beyond the LLC.
+#define DEFAULT_LLC_SIZE      (8*1024*1024)
+
 //malloc the memory with huge table or not.
 void *malloc_memory(size_t size, bool huge_page_enable)
 {
@@ -48,3 +55,80 @@ void free_memory(void *ptr, bool huge_page_enable)
        free(ptr);	 
 	}
 }
+
+typedef struct {
+	pthread_t id;
+	uint64_t *buffer;
+	pthread_barrier_t *barrier;
+	uint64_t checksum;
+} bandwidth_info_t;
+
+static void *read_buffer(void *arg)
+{
+	bandwidth_info_t *d = (bandwidth_info_t*) arg;
+	size_t num_words    = BANDWIDTH_BUFFER_SIZE/sizeof(uint64_t);
+
+	for (size_t i = 0; i < num_words; i++) //touch the pages before timing.
+		d->buffer[i] = i;
+
+	pthread_barrier_wait(d->barrier);
+	uint64_t sum = 0;
+	for (size_t i = 0; i < num_words; i++)
+		sum ^= d->buffer[i];
+	d->checksum = sum;
+	pthread_barrier_wait(d->barrier);
+	return NULL;
+}
+
+static double wall_time_ns(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+//every thread streams through its own buffer; the main thread times the read phase.
+double measure_memory_bandwidth(size_t threads)
+{
+	assert(threads > 0);
+	bandwidth_info_t info[threads];
+	pthread_barrier_t barrier;
+	pthread_barrier_init(&barrier, NULL, threads + 1);
+
+	for (size_t t = 0; t < threads; t++)
+	{
+		info[t].buffer  = (uint64_t *) malloc_memory(BANDWIDTH_BUFFER_SIZE, false);
+		info[t].barrier = &barrier;
+		if (info[t].buffer == NULL)
+		{
+			printf ( "in measure_memory_bandwidth, buffer_%zu malloc fails\n", t);
+			exit(1);
+		}
+		pthread_create(&info[t].id, NULL, read_buffer, (void*) &info[t]);
+	}
+
+	pthread_barrier_wait(&barrier);
+	double start = wall_time_ns();
+	pthread_barrier_wait(&barrier);
+	double time  = wall_time_ns() - start;
+
+	uint64_t checksum = 0;
+	for (size_t t = 0; t < threads; t++)
+	{
+		pthread_join(info[t].id, NULL);
+		checksum ^= info[t].checksum;
+		free_memory(info[t].buffer, false);
+	}
+	pthread_barrier_destroy(&barrier);
+	(void) checksum;
+
+	return (double)BANDWIDTH_BUFFER_SIZE * threads / time;
+}
+
+size_t last_level_cache_size()
+{
+	long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+	if (size <= 0)
+		size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	return (size > 0) ? (size_t) size : DEFAULT_LLC_SIZE;
+}
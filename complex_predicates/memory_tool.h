@@ -15,5 +15,11 @@ void *malloc_memory(size_t size, bool huge_page_enable);
 
 void free_memory(void *ptr, bool huge_page_enable);
 
+//sequential read bandwidth (bytes per ns, i.e., GB/s) of threads reading concurrently.
+double measure_memory_bandwidth(size_t threads);
+
+//size of the last level cache in bytes.
+size_t last_level_cache_size();
+
 #endif
 
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: Work stealing over fine-grained morsels of a table.
+ *******************************************************************************/
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#include "morsel_queue.h"
+
+/**
+ * A deque holds the contiguous morsels [head, tail), packed in one word as
+ * (head << 32) | tail, so the owner (head++) and the thieves (tail -= k)
+ * update it with the same compare-and-swap. Once a deque is empty, only its
+ * owner writes it again (after stealing), so a stale value cannot come back.
+ * Every deque has its own cache line.
+ */
+typedef struct {
+    std::atomic<uint64_t> range;
+    char                  pad[64 - sizeof(std::atomic<uint64_t>)];
+} morsel_deque_t;
+
+struct morsel_queue {
+    morsel_deque_t        *deques;
+    int                    threads;
+    uint64_t               size;
+    uint64_t               morsel_len;
+    std::atomic<uint64_t>  steals;
+};
+
+static inline uint64_t pack_range(uint64_t head, uint64_t tail) { return (head << 32) | tail; }
+static inline uint64_t range_head(uint64_t range)               { return range >> 32; }
+static inline uint64_t range_tail(uint64_t range)               { return range & 0xffffffffULL; }
+
+morsel_queue_t *
+morsel_queue_create(uint64_t size, uint64_t morsel_len, int threads)
+{
+    assert(threads > 0 && morsel_len > 0 && (morsel_len & 63) == 0);
+    uint64_t morsels = (size + morsel_len - 1) / morsel_len;
+    if (morsels >> 32) {
+        printf("morsel_queue_create: too many morsels (%llu), use a larger morsel_len\n",
+               (unsigned long long) morsels);
+        exit(1);
+    }
+
+    morsel_queue_t *queue = new morsel_queue_t;
+    void *deques;
+    if (posix_memalign(&deques, 64, threads * sizeof(morsel_deque_t)) != 0) {
+        printf("morsel_queue_create: cannot allocate the deques\n");
+        exit(1);
+    }
+    queue->deques     = (morsel_deque_t *) deques;
+    queue->threads    = threads;
+    queue->size       = size;
+    queue->morsel_len = morsel_len;
+    queue->steals.store(0);
+    for (int t = 0; t < threads; t++) {
+        new (&queue->deques[t].range) std::atomic<uint64_t>(
+            pack_range(morsels * t / threads, morsels * (t + 1) / threads));
+    }
+    return queue;
+}
+
+void
+morsel_queue_destroy(morsel_queue_t *queue)
+{
+    free(queue->deques);
+    delete queue;
+}
+
+static inline void
+morsel_bounds(const morsel_queue_t *queue, uint64_t morsel, uint64_t *start, uint64_t *len)
+{
+    *start = morsel * queue->morsel_len;
+    *len   = (*start + queue->morsel_len <= queue->size) ? queue->morsel_len : queue->size - *start;
+}
+
+int
+morsel_queue_next(morsel_queue_t *queue, int thread, uint64_t *start, uint64_t *len)
+{
+    std::atomic<uint64_t> &own = queue->deques[thread].range;
+
+    //the front of its own deque
+    uint64_t range = own.load(std::memory_order_acquire);
+    while (range_head(range) < range_tail(range)) {
+        if (own.compare_exchange_weak(range, pack_range(range_head(range) + 1, range_tail(range)),
+                                      std::memory_order_acq_rel)) {
+            morsel_bounds(queue, range_head(range), start, len);
+            return 1;
+        }
+    }
+
+    //half of the back of the next non-empty deque
+    for (int k = 1; k < queue->threads; k++) {
+        std::atomic<uint64_t> &victim = queue->deques[(thread + k) % queue->threads].range;
+        range = victim.load(std::memory_order_acquire);
+        while (range_head(range) < range_tail(range)) {
+            uint64_t tail  = range_tail(range);
+            uint64_t taken = (tail - range_head(range) + 1) / 2;
+            if (victim.compare_exchange_weak(range, pack_range(range_head(range), tail - taken),
+                                             std::memory_order_acq_rel)) {
+                own.store(pack_range(tail - taken + 1, tail), std::memory_order_release);
+                queue->steals.fetch_add(1, std::memory_order_relaxed);
+                morsel_bounds(queue, tail - taken, start, len);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+uint64_t
+morsel_queue_steals(const morsel_queue_t *queue)
+{
+    return queue->steals.load(std::memory_order_relaxed);
+}
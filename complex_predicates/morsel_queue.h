@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: Work stealing over fine-grained morsels of a table. Every
+ * thread has a deque of morsels; it takes them from the front of its own
+ * deque and, once that is empty, steals from the back of the others.
+ *******************************************************************************/
+#ifndef MORSEL_QUEUE_H
+#define MORSEL_QUEUE_H
+
+#include <stdint.h>
+
+//number of codes per morsel (a multiple of 64, i.e., of a bit vector word).
+#ifndef MORSEL_LEN
+#define MORSEL_LEN (64 * 256)
+#endif
+
+typedef struct morsel_queue morsel_queue_t;
+
+/**
+ * Cuts [0, size) into morsels of morsel_len codes and deals them to the
+ * deques of threads threads: thread t gets the t-th contiguous run of
+ * morsels, i.e., about the range compute_task_len_for_each_thread gives it.
+ */
+morsel_queue_t *morsel_queue_create(uint64_t size, uint64_t morsel_len, int threads);
+
+void morsel_queue_destroy(morsel_queue_t *queue);
+
+/**
+ * Next morsel [*start, *start + *len) for thread: the front of its own deque,
+ * or else half of the morsels left at the back of the deque of another
+ * thread (the first of them is returned, the rest refill its own deque).
+ * Returns 0 once all the deques are empty.
+ */
+int morsel_queue_next(morsel_queue_t *queue, int thread, uint64_t *start, uint64_t *len);
+
+/**
+ * Number of steals so far (not synchronized with running threads).
+ */
+uint64_t morsel_queue_steals(const morsel_queue_t *queue);
+
+#endif
@@ -0,0 +1,343 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: run-time configurable fused scan over N byte-sliced columns.
+ * It follows the same approximate/refine stages as four_columns_cmp_with_literal_*:
+ *   1, the first byte slice of every column is compared (computeKernelWithMask_FIRST),
+ *   2, the masks are aggregated over all the columns (computeForEarlyStop),
+ *   3, the remaining byte slices are only fetched while some code is undecided,
+ *   4, the per-column results are combined (computeConjunctivePredicates).
+ * The comparators are bound once per query through template dispatch tables to
+ * batch kernels, which loop over BATCH_SEGMENTS segments with the compile-time
+ * comparator inlined; the stages are dispatched once per batch, not per segment.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include	<cassert>
+#include    <cstdio>
+#include    <cstdlib>
+#include    <cstring>
+#include    <time.h>
+
+#include "config.h"
+
+#include "types_simd.h"
+#include "avx-utility.h"
+#include "n_column_compare_with_literal.h"
+#include "predicate_kernel.h"
+#include "adaptive_pruning.h"
+#include "memory_tool.h"
+
+#ifdef __INTEL_COMPILER
+typedef long si64;
+#else
+typedef long long si64;
+#endif
+
+#ifdef ADAPTIVE_PRUNING_ENABLE
+static_assert(ADAPTIVE_PRUNING_WINDOW % BATCH_SEGMENTS == 0,
+              "a batch must not straddle two adaptive pruning windows");
+#endif
+
+//aggregating the information from all the columns: the codes of segment s
+//still undecided in the whole conjunction.
+static inline AvxUnit aggregate_equal(PredicateMasks (*m)[BATCH_SEGMENTS], size_t num_predicates,
+                                      size_t s)
+{
+    AvxUnit agg_equal   = m[0][s].equal;
+    AvxUnit agg_success = m[0][s].success;
+    AvxUnit agg_fail    = m[0][s].fail;
+    for(size_t p = 1; p < num_predicates; p++){
+        computeForEarlyStop<Bitwise::kAnd>(agg_equal,
+                                           agg_success,
+                                           agg_fail,
+                                           m[p][s].equal,
+                                           m[p][s].success,
+                                           m[p][s].fail,
+                                           agg_equal,
+                                           agg_success,
+                                           agg_fail);
+    }
+    return agg_equal;
+}
+
+//PREFETCH: software prefetching of the first byte slices (P/nP).
+//STREAM:   non-temporal store of the result bit vector (S/nS).
+//Every stage runs over a batch of BATCH_SEGMENTS segments (8 words), through
+//the batch kernels bound in prepare_predicate.
+template <bool PREFETCH, bool STREAM>
+static void n_columns_cmp_with_literal(WordUnit* bitmap, WordUnit len,
+                                       const ColumnPredicate* predicates, size_t num_predicates
+                                      )
+{
+    assert(num_predicates > 0);
+    const size_t kNumSegmentsPerWord = NUM_WORD_BITS/(NUM_AVX_BITS/8);
+
+    PredicateContext ctx[num_predicates];
+    PredicateMasks   m[num_predicates][BATCH_SEGMENTS];
+    AvxUnit          m_result[BATCH_SEGMENTS];
+    for(size_t p = 0; p < num_predicates; p++){
+        prepare_predicate(predicates[p], ctx[p]);
+    }
+    //masks per IN-list literal, only for the IN terms.
+    AvxUnit          in_equal[in_equal_size(ctx, num_predicates) + 1];
+    bind_in_equal(ctx, num_predicates, in_equal);
+#if defined(PRUNING_ENABLE) || defined(ADAPTIVE_PRUNING_ENABLE)
+    AvxUnit          agg_equal[BATCH_SEGMENTS];
+#endif
+#ifdef ADAPTIVE_PRUNING_ENABLE
+    AdaptivePruning pruning;
+    adaptive_pruning_init(pruning);
+#endif
+
+    //for every batch of BATCH_SEGMENTS*32 tuples
+    for(size_t offset = 0, bv_word_id = 0; offset < len; )
+    {
+        size_t num_words    = (len - offset + NUM_WORD_BITS - 1)/NUM_WORD_BITS;
+        if(num_words > BATCH_SEGMENTS/kNumSegmentsPerWord)
+            num_words = BATCH_SEGMENTS/kNumSegmentsPerWord;
+        size_t num_segments = num_words*kNumSegmentsPerWord;
+
+        if(PREFETCH){
+            for(size_t p = 0; p < num_predicates; p++)
+                for(size_t s = 0; s < num_segments; s++)
+                    _mm_prefetch((char const*)(ctx[p].data[0] + offset + s*(NUM_AVX_BITS/8) + PREFETCHING_DISTANCE), HINT_LEVEL);
+        }
+
+	    ////////////////////////approximate stage: for the first byte./////////////////////////////////
+        for(size_t p = 0; p < num_predicates; p++){
+            ctx[p].first_batch(ctx[p], offset, num_segments, m[p]);
+        }
+
+#if defined(PRUNING_ENABLE)
+        //refine stage.
+        for(size_t s = 0; s < num_segments; s++)
+            agg_equal[s] = aggregate_equal(m, num_predicates, s);
+        for(size_t p = 0; p < num_predicates; p++){
+            ctx[p].refine_batch(ctx[p], offset, num_segments, m[p], agg_equal);
+        }
+#elif defined(ADAPTIVE_PRUNING_ENABLE)
+        //refine stage: pruned only while pruning pays off (BATCH_SEGMENTS divides
+        //the window, so the decision stays the same over a batch).
+        if (pruning.enabled)
+        {
+            for(size_t s = 0; s < num_segments; s++){
+                agg_equal[s] = aggregate_equal(m, num_predicates, s);
+                if (avx_iszero(agg_equal[s]))
+                {
+                    AvxUnit any_equal = m[0][s].equal;
+                    for(size_t p = 1; p < num_predicates; p++)
+                        any_equal = avx_or(any_equal, m[p][s].equal);
+                    pruning.hits += !avx_iszero(any_equal);
+                }
+            }
+            for(size_t p = 0; p < num_predicates; p++){
+                ctx[p].refine_batch(ctx[p], offset, num_segments, m[p], agg_equal);
+            }
+        }
+        else
+        {
+            for(size_t p = 0; p < num_predicates; p++){
+                ctx[p].refine_batch(ctx[p], offset, num_segments, m[p], NULL);
+            }
+        }
+        for(size_t s = 0; s < num_segments; s++)
+            adaptive_pruning_next_segment(pruning);
+#else
+        //refine stage: every column on its own.
+        for(size_t p = 0; p < num_predicates; p++){
+            ctx[p].refine_batch(ctx[p], offset, num_segments, m[p], NULL);
+        }
+#endif
+
+        /////////////combine the result::::generat the vector result for the above computing....//////////////////////////////
+        for(size_t p = 0; p < num_predicates; p++){
+            ctx[p].result_batch(m[p], num_segments, m_result, p > 0);
+        }
+
+        for(size_t w = 0; w < num_words; w++, offset += NUM_WORD_BITS, bv_word_id++)
+        {
+            WordUnit bitvector_word = WordUnit(0);
+            for(size_t i = 0; i < kNumSegmentsPerWord; i++){
+                uint32_t mmask = _mm256_movemask_epi8(m_result[w*kNumSegmentsPerWord + i]);
+                bitvector_word |= (static_cast<WordUnit>(mmask) << (i*(NUM_AVX_BITS/8)));
+            }
+
+            //clear the codes beyond len in the last word.
+            if(offset + NUM_WORD_BITS > len){
+                bitvector_word &= (-1ULL >> (offset + NUM_WORD_BITS - len));
+            }
+
+            if(STREAM)
+                _mm_stream_si64((si64*) &bitmap[bv_word_id], bitvector_word);
+            else
+                bitmap[bv_word_id] = bitvector_word;
+        }
+    }
+
+    for(size_t p = 0; p < num_predicates; p++){
+        release_predicate(ctx[p]);
+    }
+}
+
+void n_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
+                                      const ColumnPredicate* predicates, size_t num_predicates
+                                     )
+{
+    n_columns_cmp_with_literal<false, false>(bitmap, len, predicates, num_predicates);
+}
+
+void n_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
+                                     const ColumnPredicate* predicates, size_t num_predicates
+                                    )
+{
+    n_columns_cmp_with_literal<false, true>(bitmap, len, predicates, num_predicates);
+}
+
+void n_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
+                                     const ColumnPredicate* predicates, size_t num_predicates
+                                    )
+{
+    n_columns_cmp_with_literal<true, false>(bitmap, len, predicates, num_predicates);
+}
+
+void n_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
+                                    const ColumnPredicate* predicates, size_t num_predicates
+                                   )
+{
+    n_columns_cmp_with_literal<true, true>(bitmap, len, predicates, num_predicates);
+}
+
+ExecutionModel choose_execution_model(const ColumnPredicate* predicates, size_t num_predicates,
+                                      WordUnit sample_len, WordUnit len, size_t threads, double bandwidth
+                                     )
+{
+    assert(num_predicates > 0 && threads > 0);
+
+    //bytes fetched per code: every first slice and the later slices of undecided segments.
+    double bytes_per_code = 1.0/8;   //the result bit vector.
+    double data_per_code  = 0.0;     //all byte slices, to check the cache residency.
+    size_t num_segments   = sample_len/(NUM_AVX_BITS/8);
+    if(num_segments > COST_SAMPLE_SEGMENTS)
+        num_segments = COST_SAMPLE_SEGMENTS;
+    for(size_t p = 0; p < num_predicates; p++){
+        PredicateContext ctx;
+        PredicateMasks   m;
+        prepare_predicate(predicates[p], ctx);
+        AvxUnit          in_equal[in_equal_size(&ctx, 1) + 1];
+        bind_in_equal(&ctx, 1, in_equal);
+
+        size_t num_undecided = 0;
+        for(size_t s = 0; s < num_segments; s++){
+            size_t pos = (s*sample_len/num_segments)/(NUM_AVX_BITS/8)*(NUM_AVX_BITS/8);
+            ctx.first_batch(ctx, pos, 1, &m);
+            num_undecided += !avx_iszero(m.equal);
+        }
+        release_predicate(ctx);
+        double undecided = (num_segments == 0) ? 1.0 : (double)num_undecided/num_segments;
+        size_t columns   = (predicates[p].other_data != NULL) ? 2 : 1;
+        bytes_per_code  += columns * (1.0 + undecided * (ctx.kNumBytesPerCode - 1));
+        data_per_code   += columns * ctx.kNumBytesPerCode;
+    }
+
+    //compute cost per code: the second run of nP_nS over a cache-resident prefix.
+    WordUnit calibration_len = (sample_len < COST_CALIBRATION_CODES) ? sample_len : COST_CALIBRATION_CODES;
+    double   ns_per_code     = 0.0;
+    if(calibration_len > 0){
+        WordUnit calibration_bitmap[COST_CALIBRATION_CODES/NUM_WORD_BITS + 1];
+        struct timespec start, end;
+        n_columns_cmp_with_literal<false, false>(calibration_bitmap, calibration_len, predicates, num_predicates);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+        n_columns_cmp_with_literal<false, false>(calibration_bitmap, calibration_len, predicates, num_predicates);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+        ns_per_code = ((end.tv_sec - start.tv_sec)*1e9 + (end.tv_nsec - start.tv_nsec))/calibration_len;
+    }
+
+    //bandwidth demand of all the threads if the memory never stalled them.
+    double llc       = (double)last_level_cache_size();
+    bool   saturated = (ns_per_code <= 0.0) || (threads * bytes_per_code / ns_per_code >= bandwidth);
+    bool   in_cache  = threads * len * data_per_code <= llc;
+    bool   prefetch  = !in_cache && !saturated;
+    bool   stream    = threads * len / 8.0 > llc;
+
+    if(prefetch)
+        return stream ? MODEL_P_S : MODEL_P_nS;
+    else
+        return stream ? MODEL_nP_S : MODEL_nP_nS;
+}
+
+ExecutionModel n_columns_cmp_with_literal_auto(WordUnit* bitmap, WordUnit len,
+                                               const ColumnPredicate* predicates, size_t num_predicates,
+                                               size_t threads, double bandwidth
+                                              )
+{
+    ExecutionModel model = choose_execution_model(predicates, num_predicates, len, len, threads, bandwidth);
+    switch(model){
+        case MODEL_nP_nS:
+            n_columns_cmp_with_literal<false, false>(bitmap, len, predicates, num_predicates);
+            break;
+        case MODEL_nP_S:
+            n_columns_cmp_with_literal<false, true>(bitmap, len, predicates, num_predicates);
+            break;
+        case MODEL_P_nS:
+            n_columns_cmp_with_literal<true, false>(bitmap, len, predicates, num_predicates);
+            break;
+        case MODEL_P_S:
+            n_columns_cmp_with_literal<true, true>(bitmap, len, predicates, num_predicates);
+            break;
+    }
+    return model;
+}
+
+ExecutionModel pick_execution_model(uint32_t p_s_model,
+                                    const ColumnPredicate* predicates, size_t num_predicates,
+                                    WordUnit sample_len, WordUnit len, size_t threads
+                                   )
+{
+    if(p_s_model <= MODEL_P_S)
+        return (ExecutionModel) p_s_model;
+
+    double bandwidth = measure_memory_bandwidth(threads);
+    ExecutionModel model = choose_execution_model(predicates, num_predicates, sample_len, len,
+                                                  threads, bandwidth);
+    printf("memory bandwidth = %6.3f GB/s, cost model chose p_s_model = %d\n", bandwidth, model);
+    return model;
+}
+
+ColumnPredicate literal_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                  Comparator comparator, uint32_t literal)
+{
+    ColumnPredicate predicate;
+    memset(&predicate, 0, sizeof(predicate));
+    predicate.data             = data;
+    predicate.kNumBytesPerCode = kNumBytesPerCode;
+    predicate.kNumPaddingBits  = kNumPaddingBits;
+    predicate.comparator       = comparator;
+    predicate.literal          = literal;
+    return predicate;
+}
+
+ColumnPredicate in_list_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                  const uint32_t* in_list, size_t in_list_len)
+{
+    ColumnPredicate predicate = literal_predicate(data, kNumBytesPerCode, kNumPaddingBits,
+                                                  Comparator::kEqual, 0);
+    predicate.in_list     = in_list;
+    predicate.in_list_len = in_list_len;
+    return predicate;
+}
+
+ColumnPredicate column_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                 Comparator comparator, ByteUnit** other_data,
+                                 size_t other_kNumBytesPerCode, size_t other_kNumPaddingBits)
+{
+    ColumnPredicate predicate = literal_predicate(data, kNumBytesPerCode, kNumPaddingBits,
+                                                  comparator, 0);
+    predicate.other_data             = other_data;
+    predicate.other_kNumBytesPerCode = other_kNumBytesPerCode;
+    predicate.other_kNumPaddingBits  = other_kNumPaddingBits;
+    return predicate;
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: run-time configurable fused scan over N byte-sliced columns.
+ * Instead of fixing the comparators with FIRST_COMPARISON_TYPE etc. at compile
+ * time, the conjunction is given as a list of (column, comparator, literal) terms.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef N_COLUMN_COMPARE_WITH_LITERAL_H
+#define N_COLUMN_COMPARE_WITH_LITERAL_H
+
+#include "types_simd.h"
+
+//one term of the conjunction: (column, comparator, literal).
+//If in_list_len > 0, the term is (column IN in_list) and comparator/literal are ignored.
+//Literals out of the domain of the column never match; lists longer than MAX_IN_LIST_SIZE
+//are filtered by their first byte, then checked against the sorted list.
+//If other_data is not NULL, the term is (column comparator other column) and literal is
+//ignored; the two columns may have different bit widths.
+struct ColumnPredicate{
+    ByteUnit** data;             //byte slices of the column (right padded).
+    size_t     kNumBytesPerCode;
+    size_t     kNumPaddingBits;
+    Comparator comparator;
+    uint32_t   literal;
+    const uint32_t* in_list;
+    size_t     in_list_len;
+    ByteUnit** other_data;       //byte slices of the other column (right padded).
+    size_t     other_kNumBytesPerCode;
+    size_t     other_kNumPaddingBits;
+};
+
+void n_columns_cmp_with_literal_nP_nS(WordUnit* bitmap, WordUnit len,
+                                      const ColumnPredicate* predicates, size_t num_predicates
+                                     );
+
+void n_columns_cmp_with_literal_nP_S(WordUnit* bitmap, WordUnit len,
+                                     const ColumnPredicate* predicates, size_t num_predicates
+                                    );
+
+void n_columns_cmp_with_literal_P_nS(WordUnit* bitmap, WordUnit len,
+                                     const ColumnPredicate* predicates, size_t num_predicates
+                                    );
+
+void n_columns_cmp_with_literal_P_S(WordUnit* bitmap, WordUnit len,
+                                    const ColumnPredicate* predicates, size_t num_predicates
+                                   );
+
+//the execution models, numbered as p_s_model of the drivers.
+enum ExecutionModel{
+    MODEL_nP_nS = 0,
+    MODEL_nP_S  = 1,
+    MODEL_P_nS  = 2,
+    MODEL_P_S   = 3
+};
+
+//Pick the execution model of a scan of len codes per thread from a cost model:
+//  1, bytes fetched per code: the first byte slice of every predicate, plus the later
+//     slices of the segments the first slice leaves undecided (sampled on COST_SAMPLE_SEGMENTS
+//     segments), so the bit widths and the selectivity around the literals enter here,
+//  2, compute cost per code: nP_nS timed on COST_CALIBRATION_CODES cache-resident codes,
+//  3, bandwidth demand of all threads running unstalled, compared with the measured bandwidth
+//     (bytes per ns, see measure_memory_bandwidth).
+//Prefetching (P) hides the memory latency only if the columns do not fit in the LLC and the
+//threads leave bandwidth to spare. Streaming stores (S) skip the read-for-ownership of the
+//bit vector and keep the columns cached, once the bit vectors of all threads exceed the LLC.
+//1 and 2 run on the first sample_len codes of the predicates, which must be drawn like the
+//codes the threads scan (e.g., the whole table, or a sample generated the same way).
+ExecutionModel choose_execution_model(const ColumnPredicate* predicates, size_t num_predicates,
+                                      WordUnit sample_len, WordUnit len, size_t threads, double bandwidth
+                                     );
+
+//p_s_model of the drivers (0:nP_nS, 1:nP_S, 2:P_nS, 3:P_S) as is, or, for 4, the choice of
+//choose_execution_model with the bandwidth measured for threads (printed). Call it once per
+//query, before the threads start, so that all of them run the same model.
+ExecutionModel pick_execution_model(uint32_t p_s_model,
+                                    const ColumnPredicate* predicates, size_t num_predicates,
+                                    WordUnit sample_len, WordUnit len, size_t threads
+                                   );
+
+//terms on the byte slices data of a column (right padded), as ColumnPredicate describes them.
+ColumnPredicate literal_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                  Comparator comparator, uint32_t literal);
+ColumnPredicate in_list_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                  const uint32_t* in_list, size_t in_list_len);
+ColumnPredicate column_predicate(ByteUnit** data, size_t kNumBytesPerCode, size_t kNumPaddingBits,
+                                 Comparator comparator, ByteUnit** other_data,
+                                 size_t other_kNumBytesPerCode, size_t other_kNumPaddingBits);
+
+//choose_execution_model, then run the chosen variant.
+ExecutionModel n_columns_cmp_with_literal_auto(WordUnit* bitmap, WordUnit len,
+                                               const ColumnPredicate* predicates, size_t num_predicates,
+                                               size_t threads, double bandwidth
+                                              );
+
+#endif
@@ -0,0 +1,391 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ * 
+ * Description: driver of the run-time configurable N-column scan (n_columns_cmp_with_literal_*).
+ * The i-th column uses kGreater for even i and kLess for odd i, same as the 4-column case.
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <time.h>
+#include <stdio.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <immintrin.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+//#include "rdtsc.h"
+
+#include <sched.h>              /* CPU_ZERO, CPU_SET */
+
+#include   "types_simd.h"
+
+#include "cpu_mapping.h"
+#include "common_tool.h"
+#include "column_compare.h"
+#include "memory_tool.h"
+#include "rand_tool.h"
+#include "perf_counters.h"
+#include "n_column_compare_with_literal.h" 
+
+//#include 	"byteslice_column_block.h"
+//
+#define INTEL_PCM_ENABLE
+
+//codes per column generated in main for the cost model (p_s_model 4).
+#define MODEL_SAMPLE_CODES (64*1024)
+
+
+	
+#ifdef __INTEL_COMPILER
+typedef long si64;
+#else
+typedef long long si64;
+#endif
+
+
+struct Monitor_Event inst_Monitor_Event = {
+	{
+		{0,0},
+		{0,0},
+		{0,0},
+		{0,0},
+	},
+	0,
+	{
+		"core_0",
+		"core_1",
+		"core_2",
+		"core_3",
+	},
+	{
+		{0,0},
+		{0,0},
+		{0,0},
+		{0,0},		
+	},
+	2,
+	{
+		"MIC_0",
+		"MIC_1",
+		"MIC_2",
+		"MIC_3",
+	},
+    0	 
+};
+
+
+typedef struct {
+	pthread_t id;
+
+	int thread;
+	int threads;
+    
+	bool huge_table_enable;
+	uint32_t p_s_model_start;
+	uint32_t p_s_model_end;
+ 	
+    int       seed;
+	uint64_t *times[3];
+	pthread_barrier_t *barrier;
+	
+    uint32_t num_columns;  //number of columns in the conjunction.
+    uint32_t bit_width;    //bit width for all the columns.
+    float    selevitity;   //selectivity of each single predicate.
+    ExecutionModel model;  //model of p_s_model 4, chosen once in main by the cost model.
+	
+    uint64_t T1_len;       //size of the table for the current thread.
+} info_t;
+
+
+//column c of the conjunction on the byte slices data.
+//even columns: greater than literal, odd columns: less than literal.
+static void init_predicate(ColumnPredicate *predicate, ByteUnit **data, uint32_t c,
+                           uint32_t bit_width, float selevitity)
+{
+    int kNumBytesPerCode = (bit_width+7)/8;
+    int kNumPaddingBits  = kNumBytesPerCode * 8 - bit_width;
+    if (c & 1)
+      *predicate = literal_predicate(data, kNumBytesPerCode, kNumPaddingBits, Comparator::kLess,
+                                     (uint32_t) (    selevitity  * (float)((1<<bit_width)-1) ));
+    else
+      *predicate = literal_predicate(data, kNumBytesPerCode, kNumPaddingBits, Comparator::kGreater,
+                                     (uint32_t) ( (1-selevitity) * (float)((1<<bit_width)-1) ));
+}
+
+void *run(void *arg)
+{
+	info_t *d = (info_t*) arg;
+	
+	assert(pthread_equal(pthread_self(), d->id));
+	bind_thread(d->thread, d->threads);	
+
+	rand32_t *gen              = rand32_init(d->seed);
+	pthread_barrier_t *barrier = d->barrier;
+	uint64_t i, T1_len         = d->T1_len;            //number of input codes...
+	bool huge_table_enable     = d->huge_table_enable;
+	uint32_t num_columns       = d->num_columns;
+	uint32_t bit_width         = d->bit_width;
+	uint32_t p_s_model_start   = d->p_s_model_start;
+	uint32_t p_s_model_end     = d->p_s_model_end;
+	float    selevitity        = d->selevitity;
+		
+    int kNumBytesPerCode       = (bit_width+7)/8;
+	int kNumPaddingBits        = kNumBytesPerCode * 8 - bit_width;
+
+  ///////////////////////Generate the input output data..///////////////////////////////////////	
+    uint32_t *original[num_columns];          // input original data.  
+	ByteUnit *data[num_columns][4];           //compressed to byte boundary.
+	ColumnPredicate predicates[num_columns];
+	WordUnit *bitvector;                      //ourput bit map for the original data. 
+    uint64_t T1_len_aligned = ( ((T1_len + 63)>>6)<<6 ); //upper boundary to 64-byte alignment.
+	
+  ///////////////////////allocate space for input data and output bit vector///////////////////////////////////////	
+   for (uint32_t c = 0; c < num_columns; c++)
+   {
+      original[c]            = (uint32_t *) malloc_memory(T1_len_aligned*sizeof(uint32_t), false);//use 4K page.	
+      if (original[c] == NULL) 
+      {
+         printf ( "input original_malloc %d fails\n", c);
+         return NULL;
+      }
+      for (i = 0; i < 4; i++) // malloc memory space for the byte slices. 
+      {
+         data[c][i]          = (ByteUnit *)malloc_memory(T1_len_aligned*sizeof(ByteUnit), huge_table_enable);
+	     if (data[c][i] == NULL) {
+            printf ( "&data_%d[%d]_malloc fails\n", c, i);
+            return NULL;
+         }
+      }
+
+      init_predicate(&predicates[c], data[c], c, bit_width, selevitity);
+   }
+   //consider to use 2M huge table.
+   bitvector              = (WordUnit *) malloc_memory(T1_len_aligned/8, huge_table_enable);
+   if (bitvector == NULL) 
+   {
+         printf ( "output bitvector_malloc fails\n");
+         return NULL;
+   }
+	 
+   //assign random value for all the columns....
+   for(i=0; i < T1_len; i++){
+      for (uint32_t c = 0; c < num_columns; c++)
+      {
+        uint32_t tmp   = rand32_next(gen) & ( (1<<bit_width) - 1 ); 
+        original[c][i] = tmp; //
+        SetTuple(data[c], i, tmp, kNumBytesPerCode, kNumPaddingBits);
+      }
+   }
+
+   for(i=0; i < T1_len_aligned/64; i++){
+      bitvector[i] = 0; //it is used to load to L2 TLB when huge table is used. 
+   }
+
+  for (uint32_t p_s_model = p_s_model_start; p_s_model <= p_s_model_end; p_s_model++)	
+  {	
+  	barrier = d->barrier; //reuse the barrier resource.../////
+  	
+  	if (d->thread == 0)
+  	{
+  	  printf("p_s_model = %d\n", p_s_model);
+  	}
+  	uint32_t model = (p_s_model == 4) ? d->model : p_s_model; //the cost model has already chosen.
+      ///////////////////////first barrier: make sure all threads have finished the initialization.///////////////////////
+      pthread_barrier_wait(barrier++);
+  		
+    #ifdef INTEL_PCM_ENABLE		
+      if (d->thread == 0)
+  	  {   
+          PCM_initPerformanceMonitor(&inst_Monitor_Event, NULL);
+          PCM_start();
+  	  }
+    #endif	
+		
+    ///////////////////////second barrier.to sync all the threads then begin to execute the code./////////////////////		
+	  pthread_barrier_wait(barrier++);
+		uint64_t t1 = thread_time(); //
+	
+      //do the job.....	
+	  if (model == 0)
+        n_columns_cmp_with_literal_nP_nS(bitvector, T1_len, predicates, num_columns);  
+	  else if (model == 1)
+        n_columns_cmp_with_literal_nP_S(bitvector, T1_len, predicates, num_columns);  
+	  else if (model == 2)
+        n_columns_cmp_with_literal_P_nS(bitvector, T1_len, predicates, num_columns);  
+	  else if (model == 3)
+        n_columns_cmp_with_literal_P_S(bitvector, T1_len, predicates, num_columns);  
+
+	///////////////////////third barrier to make sure all the threads have finished the execution/////////////////////		
+	  pthread_barrier_wait(barrier++);
+		 t1 = thread_time() - t1;
+
+#ifdef INTEL_PCM_ENABLE			
+	if (d->thread == 0)
+	{
+        PCM_stop();
+        printf("=====print the profiling result==========\n");
+        PCM_printResults();		
+		PCM_cleanup();
+	}
+#endif		
+     d->times[0][d->thread] = t1;
+	 
+    ///////////////fourth barrier to make sure no too much noise comes from the other threads when the thread collects the statistics/////////////////////		
+	  pthread_barrier_wait(barrier++);
+
+	 //test the bitmap is right or not....
+	 {   
+		 for (size_t ii = 0; ii < T1_len; ii++) //
+		{
+			bool real = true;
+			for (uint32_t c = 0; c < num_columns; c++)
+			{
+			  if (c & 1)
+                real = real && (original[c][ii] < predicates[c].literal);
+			  else
+                real = real && (original[c][ii] > predicates[c].literal);
+			}
+
+		   bool eval  = GetBit(bitvector, ii); 
+            if (real !=  eval )
+			{
+              printf("thread_%d::index_%d:  eval: %d, real: %d \n", d->thread, ii, eval, real);
+			  break;
+			}
+  	    }
+	 }	
+		
+	if (d->thread == 0) {
+		uint64_t t1 = 0.0;
+		for (size_t t = 0 ; t != d->threads ; ++t) {
+			t1 += d->times[0][t];
+		}
+		printf("%2d columns, %2d-bit codes, time: %6.3f, codes_per_ns: %6.3f\n", num_columns, bit_width, ((double)t1 / (double)d->threads), 
+		       (T1_len * d->threads * 1.0) / ((double)t1 / (double)d->threads) );
+	}
+  }
+
+	pthread_exit(NULL);
+}
+
+
+  
+void main(int argc, char **argv)
+{
+  uint64_t t, thread_num   = argc > 1 ? atoi(argv[1]) : hardware_threads(); //deflaut to use all threads.
+  bool huge_table_enable   = argc > 2 ? atoi(argv[2]) : false;              //deflaut to use normal 4k page.
+  uint32_t  num_columns    = argc > 3 ? atoi(argv[3]) : 4;                  //default number of columns
+  uint32_t  bit_width      = argc > 4 ? atoi(argv[4]) : 17;                 //default bit width for all the columns
+  uint32_t  prefetch_model = argc > 5 ? atoi(argv[5]) : 0;                  //default: enable prefetcher
+  uint32_t  p_s_model_start= argc > 6 ? atoi(argv[6]) : 0;                  //0:nP_nS, 1:nP_S, 2:P_ns, 3:P_S, 4:cost model
+  uint32_t  p_s_model_end  = argc > 7 ? atoi(argv[7]) : 0;                  
+  float     selevitity     = argc > 8 ? atof(argv[8]) : 0.5; 
+  uint64_t  tuples         = argc > 9 ? atol(argv[9]) : 1000000000; 
+
+  //modify the L2 cache's prefetching model only when the input model is not default value (0). 
+  if (prefetch_model != 0)  
+    inst_Monitor_Event.prefetch_model = prefetch_model;
+    
+  printf("tuples = %d, thread number = %d, huge_table_enable = %d, num_columns = %d, bit_width = %d, prefetch_model = %d\n", 
+         tuples,       thread_num,         huge_table_enable,      num_columns,      bit_width,      prefetch_model     ); 
+ 
+  	srand(time(NULL));
+
+  std::vector<uint64_t> task_len;
+  task_len.resize(thread_num);
+  uint64_t size_for_each_thread = compute_task_len_for_each_thread(task_len, tuples, thread_num);
+
+  //the cost model (p_s_model 4) runs once, here, on a sample generated like the columns of
+  //the threads, so that all the threads run the same model and only the scan is timed.
+  ExecutionModel model = MODEL_nP_nS;
+  if (p_s_model_end >= 4)
+  {
+    ByteUnit *sample[num_columns][4];
+    ColumnPredicate sample_predicates[num_columns];
+    rand32_t *gen = rand32_init(rand());
+    for (uint32_t c = 0; c < num_columns; c++)
+    {
+      for (int s = 0; s < 4; s++)
+        sample[c][s] = (ByteUnit *) malloc_memory(MODEL_SAMPLE_CODES*sizeof(ByteUnit), false);
+      init_predicate(&sample_predicates[c], sample[c], c, bit_width, selevitity);
+      for (uint64_t i = 0; i < MODEL_SAMPLE_CODES; i++)
+        SetTuple(sample[c], i, rand32_next(gen) & ( (1<<bit_width) - 1 ),
+                 sample_predicates[c].kNumBytesPerCode, sample_predicates[c].kNumPaddingBits);
+    }
+    model = pick_execution_model(4, sample_predicates, num_columns, MODEL_SAMPLE_CODES,
+                                 size_for_each_thread, thread_num);
+    for (uint32_t c = 0; c < num_columns; c++)
+      for (int s = 0; s < 4; s++)
+        free_memory(sample[c][s], false);
+    free(gen);
+  }
+
+    //initialize 20 barriers to sync between threads.
+	int b, barrier_num = 20;
+	pthread_barrier_t barrier[barrier_num];
+	for (b = 0 ; b != barrier_num; ++b)
+		pthread_barrier_init(&barrier[b], NULL, thread_num);
+
+    info_t info[thread_num]; //
+	uint64_t times[3][thread_num];
+	
+	//for affinity setting.
+    pthread_attr_t attr;
+    cpu_set_t set; 
+    pthread_attr_init(&attr);
+	 
+	for (t = 0 ; t != thread_num ; ++t) 
+	{
+	    //for affinity setting.		
+        int cpu_idx = get_cpu_id(t);
+        CPU_ZERO(&set);
+        CPU_SET(cpu_idx, &set);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &set);
+
+        info[t].seed              = rand();
+		info[t].huge_table_enable = huge_table_enable;
+		info[t].num_columns       = num_columns;
+		info[t].bit_width         = bit_width;
+		info[t].selevitity        = selevitity;
+		info[t].model             = model;
+
+		info[t].p_s_model_start   = p_s_model_start;
+		info[t].p_s_model_end     = p_s_model_end;
+ 	
+		info[t].thread            = t;
+		info[t].threads           = thread_num;
+		info[t].barrier           = barrier;
+
+		info[t].times[0] = times[0];
+		info[t].times[1] = times[1];
+		info[t].times[2] = times[2];
+		
+		info[t].T1_len          = task_len[t]; //same for all the threads (64*), except the last one 
+		pthread_create(&info[t].id, &attr, run, (void*) &info[t]); 
+	}
+	
+   //finish the execution of all threads......	
+	for (t = 0 ; t != thread_num ; ++t)
+		pthread_join(info[t].id, NULL);
+	
+	for (b = 0 ; b != barrier_num; ++b)
+		pthread_barrier_destroy(&barrier[b]);
+	
+   return;//EXIT_SUCCESS  
+
+}
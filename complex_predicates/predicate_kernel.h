@@ -0,0 +1,570 @@
+/*******************************************************************************
+ * Copyright (c) 2017
+ * The National University of Singapore, Xtra Group
+ *
+ * Author: Zeke Wang (wangzeke638 AT gmail.com)
+ *
+ * Description: per-predicate kernels shared by the run-time configurable scans
+ * (n_column_compare_with_literal.cpp, dnf_compare_with_literal.cpp). Each
+ * comparator is bound to its batch kernels through the dispatch tables: they
+ * loop over BATCH_SEGMENTS segments with the kernel of the comparator inlined,
+ * so a scan pays one indirect call per batch, not per segment.
+ *
+ * See file LICENSE.md for details.
+ *******************************************************************************/
+#ifndef PREDICATE_KERNEL_H
+#define PREDICATE_KERNEL_H
+
+#include	<cassert>
+#include    <cstdio>
+#include    <cstdlib>
+#include    <algorithm>
+
+#include "types_simd.h"
+#include "avx-utility.h"
+#include "n_column_compare_with_literal.h"
+
+//segments (of 32 codes) per call of a batch kernel: 8 words of the bit vector.
+#define BATCH_SEGMENTS (16)
+
+//masks of one predicate for the current segment (32 codes).
+struct PredicateMasks{
+    AvxUnit less;
+    AvxUnit greater;
+    AvxUnit equal;
+    AvxUnit success;
+    AvxUnit fail;
+};
+
+//one byte slice of a column, re-aligned to the common code of a column-column term:
+//byte = (hi << shift) | (lo >> (8 - shift)) of the unflipped slices, NULL slices are zero.
+struct AlignedSlice{
+    ByteUnit* hi;
+    ByteUnit* lo;
+    int       shift;
+};
+
+struct PredicateContext;
+
+typedef void    (*ByteSliceKernel)(const PredicateContext &ctx, size_t pos, PredicateMasks &m);
+typedef void    (*NextByteKernel)(const PredicateContext &ctx, size_t byte_id, size_t pos, PredicateMasks &m);
+typedef AvxUnit (*ResultKernel)(const PredicateMasks &m);
+
+//the same stages over the num_segments segments from code pos on, one PredicateMasks each.
+//A refine batch with agg_equal keeps only the codes still undecided in the whole
+//conjunction and skips the segments without any (pruning). A next byte batch compares
+//byte slice byte_id of the codes in refine, and skips the segments without any.
+//A result batch stores the results of the predicate, or ands them in if combine is set.
+typedef void    (*FirstBatchKernel)(const PredicateContext &ctx, size_t pos, size_t num_segments,
+                                    PredicateMasks* m);
+typedef void    (*RefineBatchKernel)(const PredicateContext &ctx, size_t pos, size_t num_segments,
+                                     PredicateMasks* m, const AvxUnit* agg_equal);
+typedef void    (*NextByteBatchKernel)(const PredicateContext &ctx, size_t byte_id, size_t pos,
+                                       size_t num_segments, PredicateMasks* m, const AvxUnit* refine);
+typedef void    (*ResultBatchKernel)(const PredicateMasks* m, size_t num_segments, AvxUnit* result,
+                                     bool combine);
+
+//prepared form of one ColumnPredicate: byte slices of the literal and the bound kernels.
+struct PredicateContext{
+    AvxUnit         mask_literal[MAX_BYTES_PER_CODE];
+    ByteUnit**      data;
+    size_t          kNumBytesPerCode;
+    AvxUnit         in_literal[MAX_BYTES_PER_CODE][MAX_IN_LIST_SIZE];
+    size_t          num_in_literals;
+    AvxUnit*        in_equal;               //IN-list: codes still equal to each literal (bind_in_equal).
+    AvxUnit         in_row_lo;              //long IN-list: bitmap of the first bytes.
+    AvxUnit         in_row_hi;
+    uint32_t*       in_codes;               //long IN-list on wider codes: sorted literals << padding.
+    size_t          num_in_codes;
+    AlignedSlice    lhs[MAX_BYTES_PER_CODE];    //column-column: both columns in the common code.
+    AlignedSlice    rhs[MAX_BYTES_PER_CODE];
+    FirstBatchKernel    first_batch;
+    RefineBatchKernel   refine_batch;
+    NextByteBatchKernel next_byte_batch;
+    ResultBatchKernel   result_batch;
+};
+
+//approximate stage: compare the first byte slice.
+template <Comparator CMP>
+static inline void first_byte_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    computeKernelWithMask_FIRST<CMP>(avx_load( (void *)(ctx.data[0]+pos) ),
+                                     ctx.mask_literal[0],
+                                     m.less,
+                                     m.greater,
+                                     m.equal,
+                                     m.success,
+                                     m.fail);
+}
+
+//refine stage: fetch the remaining byte slices while some code is still equal.
+template <Comparator CMP>
+static inline void refine_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    for(size_t byte_id = 1; (byte_id < ctx.kNumBytesPerCode) && !avx_iszero(m.equal); byte_id++)
+    {
+        computeKernelWithMask<CMP>(avx_load( (void *)(ctx.data[byte_id]+pos) ),
+                                   ctx.mask_literal[byte_id],
+                                   m.less,
+                                   m.greater,
+                                   m.equal,
+                                   m.success,
+                                   m.fail);
+    }
+}
+
+//refine stage, one byte slice at a time.
+template <Comparator CMP>
+static inline void next_byte_kernel(const PredicateContext &ctx, size_t byte_id, size_t pos, PredicateMasks &m)
+{
+    computeKernelWithMask<CMP>(avx_load( (void *)(ctx.data[byte_id]+pos) ),
+                               ctx.mask_literal[byte_id],
+                               m.less,
+                               m.greater,
+                               m.equal,
+                               m.success,
+                               m.fail);
+}
+
+template <Comparator CMP>
+static inline AvxUnit result_kernel(const PredicateMasks &m)
+{
+    AvxUnit m_result;
+    computeMask_one_predicate<CMP>(m.equal, m.greater, m.less, m_result);
+    return m_result;
+}
+
+static inline AvxUnit load_aligned_slice(const AlignedSlice &slice, size_t pos)
+{
+    if(slice.shift == 0){
+        if(slice.hi == NULL)
+            return avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(0)));
+        return avx_load( (void *)(slice.hi+pos) );
+    }
+    const AvxUnit mask_flip = avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(0)));
+    const __m128i count_hi  = _mm_cvtsi32_si128(slice.shift);
+    const __m128i count_lo  = _mm_cvtsi32_si128(8 - slice.shift);
+    AvxUnit byteslice = avx_zero();
+    if(slice.hi != NULL){
+        AvxUnit hi = avx_xor(avx_load( (void *)(slice.hi+pos) ), mask_flip);
+        byteslice  = avx_and(_mm256_sll_epi16(hi, count_hi), avx_set1<ByteUnit>(static_cast<ByteUnit>(0xff << slice.shift)));
+    }
+    if(slice.lo != NULL){
+        AvxUnit lo = avx_xor(avx_load( (void *)(slice.lo+pos) ), mask_flip);
+        byteslice  = avx_or(byteslice, avx_and(_mm256_srl_epi16(lo, count_lo), avx_set1<ByteUnit>(static_cast<ByteUnit>(0xff >> (8 - slice.shift)))));
+    }
+    return avx_xor(byteslice, mask_flip);
+}
+
+//column-column kernels: the literal is replaced by the byte slice of the other column.
+template <Comparator CMP>
+static inline void column_first_byte_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    computeKernelWithMask_FIRST<CMP>(load_aligned_slice(ctx.lhs[0], pos),
+                                     load_aligned_slice(ctx.rhs[0], pos),
+                                     m.less,
+                                     m.greater,
+                                     m.equal,
+                                     m.success,
+                                     m.fail);
+}
+
+template <Comparator CMP>
+static inline void column_refine_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    for(size_t byte_id = 1; (byte_id < ctx.kNumBytesPerCode) && !avx_iszero(m.equal); byte_id++)
+    {
+        computeKernelWithMask<CMP>(load_aligned_slice(ctx.lhs[byte_id], pos),
+                                   load_aligned_slice(ctx.rhs[byte_id], pos),
+                                   m.less,
+                                   m.greater,
+                                   m.equal,
+                                   m.success,
+                                   m.fail);
+    }
+}
+
+template <Comparator CMP>
+static inline void column_next_byte_kernel(const PredicateContext &ctx, size_t byte_id, size_t pos, PredicateMasks &m)
+{
+    computeKernelWithMask<CMP>(load_aligned_slice(ctx.lhs[byte_id], pos),
+                               load_aligned_slice(ctx.rhs[byte_id], pos),
+                               m.less,
+                               m.greater,
+                               m.equal,
+                               m.success,
+                               m.fail);
+}
+
+//IN-list kernels: each byte slice is loaded once for all the literals.
+//The masks per literal of the segment at pos: any BATCH_SEGMENTS consecutive segments
+//have sets of their own.
+static inline AvxUnit* in_equal_masks(const PredicateContext &ctx, size_t pos)
+{
+    return ctx.in_equal + ((pos/(NUM_AVX_BITS/8)) % BATCH_SEGMENTS)*ctx.num_in_literals;
+}
+
+static inline void in_first_byte_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    computeInKernelWithMask_FIRST(avx_load( (void *)(ctx.data[0]+pos) ),
+                                  ctx.in_literal[0],
+                                  ctx.num_in_literals,
+                                  in_equal_masks(ctx, pos),
+                                  m.equal,
+                                  m.success,
+                                  m.fail);
+}
+
+//long IN-list: one bitmap lookup on the first byte, which decides 1-byte codes.
+static inline void in_bitmap_first_byte_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    AvxUnit byteslice = avx_xor(avx_load( (void *)(ctx.data[0]+pos) ), avx_set1<ByteUnit>(FLIP(static_cast<ByteUnit>(0))));
+    m.equal   = avx_lookup_bitmap(byteslice, ctx.in_row_lo, ctx.in_row_hi);
+    m.fail    = avx_not(m.equal);
+    m.success = avx_zero();
+}
+
+static inline void in_refine_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    for(size_t byte_id = 1; (byte_id < ctx.kNumBytesPerCode) && !avx_iszero(m.equal); byte_id++)
+    {
+        computeInKernelWithMask(avx_load( (void *)(ctx.data[byte_id]+pos) ),
+                                ctx.in_literal[byte_id],
+                                ctx.num_in_literals,
+                                in_equal_masks(ctx, pos),
+                                m.equal,
+                                m.success,
+                                m.fail);
+    }
+}
+
+static inline void in_next_byte_kernel(const PredicateContext &ctx, size_t byte_id, size_t pos, PredicateMasks &m)
+{
+    computeInKernelWithMask(avx_load( (void *)(ctx.data[byte_id]+pos) ),
+                            ctx.in_literal[byte_id],
+                            ctx.num_in_literals,
+                            in_equal_masks(ctx, pos),
+                            m.equal,
+                            m.success,
+                            m.fail);
+}
+
+//long IN-list over wider codes: the candidates left by the bitmap are checked against the
+//sorted list, which decides the predicate.
+static inline void in_check_kernel(const PredicateContext &ctx, size_t pos, PredicateMasks &m)
+{
+    uint32_t candidates = _mm256_movemask_epi8(m.equal);
+    uint32_t mmask      = 0;
+    while(candidates != 0){
+        size_t   lane = __builtin_ctz(candidates);
+        uint32_t code = 0;
+        for(size_t byte_id = 0; byte_id < ctx.kNumBytesPerCode; byte_id++)
+            code = (code << 8) | FLIP(ctx.data[byte_id][pos + lane]);
+        if(std::binary_search(ctx.in_codes, ctx.in_codes + ctx.num_in_codes, code))
+            mmask |= (1U << lane);
+        candidates &= candidates - 1;
+    }
+    m.equal   = avx_mask_from_bits(mmask);
+    m.fail    = avx_not(m.equal);
+    m.success = avx_zero();
+}
+
+static inline void in_check_next_byte_kernel(const PredicateContext &ctx, size_t byte_id, size_t pos, PredicateMasks &m)
+{
+    if(byte_id == 1)
+        in_check_kernel(ctx, pos, m);
+}
+
+static inline AvxUnit in_result_kernel(const PredicateMasks &m)
+{
+    return m.equal;
+}
+
+//batch kernels: the loops over the segments of a batch, with KERNEL inlined.
+template <ByteSliceKernel KERNEL>
+static void first_batch_kernel(const PredicateContext &ctx, size_t pos, size_t num_segments,
+                               PredicateMasks* m)
+{
+    for(size_t s = 0; s < num_segments; s++)
+        KERNEL(ctx, pos + s*(NUM_AVX_BITS/8), m[s]);
+}
+
+template <ByteSliceKernel KERNEL>
+static void refine_batch_kernel(const PredicateContext &ctx, size_t pos, size_t num_segments,
+                                PredicateMasks* m, const AvxUnit* agg_equal)
+{
+    for(size_t s = 0; s < num_segments; s++){
+        if(agg_equal != NULL){
+            if(avx_iszero(agg_equal[s]))
+                continue;
+            m[s].equal = avx_and(m[s].equal, agg_equal[s]);
+        }
+        KERNEL(ctx, pos + s*(NUM_AVX_BITS/8), m[s]);
+    }
+}
+
+template <NextByteKernel KERNEL>
+static void next_byte_batch_kernel(const PredicateContext &ctx, size_t byte_id, size_t pos,
+                                   size_t num_segments, PredicateMasks* m, const AvxUnit* refine)
+{
+    for(size_t s = 0; s < num_segments; s++){
+        if(avx_iszero(refine[s]))
+            continue;
+        m[s].equal = avx_and(m[s].equal, refine[s]);
+        KERNEL(ctx, byte_id, pos + s*(NUM_AVX_BITS/8), m[s]);
+    }
+}
+
+template <ResultKernel KERNEL>
+static void result_batch_kernel(const PredicateMasks* m, size_t num_segments, AvxUnit* result,
+                                bool combine)
+{
+    for(size_t s = 0; s < num_segments; s++){
+        if(combine)
+            computeConjunctivePredicates<Bitwise::kAnd>(result[s], KERNEL(m[s]), result[s]);
+        else
+            result[s] = KERNEL(m[s]);
+    }
+}
+
+//dispatch tables: same order as enum class Comparator.
+static const FirstBatchKernel kFirstBatchKernels[] = {
+    first_batch_kernel<first_byte_kernel<Comparator::kEqual> >,
+    first_batch_kernel<first_byte_kernel<Comparator::kInequal> >,
+    first_batch_kernel<first_byte_kernel<Comparator::kLess> >,
+    first_batch_kernel<first_byte_kernel<Comparator::kGreater> >,
+    first_batch_kernel<first_byte_kernel<Comparator::kLessEqual> >,
+    first_batch_kernel<first_byte_kernel<Comparator::kGreaterEqual> >
+};
+
+static const RefineBatchKernel kRefineBatchKernels[] = {
+    refine_batch_kernel<refine_kernel<Comparator::kEqual> >,
+    refine_batch_kernel<refine_kernel<Comparator::kInequal> >,
+    refine_batch_kernel<refine_kernel<Comparator::kLess> >,
+    refine_batch_kernel<refine_kernel<Comparator::kGreater> >,
+    refine_batch_kernel<refine_kernel<Comparator::kLessEqual> >,
+    refine_batch_kernel<refine_kernel<Comparator::kGreaterEqual> >
+};
+
+static const NextByteBatchKernel kNextByteBatchKernels[] = {
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kEqual> >,
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kInequal> >,
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kLess> >,
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kGreater> >,
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kLessEqual> >,
+    next_byte_batch_kernel<next_byte_kernel<Comparator::kGreaterEqual> >
+};
+
+static const FirstBatchKernel kColumnFirstBatchKernels[] = {
+    first_batch_kernel<column_first_byte_kernel<Comparator::kEqual> >,
+    first_batch_kernel<column_first_byte_kernel<Comparator::kInequal> >,
+    first_batch_kernel<column_first_byte_kernel<Comparator::kLess> >,
+    first_batch_kernel<column_first_byte_kernel<Comparator::kGreater> >,
+    first_batch_kernel<column_first_byte_kernel<Comparator::kLessEqual> >,
+    first_batch_kernel<column_first_byte_kernel<Comparator::kGreaterEqual> >
+};
+
+static const RefineBatchKernel kColumnRefineBatchKernels[] = {
+    refine_batch_kernel<column_refine_kernel<Comparator::kEqual> >,
+    refine_batch_kernel<column_refine_kernel<Comparator::kInequal> >,
+    refine_batch_kernel<column_refine_kernel<Comparator::kLess> >,
+    refine_batch_kernel<column_refine_kernel<Comparator::kGreater> >,
+    refine_batch_kernel<column_refine_kernel<Comparator::kLessEqual> >,
+    refine_batch_kernel<column_refine_kernel<Comparator::kGreaterEqual> >
+};
+
+static const NextByteBatchKernel kColumnNextByteBatchKernels[] = {
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kEqual> >,
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kInequal> >,
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kLess> >,
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kGreater> >,
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kLessEqual> >,
+    next_byte_batch_kernel<column_next_byte_kernel<Comparator::kGreaterEqual> >
+};
+
+static const ResultBatchKernel kResultBatchKernels[] = {
+    result_batch_kernel<result_kernel<Comparator::kEqual> >,
+    result_batch_kernel<result_kernel<Comparator::kInequal> >,
+    result_batch_kernel<result_kernel<Comparator::kLess> >,
+    result_batch_kernel<result_kernel<Comparator::kGreater> >,
+    result_batch_kernel<result_kernel<Comparator::kLessEqual> >,
+    result_batch_kernel<result_kernel<Comparator::kGreaterEqual> >
+};
+
+//IN-list literals as codes << kNumPaddingBits: sorted, without duplicates and without the
+//literals out of the domain of the column, which never match but would alias real codes
+//once narrowed to the byte slices. codes has room for in_list_len literals.
+static inline size_t prepare_in_codes(const ColumnPredicate &predicate, uint32_t* codes)
+{
+    size_t   bit_width = predicate.kNumBytesPerCode*8 - predicate.kNumPaddingBits;
+    uint64_t max_code  = (1ULL << bit_width) - 1;
+    size_t   num_codes = 0;
+    for(size_t l = 0; l < predicate.in_list_len; l++){
+        if(predicate.in_list[l] <= max_code)
+            codes[num_codes++] = predicate.in_list[l] << predicate.kNumPaddingBits;
+    }
+    std::sort(codes, codes + num_codes);
+    return std::unique(codes, codes + num_codes) - codes;
+}
+
+static inline void prepare_in_predicate(const ColumnPredicate &predicate, PredicateContext &ctx)
+{
+    uint32_t* codes     = (uint32_t*) malloc(predicate.in_list_len*sizeof(uint32_t));
+    size_t    num_codes = prepare_in_codes(predicate, codes);
+    if(num_codes <= MAX_IN_LIST_SIZE){
+        ctx.num_in_literals = num_codes;
+        for(size_t l = 0; l < ctx.num_in_literals; l++){
+            for(size_t byte_id=0; byte_id < ctx.kNumBytesPerCode; byte_id++){
+                ByteUnit byte              = FLIP(static_cast<ByteUnit>(codes[l] >> 8*(ctx.kNumBytesPerCode - 1 - byte_id)));
+                ctx.in_literal[byte_id][l] = avx_set1<ByteUnit>(byte);
+            }
+        }
+        free(codes);
+        ctx.first_batch     = first_batch_kernel<in_first_byte_kernel>;
+        ctx.refine_batch    = refine_batch_kernel<in_refine_kernel>;
+        ctx.next_byte_batch = next_byte_batch_kernel<in_next_byte_kernel>;
+    }
+    else{
+        ByteUnit row_lo[32] = {0}, row_hi[32] = {0};
+        for(size_t l = 0; l < num_codes; l++){
+            ByteUnit byte = static_cast<ByteUnit>(codes[l] >> 8*(ctx.kNumBytesPerCode - 1));
+            ByteUnit* row = ((byte >> 4) < 8) ? row_lo : row_hi;
+            row[byte & 0x0f]      |= static_cast<ByteUnit>(1 << ((byte >> 4) & 7));
+            row[(byte & 0x0f)+16] |= static_cast<ByteUnit>(1 << ((byte >> 4) & 7));
+        }
+        ctx.num_in_literals = 0;
+        ctx.in_row_lo       = avx_load( (void *)row_lo );
+        ctx.in_row_hi       = avx_load( (void *)row_hi );
+        ctx.first_batch     = first_batch_kernel<in_bitmap_first_byte_kernel>;
+        if(ctx.kNumBytesPerCode == 1){
+            free(codes);
+            ctx.refine_batch    = refine_batch_kernel<in_refine_kernel>;
+            ctx.next_byte_batch = next_byte_batch_kernel<in_next_byte_kernel>;
+        }
+        else{
+            ctx.in_codes        = codes;
+            ctx.num_in_codes    = num_codes;
+            ctx.refine_batch    = refine_batch_kernel<in_check_kernel>;
+            ctx.next_byte_batch = next_byte_batch_kernel<in_check_next_byte_kernel>;
+        }
+    }
+    ctx.result_batch = result_batch_kernel<in_result_kernel>;
+}
+
+//byte slices of a column (num_bytes, num_padding_bits) seen as a code of common_bytes
+//bytes with common_padding_bits right padding: code << common_padding_bits == stored << shift.
+static inline void prepare_aligned_slices(ByteUnit** data, size_t num_bytes, size_t num_padding_bits,
+                                          size_t common_bytes, size_t common_padding_bits,
+                                          AlignedSlice* slices)
+{
+    int shift    = (int)common_padding_bits - (int)num_padding_bits;
+    int shift_q  = (shift >= 0) ? shift/8 : -((-shift + 7)/8);
+    int shift_r  = shift - 8*shift_q;
+    for(int byte_id = 0; byte_id < (int)common_bytes; byte_id++){
+        int hi_id = (int)num_bytes - (int)common_bytes + byte_id + shift_q;
+        int lo_id = hi_id + 1;
+        slices[byte_id].hi    = (hi_id >= 0 && hi_id < (int)num_bytes) ? data[hi_id] : NULL;
+        slices[byte_id].lo    = (shift_r != 0 && lo_id >= 0 && lo_id < (int)num_bytes) ? data[lo_id] : NULL;
+        slices[byte_id].shift = shift_r;
+    }
+}
+
+static inline void prepare_column_predicate(const ColumnPredicate &predicate, PredicateContext &ctx)
+{
+    size_t bit_width       = predicate.kNumBytesPerCode*8 - predicate.kNumPaddingBits;
+    size_t other_bit_width = predicate.other_kNumBytesPerCode*8 - predicate.other_kNumPaddingBits;
+    size_t common_width    = (bit_width > other_bit_width) ? bit_width : other_bit_width;
+    size_t common_bytes    = (common_width + 7)/8;
+    size_t common_padding  = common_bytes*8 - common_width;
+    assert(common_bytes <= MAX_BYTES_PER_CODE);
+
+    ctx.kNumBytesPerCode = common_bytes;
+    prepare_aligned_slices(predicate.data, predicate.kNumBytesPerCode, predicate.kNumPaddingBits,
+                           common_bytes, common_padding, ctx.lhs);
+    prepare_aligned_slices(predicate.other_data, predicate.other_kNumBytesPerCode, predicate.other_kNumPaddingBits,
+                           common_bytes, common_padding, ctx.rhs);
+
+    size_t cmp = static_cast<size_t>(predicate.comparator);
+    ctx.first_batch     = kColumnFirstBatchKernels[cmp];
+    ctx.refine_batch    = kColumnRefineBatchKernels[cmp];
+    ctx.next_byte_batch = kColumnNextByteBatchKernels[cmp];
+    ctx.result_batch    = kResultBatchKernels[cmp];
+}
+
+static inline void prepare_predicate(const ColumnPredicate &predicate, PredicateContext &ctx)
+{
+    assert(predicate.kNumBytesPerCode >= 1 && predicate.kNumBytesPerCode <= MAX_BYTES_PER_CODE);
+
+    uint32_t literal     = predicate.literal << predicate.kNumPaddingBits;
+    ctx.data             = predicate.data;
+    ctx.kNumBytesPerCode = predicate.kNumBytesPerCode;
+    ctx.num_in_literals  = 0;
+    ctx.in_equal         = NULL;
+    ctx.in_codes         = NULL;
+    ctx.num_in_codes     = 0;
+    for(size_t byte_id=0; byte_id < ctx.kNumBytesPerCode; byte_id++){
+         ByteUnit byte            = FLIP(static_cast<ByteUnit>(literal >> 8*(ctx.kNumBytesPerCode - 1 - byte_id)));
+         ctx.mask_literal[byte_id] = avx_set1<ByteUnit>(byte);
+    }
+
+    if(predicate.in_list_len > 0){
+        prepare_in_predicate(predicate, ctx);
+        return;
+    }
+    if(predicate.other_data != NULL){
+        prepare_column_predicate(predicate, ctx);
+        return;
+    }
+
+    size_t cmp = static_cast<size_t>(predicate.comparator);
+    ctx.first_batch     = kFirstBatchKernels[cmp];
+    ctx.refine_batch    = kRefineBatchKernels[cmp];
+    ctx.next_byte_batch = kNextByteBatchKernels[cmp];
+    ctx.result_batch    = kResultBatchKernels[cmp];
+}
+
+//masks the IN terms among ctx need for in_equal: a set of their literals per segment of a batch.
+static inline size_t in_equal_size(const PredicateContext* ctx, size_t num_predicates)
+{
+    size_t size = 0;
+    for(size_t p = 0; p < num_predicates; p++)
+        size += BATCH_SEGMENTS*ctx[p].num_in_literals;
+    return size;
+}
+
+//hands every IN term among ctx its part of in_equal (in_equal_size masks); the masks of
+//the other terms are only their PredicateMasks.
+static inline void bind_in_equal(PredicateContext* ctx, size_t num_predicates, AvxUnit* in_equal)
+{
+    for(size_t p = 0; p < num_predicates; p++){
+        ctx[p].in_equal = in_equal;
+        in_equal       += BATCH_SEGMENTS*ctx[p].num_in_literals;
+    }
+}
+
+//frees what prepare_predicate allocated.
+static inline void release_predicate(PredicateContext &ctx)
+{
+    free(ctx.in_codes);
+    ctx.in_codes = NULL;
+}
+
+//equal/success/fail of one predicate after num_bytes_done byte slices, as input of
+//computeForEarlyStop. Once all the byte slices are compared, the predicate is decided
+//and result holds what its result batch gave.
+static inline void predicate_state(const PredicateContext &ctx, const PredicateMasks &m, const AvxUnit &result,
+                                   size_t num_bytes_done, AvxUnit &equal, AvxUnit &success, AvxUnit &fail)
+{
+    if(num_bytes_done < ctx.kNumBytesPerCode){
+        equal   = m.equal;
+        success = m.success;
+        fail    = m.fail;
+    }
+    else{
+        success = result;
+        fail    = avx_not(success);
+        equal   = avx_zero();
+    }
+}
+
+#endif
@@ -31,6 +31,8 @@
 #include <string>
 #include <vector>
 
+#include "cpu_mapping.h"
+
 	
 #ifdef __INTEL_COMPILER
 typedef long si64;
@@ -49,14 +51,16 @@ uint64_t thread_time(void)
 	return t.tv_sec * 1000 * 1000 * 1000 + t.tv_nsec;
 }
 
+//pin the thread to the CPU chosen for it by get_cpu_id (cpu_mapping.h)
 void bind_thread(int thread, int threads)
 {
 	assert(thread >= 0 && thread < threads);
-	size_t size = CPU_ALLOC_SIZE(threads);
-	cpu_set_t *cpu_set = CPU_ALLOC(threads);
+	int cpu = get_cpu_id(thread);
+	size_t size = CPU_ALLOC_SIZE(cpu + 1);
+	cpu_set_t *cpu_set = CPU_ALLOC(cpu + 1);
 	assert(cpu_set != NULL);
 	CPU_ZERO_S(size, cpu_set);
-	CPU_SET_S(thread, size, cpu_set);
+	CPU_SET_S(cpu, size, cpu_set);
 	assert(pthread_setaffinity_np(pthread_self(), size, cpu_set) == 0);
 	CPU_FREE(cpu_set);
 }
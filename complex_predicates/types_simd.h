@@ -20,11 +20,18 @@
 
 #define MAX_BYTES_PER_CODE 4
 
+//IN-lists up to this size compare every literal with SIMD; longer lists use a bitmap lookup.
+#define MAX_IN_LIST_SIZE 8
+
 //#define STREAM_LOAD_ENABLE 
 
 #define PREFETCHING_DISTANCE (1024)
 #define HINT_LEVEL 0
 
+//cost model of the execution models (nP_nS, nP_S, P_nS, P_S).
+#define COST_SAMPLE_SEGMENTS   (256)   //32-code segments sampled to estimate the fetched byte slices.
+#define COST_CALIBRATION_CODES (8192)  //cache-resident codes timed to get the compute cost.
+
 
 
 typedef uint64_t WordUnit;